@@ -94,6 +94,16 @@ c3d::BindlessTextureManager& c3d::AssetManager::getBindlessTextureManager()
 	return _bindlessTextureManager;
 }
 
+c3d::MeshPool& c3d::AssetManager::getMeshPool()
+{
+	return _meshPool;
+}
+
+c3d::MaterialRegistry& c3d::AssetManager::getMaterialRegistry()
+{
+	return _materialRegistry;
+}
+
 c3d::TextureAsset* c3d::AssetManager::loadTexture(std::string_view path, ImageType type)
 {
 	TextureAssetSignature signature;
@@ -188,4 +198,6 @@ c3d::SkyboxAsset* c3d::AssetManager::loadSkybox(std::string_view path)
 void c3d::AssetManager::onNewFrame()
 {
 	_bindlessTextureManager.onNewFrame();
+	_meshPool.onNewFrame();
+	_materialRegistry.onNewFrame();
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include <Cyph3D/Asset/AssetManagerWorkerData.h>
 #include <Cyph3D/Asset/BindlessTextureManager.h>
+#include <Cyph3D/Asset/MaterialRegistry.h>
+#include <Cyph3D/Asset/MeshPool.h>
 #include <Cyph3D/Asset/Processing/AssetProcessor.h>
 #include <Cyph3D/Asset/Processing/ImageData.h>
 #include <Cyph3D/Asset/RuntimeAsset/CubemapAsset.h>
@@ -29,6 +31,10 @@ public:
 
 	BindlessTextureManager& getBindlessTextureManager();
 
+	MeshPool& getMeshPool();
+
+	MaterialRegistry& getMaterialRegistry();
+
 	TextureAsset* loadTexture(std::string_view path, ImageType type);
 	CubemapAsset* loadCubemap(std::string_view xposPath, std::string_view xnegPath, std::string_view yposPath, std::string_view ynegPath, std::string_view zposPath, std::string_view znegPath, ImageType type);
 	CubemapAsset* loadCubemap(std::string_view equirectangularPath);
@@ -52,6 +58,10 @@ private:
 
 	BindlessTextureManager _bindlessTextureManager;
 
+	MeshPool _meshPool;
+
+	MaterialRegistry _materialRegistry;
+
 	std::unordered_map<TextureAssetSignature, std::unique_ptr<TextureAsset>> _textures;
 	std::unordered_map<CubemapAssetSignature, std::unique_ptr<CubemapAsset>> _cubemaps;
 	std::unordered_map<MeshAssetSignature, std::unique_ptr<MeshAsset>> _meshes;
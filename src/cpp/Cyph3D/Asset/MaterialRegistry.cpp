@@ -0,0 +1,112 @@
+#include "MaterialRegistry.h"
+
+#include <Cyph3D/Engine.h>
+#include <Cyph3D/VKObject/Buffer/VKBuffer.h>
+#include <Cyph3D/VKObject/VKContext.h>
+
+#include <algorithm>
+#include <format>
+
+c3d::MaterialRegistry::MaterialRegistry()
+{
+	_buffers.resize(Engine::getVKContext().getConcurrentFrameCount());
+	_pendingChanges.resize(Engine::getVKContext().getConcurrentFrameCount());
+	expand();
+}
+
+uint32_t c3d::MaterialRegistry::acquireIndex()
+{
+	std::scoped_lock lock(_mutex);
+
+	if (_availableIndices.empty())
+	{
+		expand();
+	}
+
+	uint32_t index = _availableIndices.top();
+	_availableIndices.pop();
+
+	return index;
+}
+
+void c3d::MaterialRegistry::releaseIndex(uint32_t index)
+{
+	std::scoped_lock lock(_mutex);
+
+	_availableIndices.push(index);
+}
+
+void c3d::MaterialRegistry::setMaterial(uint32_t index, const MaterialData& data)
+{
+	std::scoped_lock lock(_mutex);
+
+	_materials[index] = data;
+
+	_buffers[_currentFrame]->getHostPointer()[index] = data;
+
+	for (int i = 0; i < Engine::getVKContext().getConcurrentFrameCount(); i++)
+	{
+		if (i == _currentFrame)
+		{
+			continue;
+		}
+
+		_pendingChanges[i].push_back(index);
+	}
+}
+
+const std::shared_ptr<c3d::VKBuffer<c3d::MaterialRegistry::MaterialData>>& c3d::MaterialRegistry::getBuffer()
+{
+	std::scoped_lock lock(_mutex);
+
+	return _buffers[_currentFrame];
+}
+
+void c3d::MaterialRegistry::onNewFrame()
+{
+	std::scoped_lock lock(_mutex);
+
+	_currentFrame = (_currentFrame + 1) % Engine::getVKContext().getConcurrentFrameCount();
+
+	for (uint32_t index : _pendingChanges[_currentFrame])
+	{
+		_buffers[_currentFrame]->getHostPointer()[index] = _materials[index];
+	}
+
+	_pendingChanges[_currentFrame].clear();
+}
+
+void c3d::MaterialRegistry::expand()
+{
+	uint32_t oldSize = _materials.size();
+	uint32_t newSize = oldSize > 0 ? oldSize * 2 : 64;
+
+	_materials.resize(newSize);
+
+	vk::BufferUsageFlags usage = vk::BufferUsageFlagBits::eStorageBuffer;
+	if (Engine::getVKContext().isRayTracingSupported())
+	{
+		usage |= vk::BufferUsageFlagBits::eShaderDeviceAddress;
+	}
+
+	// Buffers still used by frames in flight are kept alive by their command buffers
+	for (int i = 0; i < Engine::getVKContext().getConcurrentFrameCount(); i++)
+	{
+		VKBufferInfo bufferInfo(newSize, usage);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eDeviceLocal);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostVisible);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostCoherent);
+		bufferInfo.setName(std::format("Material registry buffer {}", i));
+
+		_buffers[i] = VKBuffer<MaterialData>::create(Engine::getVKContext(), bufferInfo);
+
+		std::ranges::copy(_materials, _buffers[i]->getHostPointer());
+
+		_pendingChanges[i].clear();
+	}
+
+	for (int64_t i = newSize - 1; i >= oldSize; i--)
+	{
+		_availableIndices.push(i);
+	}
+}
\ No newline at end of file
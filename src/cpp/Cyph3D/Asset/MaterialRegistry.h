@@ -0,0 +1,58 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <memory>
+#include <mutex>
+#include <stack>
+#include <vector>
+
+namespace c3d
+{
+template<typename T>
+class VKBuffer;
+
+// GPU table of the parameters of every material, shared by the rasterizer and the path tracer.
+// Each MaterialAsset owns a slot that it updates when it changes, objects refer to their material by slot index.
+class MaterialRegistry
+{
+public:
+	struct MaterialData
+	{
+		int32_t albedoIndex;
+		int32_t normalIndex;
+		int32_t roughnessIndex;
+		int32_t metalnessIndex;
+		int32_t displacementIndex;
+		int32_t emissiveIndex;
+		glm::vec3 albedoValue;
+		float roughnessValue;
+		float metalnessValue;
+		float displacementScale;
+		float emissiveScale;
+	};
+
+	MaterialRegistry();
+
+	uint32_t acquireIndex();
+	void releaseIndex(uint32_t index);
+	void setMaterial(uint32_t index, const MaterialData& data);
+
+	// Buffer of the current frame, its size is the number of slots
+	const std::shared_ptr<VKBuffer<MaterialData>>& getBuffer();
+
+	void onNewFrame();
+
+private:
+	std::stack<uint32_t> _availableIndices;
+	// Content of every slot, used to fill the buffers of the other frames and the new buffers on expansion
+	std::vector<MaterialData> _materials;
+	std::vector<std::shared_ptr<VKBuffer<MaterialData>>> _buffers;
+	std::vector<std::vector<uint32_t>> _pendingChanges;
+
+	uint32_t _currentFrame = 0;
+
+	std::mutex _mutex;
+
+	void expand();
+};
+}
\ No newline at end of file
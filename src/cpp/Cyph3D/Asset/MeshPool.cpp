@@ -0,0 +1,201 @@
+#include "MeshPool.h"
+
+#include <Cyph3D/Engine.h>
+#include <Cyph3D/VKObject/Buffer/VKBuffer.h>
+#include <Cyph3D/VKObject/VKContext.h>
+
+#include <algorithm>
+#include <format>
+
+c3d::MeshPool::MeshPool()
+{
+	_pendingFrees.resize(Engine::getVKContext().getConcurrentFrameCount() + 1);
+}
+
+c3d::MeshPool::Allocation c3d::MeshPool::allocate(uint32_t vertexCount, uint32_t indexCount)
+{
+	std::scoped_lock lock(_mutex);
+
+	uint32_t block = 0;
+	while (block < _blocks.size() && !(canAllocateRange(_blocks[block].freeVertexRanges, vertexCount) && canAllocateRange(_blocks[block].freeIndexRanges, indexCount)))
+	{
+		block++;
+	}
+
+	if (block == _blocks.size())
+	{
+		createBlock(std::max(vertexCount, BLOCK_VERTEX_COUNT), std::max(indexCount, BLOCK_INDEX_COUNT));
+	}
+
+	return {
+		.block = block,
+		.vertexOffset = allocateRange(_blocks[block].freeVertexRanges, vertexCount),
+		.vertexCount = vertexCount,
+		.indexOffset = allocateRange(_blocks[block].freeIndexRanges, indexCount),
+		.indexCount = indexCount
+	};
+}
+
+void c3d::MeshPool::free(const Allocation& allocation)
+{
+	std::scoped_lock lock(_mutex);
+
+	_pendingFrees[_currentFrame].push_back(allocation);
+}
+
+uint32_t c3d::MeshPool::getBlockCount()
+{
+	std::scoped_lock lock(_mutex);
+
+	return _blocks.size();
+}
+
+const std::shared_ptr<c3d::VKBuffer<c3d::PositionVertexData>>& c3d::MeshPool::getPositionVertexBuffer(uint32_t block)
+{
+	std::scoped_lock lock(_mutex);
+
+	return _blocks[block].positionVertexBuffer;
+}
+
+const std::shared_ptr<c3d::VKBuffer<c3d::MaterialVertexData>>& c3d::MeshPool::getMaterialVertexBuffer(uint32_t block)
+{
+	std::scoped_lock lock(_mutex);
+
+	return _blocks[block].materialVertexBuffer;
+}
+
+const std::shared_ptr<c3d::VKBuffer<uint32_t>>& c3d::MeshPool::getIndexBuffer(uint32_t block)
+{
+	std::scoped_lock lock(_mutex);
+
+	return _blocks[block].indexBuffer;
+}
+
+void c3d::MeshPool::onNewFrame()
+{
+	std::scoped_lock lock(_mutex);
+
+	_currentFrame = (_currentFrame + 1) % _pendingFrees.size();
+
+	for (const Allocation& allocation : _pendingFrees[_currentFrame])
+	{
+		release(allocation);
+	}
+
+	_pendingFrees[_currentFrame].clear();
+}
+
+void c3d::MeshPool::createBlock(uint32_t vertexCapacity, uint32_t indexCapacity)
+{
+	Block& block = _blocks.emplace_back();
+
+	{
+		VKBufferInfo bufferInfo(vertexCapacity, vk::BufferUsageFlagBits::eVertexBuffer);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eDeviceLocal);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostVisible);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostCoherent);
+		bufferInfo.setName(std::format("Mesh pool block {} position vertex buffer", _blocks.size() - 1));
+
+		block.positionVertexBuffer = VKBuffer<PositionVertexData>::create(Engine::getVKContext(), bufferInfo);
+	}
+
+	{
+		VKBufferInfo bufferInfo(vertexCapacity, vk::BufferUsageFlagBits::eVertexBuffer);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eDeviceLocal);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostVisible);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostCoherent);
+		bufferInfo.setName(std::format("Mesh pool block {} material vertex buffer", _blocks.size() - 1));
+
+		block.materialVertexBuffer = VKBuffer<MaterialVertexData>::create(Engine::getVKContext(), bufferInfo);
+	}
+
+	{
+		VKBufferInfo bufferInfo(indexCapacity, vk::BufferUsageFlagBits::eIndexBuffer);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eDeviceLocal);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostVisible);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostCoherent);
+		bufferInfo.setName(std::format("Mesh pool block {} index buffer", _blocks.size() - 1));
+
+		block.indexBuffer = VKBuffer<uint32_t>::create(Engine::getVKContext(), bufferInfo);
+	}
+
+	block.freeVertexRanges.push_back({0, vertexCapacity});
+	block.freeIndexRanges.push_back({0, indexCapacity});
+}
+
+void c3d::MeshPool::release(const Allocation& allocation)
+{
+	freeRange(_blocks[allocation.block].freeVertexRanges, {allocation.vertexOffset, allocation.vertexCount});
+	freeRange(_blocks[allocation.block].freeIndexRanges, {allocation.indexOffset, allocation.indexCount});
+}
+
+bool c3d::MeshPool::canAllocateRange(const std::vector<Range>& freeRanges, uint32_t size)
+{
+	return size == 0 || std::ranges::any_of(
+		freeRanges,
+		[&](const Range& range)
+		{
+			return range.size >= size;
+		}
+	);
+}
+
+uint32_t c3d::MeshPool::allocateRange(std::vector<Range>& freeRanges, uint32_t size)
+{
+	if (size == 0)
+	{
+		return 0;
+	}
+
+	// First fit, canAllocateRange() has been checked before
+	auto it = std::ranges::find_if(
+		freeRanges,
+		[&](const Range& range)
+		{
+			return range.size >= size;
+		}
+	);
+
+	uint32_t offset = it->offset;
+
+	it->offset += size;
+	it->size -= size;
+	if (it->size == 0)
+	{
+		freeRanges.erase(it);
+	}
+
+	return offset;
+}
+
+void c3d::MeshPool::freeRange(std::vector<Range>& freeRanges, Range range)
+{
+	if (range.size == 0)
+	{
+		return;
+	}
+
+	auto next = std::ranges::lower_bound(freeRanges, range.offset, std::less(), &Range::offset);
+
+	bool mergeWithPrevious = next != freeRanges.begin() && std::prev(next)->offset + std::prev(next)->size == range.offset;
+	bool mergeWithNext = next != freeRanges.end() && range.offset + range.size == next->offset;
+
+	if (mergeWithPrevious && mergeWithNext)
+	{
+		std::prev(next)->size += range.size + next->size;
+		freeRanges.erase(next);
+	}
+	else if (mergeWithPrevious)
+	{
+		std::prev(next)->size += range.size;
+	}
+	else if (mergeWithNext)
+	{
+		next->offset = range.offset;
+		next->size += range.size;
+	}
+	else
+	{
+		freeRanges.insert(next, range);
+	}
+}
\ No newline at end of file
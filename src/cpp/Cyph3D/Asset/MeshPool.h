@@ -0,0 +1,81 @@
+#pragma once
+
+#include <Cyph3D/Rendering/VertexData.h>
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace c3d
+{
+template<typename T>
+class VKBuffer;
+
+// Vertex and index buffers shared by all meshes, so that rasterization binds them once per block instead of once per mesh.
+// Each block is a set of large buffers suballocated between meshes, a new one is created when a mesh fits in none of them.
+class MeshPool
+{
+public:
+	struct Allocation
+	{
+		uint32_t block;
+		uint32_t vertexOffset;
+		uint32_t vertexCount;
+		uint32_t indexOffset;
+		uint32_t indexCount;
+	};
+
+	MeshPool();
+
+	// The allocated ranges can be written directly through the host pointers of the block buffers
+	Allocation allocate(uint32_t vertexCount, uint32_t indexCount);
+	// The ranges are only reused once the frames that may still draw them have completed
+	void free(const Allocation& allocation);
+
+	uint32_t getBlockCount();
+	const std::shared_ptr<VKBuffer<PositionVertexData>>& getPositionVertexBuffer(uint32_t block);
+	const std::shared_ptr<VKBuffer<MaterialVertexData>>& getMaterialVertexBuffer(uint32_t block);
+	const std::shared_ptr<VKBuffer<uint32_t>>& getIndexBuffer(uint32_t block);
+
+	void onNewFrame();
+
+private:
+	struct Range
+	{
+		uint32_t offset;
+		uint32_t size;
+	};
+
+	struct Block
+	{
+		std::shared_ptr<VKBuffer<PositionVertexData>> positionVertexBuffer;
+		std::shared_ptr<VKBuffer<MaterialVertexData>> materialVertexBuffer;
+		std::shared_ptr<VKBuffer<uint32_t>> indexBuffer;
+
+		// Sorted by offset, adjacent ranges are always merged
+		std::vector<Range> freeVertexRanges;
+		std::vector<Range> freeIndexRanges;
+	};
+
+	static constexpr uint32_t BLOCK_VERTEX_COUNT = 1 << 20;
+	static constexpr uint32_t BLOCK_INDEX_COUNT = 1 << 22;
+
+	// Blocks are never destroyed or moved, references to their buffers stay valid
+	std::deque<Block> _blocks;
+
+	// Allocations freed during a frame, released when the same index comes back in onNewFrame().
+	// There is one more list than concurrent frames as onNewFrame() is called before waiting for the previous use of the frame's resources.
+	std::vector<std::vector<Allocation>> _pendingFrees;
+	uint32_t _currentFrame = 0;
+
+	std::mutex _mutex;
+
+	void createBlock(uint32_t vertexCapacity, uint32_t indexCapacity);
+	void release(const Allocation& allocation);
+
+	static bool canAllocateRange(const std::vector<Range>& freeRanges, uint32_t size);
+	static uint32_t allocateRange(std::vector<Range>& freeRanges, uint32_t size);
+	static void freeRange(std::vector<Range>& freeRanges, Range range);
+};
+}
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <Cyph3D/Rendering/MeshBVH.h>
 #include <Cyph3D/Rendering/VertexData.h>
 
 #include <vector>
@@ -13,5 +14,6 @@ struct MeshData
 	std::vector<uint32_t> indices;
 	glm::vec3 boundingBoxMin;
 	glm::vec3 boundingBoxMax;
+	std::vector<MeshBVHNode> bvhNodes;
 };
 }
\ No newline at end of file
@@ -14,7 +14,7 @@ void writeProcessedMesh(const std::filesystem::path& path, const c3d::MeshData&
 	std::filesystem::create_directories(path.parent_path());
 	std::ofstream file = c3d::FileHelper::openFileForWriting(path);
 
-	uint8_t version = 5;
+	uint8_t version = 6;
 	c3d::FileHelper::write(file, &version);
 
 	c3d::FileHelper::write(file, meshData.positionVertices);
@@ -24,6 +24,8 @@ void writeProcessedMesh(const std::filesystem::path& path, const c3d::MeshData&
 
 	c3d::FileHelper::write(file, &meshData.boundingBoxMin);
 	c3d::FileHelper::write(file, &meshData.boundingBoxMax);
+
+	c3d::FileHelper::write(file, meshData.bvhNodes);
 }
 
 bool readProcessedMesh(const std::filesystem::path& path, c3d::MeshData& meshData)
@@ -33,7 +35,7 @@ bool readProcessedMesh(const std::filesystem::path& path, c3d::MeshData& meshDat
 	uint8_t version;
 	c3d::FileHelper::read(file, &version);
 
-	if (version != 5)
+	if (version != 6)
 	{
 		return false;
 	}
@@ -46,6 +48,8 @@ bool readProcessedMesh(const std::filesystem::path& path, c3d::MeshData& meshDat
 	c3d::FileHelper::read(file, &meshData.boundingBoxMin);
 	c3d::FileHelper::read(file, &meshData.boundingBoxMax);
 
+	c3d::FileHelper::read(file, meshData.bvhNodes);
+
 	return true;
 }
 
@@ -96,6 +100,8 @@ c3d::MeshData processMesh(const std::filesystem::path& input, const std::filesys
 		meshData.indices[i * 3 + 2] = mesh->mFaces[i].mIndices[2];
 	}
 
+	meshData.bvhNodes = c3d::MeshBVH::build(meshData.positionVertices, meshData.indices);
+
 	writeProcessedMesh(output, meshData);
 
 	return meshData;
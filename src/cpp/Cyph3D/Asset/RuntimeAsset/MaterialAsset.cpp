@@ -5,6 +5,7 @@
 #include <Cyph3D/Helper/FileHelper.h>
 #include <Cyph3D/Helper/ImGuiHelper.h>
 #include <Cyph3D/Helper/JsonHelper.h>
+#include <Cyph3D/Helper/MathHelper.h>
 #include <Cyph3D/VKObject/CommandBuffer/VKCommandBuffer.h>
 #include <Cyph3D/Window.h>
 
@@ -17,10 +18,21 @@ c3d::MaterialAsset* c3d::MaterialAsset::_missingMaterial = nullptr;
 c3d::MaterialAsset::MaterialAsset(AssetManager& manager, const MaterialAssetSignature& signature):
 	RuntimeAsset(manager, signature)
 {
+	_materialIndex = _manager.getMaterialRegistry().acquireIndex();
+	_materialRegistryUpdateConnection = _changed.connect(
+		[this]()
+		{
+			updateMaterialRegistry();
+		}
+	);
+
 	reload();
 }
 
-c3d::MaterialAsset::~MaterialAsset() = default;
+c3d::MaterialAsset::~MaterialAsset()
+{
+	_manager.getMaterialRegistry().releaseIndex(_materialIndex);
+}
 
 bool c3d::MaterialAsset::isLoaded() const
 {
@@ -380,6 +392,11 @@ void c3d::MaterialAsset::setEmissiveScale(const float& scale)
 	_changed();
 }
 
+uint32_t c3d::MaterialAsset::getMaterialIndex() const
+{
+	return _materialIndex;
+}
+
 void c3d::MaterialAsset::initDefaultAndMissing()
 {
 	_defaultMaterial = Engine::getAssetManager().loadMaterial("materials/internal/Default Material/Default Material.c3dmaterial");
@@ -986,4 +1003,23 @@ void c3d::MaterialAsset::reload()
 	default:
 		throw;
 	}
+}
+
+void c3d::MaterialAsset::updateMaterialRegistry()
+{
+	MaterialRegistry::MaterialData data{
+		.albedoIndex = getAlbedoTextureBindlessIndex(),
+		.normalIndex = getNormalTextureBindlessIndex(),
+		.roughnessIndex = getRoughnessTextureBindlessIndex(),
+		.metalnessIndex = getMetalnessTextureBindlessIndex(),
+		.displacementIndex = getDisplacementTextureBindlessIndex(),
+		.emissiveIndex = getEmissiveTextureBindlessIndex(),
+		.albedoValue = MathHelper::srgbToLinear(getAlbedoValue()),
+		.roughnessValue = getRoughnessValue(),
+		.metalnessValue = getMetalnessValue(),
+		.displacementScale = getDisplacementScale(),
+		.emissiveScale = getEmissiveScale()
+	};
+
+	_manager.getMaterialRegistry().setMaterial(_materialIndex, data);
 }
\ No newline at end of file
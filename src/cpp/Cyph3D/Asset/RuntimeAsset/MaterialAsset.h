@@ -64,6 +64,9 @@ public:
 	const float& getEmissiveScale() const;
 	void setEmissiveScale(const float& scale);
 
+	// Slot of this material in the MaterialRegistry
+	uint32_t getMaterialIndex() const;
+
 	static void initDefaultAndMissing();
 	static MaterialAsset* getDefaultMaterial();
 	static MaterialAsset* getMissingMaterial();
@@ -83,6 +86,8 @@ private:
 	void save() const;
 	void reload();
 
+	void updateMaterialRegistry();
+
 	TextureAsset* _albedoTexture = nullptr;
 	sigslot::scoped_connection _albedoTextureChangedConnection;
 
@@ -108,6 +113,9 @@ private:
 	float _displacementScale{};
 	float _emissiveScale{};
 
+	uint32_t _materialIndex;
+	sigslot::scoped_connection _materialRegistryUpdateConnection;
+
 	static MaterialAsset* _defaultMaterial;
 	static MaterialAsset* _missingMaterial;
 };
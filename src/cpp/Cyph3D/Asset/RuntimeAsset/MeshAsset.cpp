@@ -20,7 +20,13 @@ c3d::MeshAsset::MeshAsset(AssetManager& manager, const MeshAssetSignature& signa
 	_manager.addThreadPoolTask(&MeshAsset::load_async, this);
 }
 
-c3d::MeshAsset::~MeshAsset() = default;
+c3d::MeshAsset::~MeshAsset()
+{
+	if (_loaded)
+	{
+		_manager.getMeshPool().free(_meshPoolAllocation);
+	}
+}
 
 const std::shared_ptr<c3d::VKBuffer<c3d::PositionVertexData>>& c3d::MeshAsset::getPositionVertexBuffer() const
 {
@@ -46,6 +52,12 @@ const std::shared_ptr<c3d::VKAccelerationStructure>& c3d::MeshAsset::getAccelera
 	return _accelerationStructure;
 }
 
+const c3d::MeshPool::Allocation& c3d::MeshAsset::getMeshPoolAllocation() const
+{
+	checkLoaded();
+	return _meshPoolAllocation;
+}
+
 const glm::vec3& c3d::MeshAsset::getBoundingBoxMin() const
 {
 	checkLoaded();
@@ -58,6 +70,18 @@ const glm::vec3& c3d::MeshAsset::getBoundingBoxMax() const
 	return _boundingBoxMax;
 }
 
+bool c3d::MeshAsset::hasRaycastData() const
+{
+	checkLoaded();
+	return !_bvhNodes.empty();
+}
+
+float c3d::MeshAsset::raycast(glm::vec3 origin, glm::vec3 direction, float maxDistance, bool clockwiseFrontFaces) const
+{
+	checkLoaded();
+	return MeshBVH::raycast(_bvhNodes, _raycastVertices, _raycastIndices, origin, direction, maxDistance, clockwiseFrontFaces);
+}
+
 void c3d::MeshAsset::initDefaultAndMissing()
 {
 	_defaultMesh = Engine::getAssetManager().loadMesh("meshes/internal/Default Mesh/Default Mesh.obj");
@@ -80,65 +104,47 @@ void c3d::MeshAsset::load_async()
 
 	spdlog::info("Uploading mesh [{}]...", _signature.path);
 
+	// Acceleration structures are built on the compute queue, which takes ownership of their inputs, so meshes keep their own buffers for ray tracing
+	if (Engine::getVKContext().isRayTracingSupported())
 	{
-		vk::BufferUsageFlags positionVertexBufferUsage = vk::BufferUsageFlagBits::eVertexBuffer;
-		vk::DeviceAddress positionVertexBufferAlignment = 1;
-		if (Engine::getVKContext().isRayTracingSupported())
 		{
-			positionVertexBufferUsage |= vk::BufferUsageFlagBits::eShaderDeviceAddress | vk::BufferUsageFlagBits::eAccelerationStructureBuildInputReadOnlyKHR;
-			positionVertexBufferAlignment = sizeof(float);
-		}
-		VKBufferInfo positionVertexBufferInfo(meshData.positionVertices.size(), positionVertexBufferUsage);
-		positionVertexBufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eDeviceLocal);
-		positionVertexBufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostVisible);
-		positionVertexBufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostCoherent);
-		positionVertexBufferInfo.setRequiredAlignment(positionVertexBufferAlignment);
-		positionVertexBufferInfo.setName(std::format("{}.PositionVertexBuffer", _signature.path));
+			VKBufferInfo positionVertexBufferInfo(meshData.positionVertices.size(), vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eShaderDeviceAddress | vk::BufferUsageFlagBits::eAccelerationStructureBuildInputReadOnlyKHR);
+			positionVertexBufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eDeviceLocal);
+			positionVertexBufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostVisible);
+			positionVertexBufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostCoherent);
+			positionVertexBufferInfo.setRequiredAlignment(sizeof(float));
+			positionVertexBufferInfo.setName(std::format("{}.PositionVertexBuffer", _signature.path));
 
-		_positionVertexBuffer = VKBuffer<PositionVertexData>::create(Engine::getVKContext(), positionVertexBufferInfo);
+			_positionVertexBuffer = VKBuffer<PositionVertexData>::create(Engine::getVKContext(), positionVertexBufferInfo);
 
-		std::ranges::copy(meshData.positionVertices, _positionVertexBuffer->getHostPointer());
-	}
+			std::ranges::copy(meshData.positionVertices, _positionVertexBuffer->getHostPointer());
+		}
 
-	{
-		vk::BufferUsageFlags materialVertexBufferUsage = vk::BufferUsageFlagBits::eVertexBuffer;
-		if (Engine::getVKContext().isRayTracingSupported())
 		{
-			materialVertexBufferUsage |= vk::BufferUsageFlagBits::eShaderDeviceAddress;
-		}
-		VKBufferInfo materialVertexBufferInfo(meshData.materialVertices.size(), materialVertexBufferUsage);
-		materialVertexBufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eDeviceLocal);
-		materialVertexBufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostVisible);
-		materialVertexBufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostCoherent);
-		materialVertexBufferInfo.setName(std::format("{}.MaterialVertexBuffer", _signature.path));
+			VKBufferInfo materialVertexBufferInfo(meshData.materialVertices.size(), vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eShaderDeviceAddress);
+			materialVertexBufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eDeviceLocal);
+			materialVertexBufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostVisible);
+			materialVertexBufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostCoherent);
+			materialVertexBufferInfo.setName(std::format("{}.MaterialVertexBuffer", _signature.path));
 
-		_materialVertexBuffer = VKBuffer<MaterialVertexData>::create(Engine::getVKContext(), materialVertexBufferInfo);
+			_materialVertexBuffer = VKBuffer<MaterialVertexData>::create(Engine::getVKContext(), materialVertexBufferInfo);
 
-		std::ranges::copy(meshData.materialVertices, _materialVertexBuffer->getHostPointer());
-	}
+			std::ranges::copy(meshData.materialVertices, _materialVertexBuffer->getHostPointer());
+		}
 
-	{
-		vk::BufferUsageFlags indexBufferUsage = vk::BufferUsageFlagBits::eIndexBuffer;
-		vk::DeviceAddress indexBufferAlignment = 1;
-		if (Engine::getVKContext().isRayTracingSupported())
 		{
-			indexBufferUsage |= vk::BufferUsageFlagBits::eShaderDeviceAddress | vk::BufferUsageFlagBits::eAccelerationStructureBuildInputReadOnlyKHR;
-			indexBufferAlignment = sizeof(uint32_t);
-		}
-		VKBufferInfo indexBufferInfo(meshData.indices.size(), indexBufferUsage);
-		indexBufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eDeviceLocal);
-		indexBufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostVisible);
-		indexBufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostCoherent);
-		indexBufferInfo.setRequiredAlignment(indexBufferAlignment);
-		indexBufferInfo.setName(std::format("{}.IndexBuffer", _signature.path));
+			VKBufferInfo indexBufferInfo(meshData.indices.size(), vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eShaderDeviceAddress | vk::BufferUsageFlagBits::eAccelerationStructureBuildInputReadOnlyKHR);
+			indexBufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eDeviceLocal);
+			indexBufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostVisible);
+			indexBufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostCoherent);
+			indexBufferInfo.setRequiredAlignment(sizeof(uint32_t));
+			indexBufferInfo.setName(std::format("{}.IndexBuffer", _signature.path));
 
-		_indexBuffer = VKBuffer<uint32_t>::create(Engine::getVKContext(), indexBufferInfo);
+			_indexBuffer = VKBuffer<uint32_t>::create(Engine::getVKContext(), indexBufferInfo);
 
-		std::ranges::copy(meshData.indices, _indexBuffer->getHostPointer());
-	}
+			std::ranges::copy(meshData.indices, _indexBuffer->getHostPointer());
+		}
 
-	if (Engine::getVKContext().isRayTracingSupported())
-	{
 		// Create temporary acceleration structure
 
 		VKBottomLevelAccelerationStructureBuildInfo buildInfo{
@@ -291,39 +297,26 @@ void c3d::MeshAsset::load_async()
 		assetGraphicsCommandBuffer->waitExecution();
 		assetGraphicsCommandBuffer->reset();
 	}
-	else
-	{
-		assetGraphicsCommandBuffer->begin();
-
-		assetGraphicsCommandBuffer->bufferMemoryBarrier(
-			_positionVertexBuffer,
-			vk::PipelineStageFlagBits2::eVertexAttributeInput,
-			vk::AccessFlagBits2::eVertexAttributeRead
-		);
 
-		assetGraphicsCommandBuffer->bufferMemoryBarrier(
-			_materialVertexBuffer,
-			vk::PipelineStageFlagBits2::eVertexAttributeInput,
-			vk::AccessFlagBits2::eVertexAttributeRead
-		);
-
-		assetGraphicsCommandBuffer->bufferMemoryBarrier(
-			_indexBuffer,
-			vk::PipelineStageFlagBits2::eIndexInput,
-			vk::AccessFlagBits2::eIndexRead
-		);
-
-		assetGraphicsCommandBuffer->end();
+	// Allocated last so that no failure can happen past this point, the allocation is only held by loaded meshes and freed by the destructor
+	{
+		MeshPool& meshPool = _manager.getMeshPool();
 
-		Engine::getVKContext().getMainQueue().submit(assetGraphicsCommandBuffer, {}, {});
+		_meshPoolAllocation = meshPool.allocate(meshData.positionVertices.size(), meshData.indices.size());
 
-		assetGraphicsCommandBuffer->waitExecution();
-		assetGraphicsCommandBuffer->reset();
+		// Host writes are made visible to the device by the submission of the next frame
+		std::ranges::copy(meshData.positionVertices, meshPool.getPositionVertexBuffer(_meshPoolAllocation.block)->getHostPointer() + _meshPoolAllocation.vertexOffset);
+		std::ranges::copy(meshData.materialVertices, meshPool.getMaterialVertexBuffer(_meshPoolAllocation.block)->getHostPointer() + _meshPoolAllocation.vertexOffset);
+		std::ranges::copy(meshData.indices, meshPool.getIndexBuffer(_meshPoolAllocation.block)->getHostPointer() + _meshPoolAllocation.indexOffset);
 	}
 
 	_boundingBoxMin = meshData.boundingBoxMin;
 	_boundingBoxMax = meshData.boundingBoxMax;
 
+	_raycastVertices = std::move(meshData.positionVertices);
+	_raycastIndices = std::move(meshData.indices);
+	_bvhNodes = std::move(meshData.bvhNodes);
+
 	_loaded = true;
 	spdlog::info("Mesh [{}] uploaded succesfully", _signature.path);
 
@@ -1,11 +1,13 @@
 #pragma once
 
+#include <Cyph3D/Asset/MeshPool.h>
 #include <Cyph3D/Asset/Processing/MeshData.h>
 #include <Cyph3D/Asset/RuntimeAsset/GPUAsset.h>
 #include <Cyph3D/HashBuilder.h>
 
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace c3d
 {
@@ -26,14 +28,23 @@ class MeshAsset : public GPUAsset<MeshAssetSignature>
 public:
 	~MeshAsset() override;
 
+	// Buffers of the mesh alone, only created when ray tracing is supported
 	const std::shared_ptr<VKBuffer<PositionVertexData>>& getPositionVertexBuffer() const;
 	const std::shared_ptr<VKBuffer<MaterialVertexData>>& getMaterialVertexBuffer() const;
 	const std::shared_ptr<VKBuffer<uint32_t>>& getIndexBuffer() const;
 	const std::shared_ptr<VKAccelerationStructure>& getAccelerationStructure() const;
 
+	// Location of the geometry in the buffers of the mesh pool, used for rasterization
+	const MeshPool::Allocation& getMeshPoolAllocation() const;
+
 	const glm::vec3& getBoundingBoxMin() const;
 	const glm::vec3& getBoundingBoxMax() const;
 
+	// False if the mesh has no triangle BVH, in which case raycast() never hits
+	bool hasRaycastData() const;
+	// The ray is in the local space of the mesh, see MeshBVH::raycast()
+	float raycast(glm::vec3 origin, glm::vec3 direction, float maxDistance, bool clockwiseFrontFaces) const;
+
 	static void initDefaultAndMissing();
 	static MeshAsset* getDefaultMesh();
 	static MeshAsset* getMissingMesh();
@@ -50,9 +61,16 @@ private:
 	std::shared_ptr<VKBuffer<uint32_t>> _indexBuffer;
 	std::shared_ptr<VKAccelerationStructure> _accelerationStructure;
 
+	MeshPool::Allocation _meshPoolAllocation;
+
 	glm::vec3 _boundingBoxMin = {0, 0, 0};
 	glm::vec3 _boundingBoxMax = {0, 0, 0};
 
+	// CPU copies of the geometry for ray casts
+	std::vector<PositionVertexData> _raycastVertices;
+	std::vector<uint32_t> _raycastIndices;
+	std::vector<MeshBVHNode> _bvhNodes;
+
 	static MeshAsset* _defaultMesh;
 	static MeshAsset* _missingMesh;
 };
@@ -3,9 +3,12 @@
 #include <Cyph3D/Asset/AssetManager.h>
 #include <Cyph3D/Entity/Entity.h>
 #include <Cyph3D/Helper/FileHelper.h>
+#include <Cyph3D/Scene/Camera.h>
 #include <Cyph3D/Scene/Scene.h>
+#include <Cyph3D/Scene/SceneLoader.h>
 #include <Cyph3D/UI/UIHelper.h>
 #include <Cyph3D/UI/Window/UIInspector.h>
+#include <Cyph3D/UI/Window/UIViewport.h>
 #include <Cyph3D/VKObject/CommandBuffer/VKCommandBuffer.h>
 #include <Cyph3D/VKObject/Image/VKSwapchainImage.h>
 #include <Cyph3D/VKObject/Queue/VKQueue.h>
@@ -66,8 +69,10 @@ std::unique_ptr<c3d::VKContext> c3d::Engine::_vkContext;
 std::unique_ptr<c3d::Window> c3d::Engine::_window;
 std::unique_ptr<c3d::AssetManager> c3d::Engine::_assetManager;
 std::unique_ptr<c3d::Scene> c3d::Engine::_scene;
+std::unique_ptr<c3d::SceneLoader> c3d::Engine::_sceneLoader;
 
 c3d::Timer c3d::Engine::_timer;
+std::unique_ptr<BS::light_thread_pool> c3d::Engine::_threadPool;
 
 void c3d::Engine::init()
 {
@@ -99,6 +104,8 @@ void c3d::Engine::init()
 
 	_assetManager = std::make_unique<AssetManager>();
 
+	_threadPool = std::make_unique<BS::light_thread_pool>();
+
 	MaterialAsset::initDefaultAndMissing();
 	MeshAsset::initDefaultAndMissing();
 	Entity::initComponentFactories();
@@ -142,7 +149,10 @@ void c3d::Engine::run()
 
 		UIHelper::onNewFrame();
 
+		updateSceneLoader();
+
 		_scene->onUpdate();
+		_scene->updateTransforms();
 
 		const std::shared_ptr<VKSemaphore>& presentSemaphore = presentSemaphores[image->getIndex()];
 		UIHelper::render(image->getImage(), presentSemaphore);
@@ -177,7 +187,9 @@ void c3d::Engine::shutdown()
 
 	FileHelper::shutdown();
 	UIHelper::shutdown();
+	_sceneLoader.reset();
 	_scene.reset();
+	_threadPool.reset();
 	_assetManager.reset();
 	_window.reset();
 	_vkContext.reset();
@@ -206,6 +218,58 @@ c3d::Scene& c3d::Engine::getScene()
 }
 
 void c3d::Engine::setScene(std::unique_ptr<Scene>&& scene)
+{
+	// a pending load would replace this scene once done
+	_sceneLoader.reset();
+
+	swapScene(std::move(scene));
+}
+
+c3d::SceneLoader* c3d::Engine::getSceneLoader()
+{
+	return _sceneLoader.get();
+}
+
+void c3d::Engine::setSceneLoader(std::unique_ptr<SceneLoader>&& sceneLoader)
+{
+	_sceneLoader = std::move(sceneLoader);
+}
+
+void c3d::Engine::updateSceneLoader()
+{
+	if (!_sceneLoader)
+	{
+		return;
+	}
+
+	_sceneLoader->update();
+
+	Camera camera;
+	if (std::unique_ptr<Scene> scene = _sceneLoader->takeScene(camera))
+	{
+		UIViewport::setCamera(camera);
+		swapScene(std::move(scene));
+	}
+
+	if (_sceneLoader->isFinished())
+	{
+		if (std::exception_ptr exception = _sceneLoader->getException())
+		{
+			try
+			{
+				std::rethrow_exception(exception);
+			}
+			catch (const std::exception& e)
+			{
+				spdlog::error("Failed to load scene \"{}\": {}", _sceneLoader->getPath().generic_string(), e.what());
+			}
+		}
+
+		_sceneLoader.reset();
+	}
+}
+
+void c3d::Engine::swapScene(std::unique_ptr<Scene>&& scene)
 {
 	UIInspector::setSelected(nullptr);
 	_scene = std::move(scene);
@@ -214,4 +278,9 @@ void c3d::Engine::setScene(std::unique_ptr<Scene>&& scene)
 c3d::Timer& c3d::Engine::getTimer()
 {
 	return _timer;
+}
+
+BS::light_thread_pool& c3d::Engine::getThreadPool()
+{
+	return *_threadPool;
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <Cyph3D/Timer.h>
 
+#include <BS_thread_pool.hpp>
 #include <memory>
 
 namespace c3d
@@ -10,6 +11,7 @@ class VKContext;
 class Window;
 class AssetManager;
 class Scene;
+class SceneLoader;
 
 class Engine
 {
@@ -23,14 +25,22 @@ public:
 	static AssetManager& getAssetManager();
 	static Scene& getScene();
 	static void setScene(std::unique_ptr<Scene>&& scene);
+	static SceneLoader* getSceneLoader();
+	static void setSceneLoader(std::unique_ptr<SceneLoader>&& sceneLoader);
 	static Timer& getTimer();
+	static BS::light_thread_pool& getThreadPool();
 
 private:
 	static std::unique_ptr<VKContext> _vkContext;
 	static std::unique_ptr<Window> _window;
 	static std::unique_ptr<AssetManager> _assetManager;
 	static std::unique_ptr<Scene> _scene;
+	static std::unique_ptr<SceneLoader> _sceneLoader;
 
 	static Timer _timer;
+	static std::unique_ptr<BS::light_thread_pool> _threadPool;
+
+	static void updateSceneLoader();
+	static void swapScene(std::unique_ptr<Scene>&& scene);
 };
 }
\ No newline at end of file
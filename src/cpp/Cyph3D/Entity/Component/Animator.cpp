@@ -3,6 +3,7 @@
 #include <Cyph3D/Engine.h>
 #include <Cyph3D/Entity/Entity.h>
 #include <Cyph3D/ObjectSerialization.h>
+#include <Cyph3D/Scene/Scene.h>
 #include <Cyph3D/UI/Window/UIMisc.h>
 
 #include <glm/gtc/type_ptr.hpp>
@@ -1,15 +1,19 @@
 #pragma once
 
 #include <Cyph3D/Entity/Component/Component.h>
+#include <Cyph3D/Scene/SceneChangeTracker.h>
 
 #include <glm/glm.hpp>
 #include <nlohmann/json_fwd.hpp>
 
 namespace c3d
 {
-class Animator : public Component
+class Animator final : public Component
 {
 public:
+	// Animator parameters only affect rendering through the transforms they update
+	static constexpr SceneChangeFlags changeCategory = SceneChangeFlags::eOther;
+
 	explicit Animator(Entity& entity);
 
 	glm::vec3 getVelocity() const;
@@ -14,9 +14,6 @@ c3d::Entity& c3d::Component::getEntity() const
 void c3d::Component::onUpdate()
 {}
 
-void c3d::Component::onPreRender(RenderRegistry& renderRegistry, Camera& camera)
-{}
-
 void c3d::Component::onDrawUi()
 {}
 
@@ -1,13 +1,12 @@
 #pragma once
 
+#include <cstdint>
 #include <sigslot/signal.hpp>
 
 namespace c3d
 {
 class Entity;
 class Transform;
-class RenderRegistry;
-class Camera;
 struct ObjectSerialization;
 
 class Component
@@ -28,7 +27,6 @@ public:
 	sigslot::signal<>& getChangedSignal();
 
 	virtual void onUpdate();
-	virtual void onPreRender(RenderRegistry& renderRegistry, Camera& camera);
 	virtual void onDrawUi();
 
 	virtual const char* getIdentifier() const = 0;
@@ -43,5 +41,9 @@ protected:
 
 private:
 	Entity& _entity;
+	uint32_t _poolIndex = 0;
+
+	template<typename T>
+	friend class ComponentPool;
 };
 }
\ No newline at end of file
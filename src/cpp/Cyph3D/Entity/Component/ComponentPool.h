@@ -0,0 +1,129 @@
+#pragma once
+
+#include <Cyph3D/Entity/Component/Component.h>
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace c3d
+{
+class ComponentPoolBase
+{
+public:
+	virtual ~ComponentPoolBase() = default;
+
+	virtual void destroy(Component* component) = 0;
+};
+
+struct ComponentDeleter
+{
+	ComponentPoolBase* pool = nullptr;
+
+	void operator()(Component* component) const
+	{
+		pool->destroy(component);
+	}
+};
+
+// Storage for all components of a given type in a scene.
+// Components are constructed in fixed-size blocks so that their address never changes (signals and render data keep pointers to them),
+// and a dense list of live components lets per-frame systems iterate them linearly with no holes.
+template<typename T>
+class ComponentPool : public ComponentPoolBase
+{
+public:
+	ComponentPool() = default;
+	ComponentPool(const ComponentPool& other) = delete;
+	ComponentPool& operator=(const ComponentPool& other) = delete;
+
+	~ComponentPool() override
+	{
+		for (T* component : _components)
+		{
+			component->~T();
+		}
+	}
+
+	template<typename... Args>
+	T& create(Args&&... args)
+	{
+		if (_freeSlots.empty())
+		{
+			allocateBlock(BLOCK_SIZE);
+		}
+
+		Slot* slot = _freeSlots.back();
+		_freeSlots.pop_back();
+
+		T* component = new (slot->storage) T(std::forward<Args>(args)...);
+		component->_poolIndex = _components.size();
+		_components.push_back(component);
+
+		return *component;
+	}
+
+	void destroy(Component* component) override
+	{
+		T* typedComponent = static_cast<T*>(component);
+
+		uint32_t index = typedComponent->_poolIndex;
+		_components[index] = _components.back();
+		_components[index]->_poolIndex = index;
+		_components.pop_back();
+
+		typedComponent->~T();
+		_freeSlots.push_back(reinterpret_cast<Slot*>(typedComponent));
+	}
+
+	// Makes room for count more components with at most one allocation
+	void reserve(size_t count)
+	{
+		if (_freeSlots.size() < count)
+		{
+			allocateBlock(count - _freeSlots.size());
+		}
+
+		_components.reserve(_components.size() + count);
+	}
+
+	size_t getSize() const
+	{
+		return _components.size();
+	}
+
+	typename std::vector<T*>::const_iterator begin() const
+	{
+		return _components.cbegin();
+	}
+
+	typename std::vector<T*>::const_iterator end() const
+	{
+		return _components.cend();
+	}
+
+private:
+	static constexpr size_t BLOCK_SIZE = 64;
+
+	struct Slot
+	{
+		alignas(T) std::byte storage[sizeof(T)];
+	};
+
+	std::vector<std::unique_ptr<Slot[]>> _blocks;
+	std::vector<Slot*> _freeSlots;
+	std::vector<T*> _components;
+
+	void allocateBlock(size_t size)
+	{
+		Slot* block = _blocks.emplace_back(std::make_unique<Slot[]>(size)).get();
+		// Pushed in reverse so that slots are handed out in address order
+		for (size_t i = size; i > 0; i--)
+		{
+			_freeSlots.push_back(&block[i - 1]);
+		}
+	}
+};
+}
\ No newline at end of file
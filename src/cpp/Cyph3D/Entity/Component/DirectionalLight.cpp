@@ -14,19 +14,19 @@ const char* const c3d::DirectionalLight::identifier = "DirectionalLight";
 c3d::DirectionalLight::DirectionalLight(Entity& entity):
 	LightBase(entity)
 {
+	_renderProxyUpdateConnection = _changed.connect(
+		[this]()
+		{
+			updateRenderProxy();
+		}
+	);
+
+	updateRenderProxy();
 }
 
-void c3d::DirectionalLight::onPreRender(RenderRegistry& renderRegistry, Camera& camera)
+c3d::DirectionalLight::~DirectionalLight()
 {
-	RenderData data{
-		.transform = getTransform(),
-		.intensity = getIntensity(),
-		.color = getLinearColor(),
-		.castShadows = getCastShadows(),
-		.shadowMapResolution = getResolution()
-	};
-
-	renderRegistry.addRenderRequest(data);
+	getEntity().getScene().getRenderRegistry().removeDirectionalLight(*_renderProxy);
 }
 
 void c3d::DirectionalLight::onDrawUi()
@@ -160,6 +160,26 @@ void c3d::DirectionalLight::deserialize(const ObjectSerialization& serialization
 	}
 }
 
+void c3d::DirectionalLight::updateRenderProxy()
+{
+	RenderData data{
+		.intensity = getIntensity(),
+		.color = getLinearColor(),
+		.castShadows = getCastShadows(),
+		.shadowMapResolution = getResolution()
+	};
+
+	RenderRegistry& renderRegistry = getEntity().getScene().getRenderRegistry();
+	if (_renderProxy)
+	{
+		renderRegistry.updateDirectionalLight(*_renderProxy, data);
+	}
+	else
+	{
+		_renderProxy = renderRegistry.addDirectionalLight(getEntity(), data);
+	}
+}
+
 void c3d::DirectionalLight::deserializeFromVersion1(const nlohmann::ordered_json& jsonRoot)
 {
 	setSrgbColor(glm::make_vec3(jsonRoot["color"].get<std::vector<float>>().data()));
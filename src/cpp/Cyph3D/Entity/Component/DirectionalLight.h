@@ -3,15 +3,15 @@
 #include <Cyph3D/Entity/Component/LightBase.h>
 
 #include <nlohmann/json_fwd.hpp>
+#include <optional>
 
 namespace c3d
 {
-class DirectionalLight : public LightBase
+class DirectionalLight final : public LightBase
 {
 public:
 	struct RenderData
 	{
-		Transform& transform;
 		float intensity;
 		glm::vec3 color;
 		bool castShadows;
@@ -19,8 +19,8 @@ public:
 	};
 
 	explicit DirectionalLight(Entity& entity);
+	~DirectionalLight() override;
 
-	void onPreRender(RenderRegistry& renderRegistry, Camera& camera) override;
 	void onDrawUi() override;
 
 	static const char* const identifier;
@@ -46,6 +46,11 @@ private:
 	bool _castShadows = false;
 	uint32_t _resolution = 4096;
 
+	std::optional<uint32_t> _renderProxy;
+	sigslot::scoped_connection _renderProxyUpdateConnection;
+
+	void updateRenderProxy();
+
 	void deserializeFromVersion1(const nlohmann::ordered_json& jsonRoot);
 	void deserializeFromVersion2(const nlohmann::ordered_json& jsonRoot);
 };
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Cyph3D/Entity/Component/Component.h>
+#include <Cyph3D/Scene/SceneChangeTracker.h>
 
 #include <glm/glm.hpp>
 
@@ -9,6 +10,8 @@ namespace c3d
 class LightBase : public Component
 {
 public:
+	static constexpr SceneChangeFlags changeCategory = SceneChangeFlags::eLight;
+
 	explicit LightBase(Entity& entity);
 
 	glm::vec3 getLinearColor() const;
@@ -8,6 +8,7 @@
 #include <Cyph3D/Helper/ImGuiHelper.h>
 #include <Cyph3D/ObjectSerialization.h>
 #include <Cyph3D/Rendering/RenderRegistry.h>
+#include <Cyph3D/Scene/Scene.h>
 
 #include <imgui.h>
 
@@ -16,10 +17,25 @@ const char* c3d::ModelRenderer::identifier = "ModelRenderer";
 c3d::ModelRenderer::ModelRenderer(Entity& entity):
 	Component(entity)
 {
+	_renderProxyUpdateConnection = _changed.connect(
+		[this]()
+		{
+			updateRenderProxy();
+		}
+	);
+
 	setMaterial("materials/internal/Default Material/Default Material.c3dmaterial");
 	setMesh("meshes/internal/Default Mesh/Default Mesh.obj");
 }
 
+c3d::ModelRenderer::~ModelRenderer()
+{
+	if (_renderProxy)
+	{
+		getEntity().getScene().getRenderRegistry().removeModel(*_renderProxy);
+	}
+}
+
 void c3d::ModelRenderer::setMaterial(std::optional<std::string_view> path)
 {
 	if (path)
@@ -28,7 +44,15 @@ void c3d::ModelRenderer::setMaterial(std::optional<std::string_view> path)
 		_materialChangedConnection = _material->getChangedSignal().connect(
 			[this]()
 			{
-				_changed();
+				// Renderers read material parameters from the MaterialRegistry, the render proxy only needs an update if the rendered material itself changes
+				if (_renderProxy && getRenderedMaterial() == _renderProxyMaterial)
+				{
+					getEntity().getScene().getChangeTracker().markChanged(SceneChangeFlags::eMaterial);
+				}
+				else
+				{
+					_changed();
+				}
 			}
 		);
 	}
@@ -131,50 +155,6 @@ void c3d::ModelRenderer::deserialize(const ObjectSerialization& serialization)
 	}
 }
 
-void c3d::ModelRenderer::onPreRender(RenderRegistry& renderRegistry, Camera& camera)
-{
-	MaterialAsset* material;
-	if (!_material)
-	{
-		material = MaterialAsset::getMissingMaterial();
-	}
-	else if (!_material->isLoaded())
-	{
-		material = MaterialAsset::getDefaultMaterial();
-	}
-	else
-	{
-		material = _material;
-	}
-
-	MeshAsset* mesh;
-	if (!_mesh)
-	{
-		mesh = MeshAsset::getMissingMesh();
-	}
-	else if (!_mesh->isLoaded())
-	{
-		mesh = MeshAsset::getDefaultMesh();
-	}
-	else
-	{
-		mesh = _mesh;
-	}
-
-	if (material->isLoaded() && mesh->isLoaded())
-	{
-		RenderData data{
-			.transform = getTransform(),
-			.material = *material,
-			.mesh = *mesh,
-			.contributeShadows = getContributeShadows(),
-			.owner = getEntity()
-		};
-
-		renderRegistry.addRenderRequest(data);
-	}
-}
-
 void c3d::ModelRenderer::onDrawUi()
 {
 	std::optional<std::string_view> newMaterialPath;
@@ -319,4 +299,81 @@ void c3d::ModelRenderer::deserializeFromVersion3(const nlohmann::ordered_json& j
 	}
 
 	setContributeShadows(jsonRoot["contribute_shadows"].get<bool>());
+}
+
+c3d::MaterialAsset* c3d::ModelRenderer::getRenderedMaterial() const
+{
+	if (!_material)
+	{
+		return MaterialAsset::getMissingMaterial();
+	}
+	else if (!_material->isLoaded())
+	{
+		return MaterialAsset::getDefaultMaterial();
+	}
+	else
+	{
+		return _material;
+	}
+}
+
+void c3d::ModelRenderer::updateRenderProxy()
+{
+	MaterialAsset* material = getRenderedMaterial();
+
+	MeshAsset* mesh;
+	if (!_mesh)
+	{
+		mesh = MeshAsset::getMissingMesh();
+	}
+	else if (!_mesh->isLoaded())
+	{
+		mesh = MeshAsset::getDefaultMesh();
+	}
+	else
+	{
+		mesh = _mesh;
+	}
+
+	RenderRegistry& renderRegistry = getEntity().getScene().getRenderRegistry();
+
+	// The fallback assets may still be loading, in which case nothing is drawn until they are
+	if (!material->isLoaded() || !mesh->isLoaded())
+	{
+		RuntimeAsset& pendingAsset = !material->isLoaded() ? static_cast<RuntimeAsset&>(*material) : static_cast<RuntimeAsset&>(*mesh);
+		_pendingFallbackConnection = pendingAsset.getChangedSignal().connect(
+			[this]()
+			{
+				updateRenderProxy();
+			}
+		);
+
+		if (_renderProxy)
+		{
+			renderRegistry.removeModel(*_renderProxy);
+			_renderProxy.reset();
+			_renderProxyMaterial = nullptr;
+		}
+
+		return;
+	}
+
+	_pendingFallbackConnection = {};
+
+	RenderData data{
+		.material = material,
+		.mesh = mesh,
+		.contributeShadows = getContributeShadows()
+	};
+
+	if (_renderProxy)
+	{
+		renderRegistry.updateModel(*_renderProxy, data);
+	}
+	else
+	{
+		_renderProxy = renderRegistry.addModel(getEntity(), data);
+	}
+
+	_renderProxyMaterial = material;
 }
\ No newline at end of file
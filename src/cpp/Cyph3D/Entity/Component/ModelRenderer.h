@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Cyph3D/Entity/Component/Component.h>
+#include <Cyph3D/Scene/SceneChangeTracker.h>
 
 #include <nlohmann/json_fwd.hpp>
 #include <optional>
@@ -11,19 +12,20 @@ namespace c3d
 class MaterialAsset;
 class MeshAsset;
 
-class ModelRenderer : public Component
+class ModelRenderer final : public Component
 {
 public:
 	struct RenderData
 	{
-		Transform& transform;
-		MaterialAsset& material;
-		MeshAsset& mesh;
+		MaterialAsset* material;
+		MeshAsset* mesh;
 		bool contributeShadows;
-		Entity& owner;
 	};
 
+	static constexpr SceneChangeFlags changeCategory = SceneChangeFlags::eModel;
+
 	explicit ModelRenderer(Entity& entity);
+	~ModelRenderer() override;
 
 	void setMaterial(std::optional<std::string_view> path);
 	MaterialAsset* getMaterial() const;
@@ -34,7 +36,6 @@ public:
 	bool getContributeShadows() const;
 	void setContributeShadows(bool contributeShadows);
 
-	void onPreRender(RenderRegistry& renderRegistry, Camera& camera) override;
 	void onDrawUi() override;
 
 	void duplicate(Entity& targetEntity) const override;
@@ -54,6 +55,15 @@ private:
 
 	bool _contributeShadows = true;
 
+	std::optional<uint32_t> _renderProxy;
+	// Material given to the render proxy, parameter changes of which do not require a proxy update
+	MaterialAsset* _renderProxyMaterial = nullptr;
+	sigslot::scoped_connection _renderProxyUpdateConnection;
+	sigslot::scoped_connection _pendingFallbackConnection;
+
+	MaterialAsset* getRenderedMaterial() const;
+	void updateRenderProxy();
+
 	void deserializeFromVersion1(const nlohmann::ordered_json& jsonRoot);
 	void deserializeFromVersion2(const nlohmann::ordered_json& jsonRoot);
 	void deserializeFromVersion3(const nlohmann::ordered_json& jsonRoot);
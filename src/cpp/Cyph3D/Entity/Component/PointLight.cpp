@@ -5,6 +5,8 @@
 #include <Cyph3D/Rendering/RenderRegistry.h>
 #include <Cyph3D/Scene/Scene.h>
 
+#include <algorithm>
+#include <cmath>
 #include <glm/gtc/integer.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <imgui.h>
@@ -14,19 +16,19 @@ const char* const c3d::PointLight::identifier = "PointLight";
 c3d::PointLight::PointLight(Entity& entity):
 	LightBase(entity)
 {
+	_renderProxyUpdateConnection = _changed.connect(
+		[this]()
+		{
+			updateRenderProxy();
+		}
+	);
+
+	updateRenderProxy();
 }
 
-void c3d::PointLight::onPreRender(RenderRegistry& renderRegistry, Camera& camera)
+c3d::PointLight::~PointLight()
 {
-	RenderData data{
-		.transform = getTransform(),
-		.intensity = getIntensity(),
-		.color = getLinearColor(),
-		.castShadows = getCastShadows(),
-		.shadowMapResolution = getResolution()
-	};
-
-	renderRegistry.addRenderRequest(data);
+	getEntity().getScene().getRenderRegistry().removePointLight(*_renderProxy);
 }
 
 void c3d::PointLight::onDrawUi()
@@ -119,6 +121,13 @@ void c3d::PointLight::setRadius(float value)
 	_changed();
 }
 
+float c3d::PointLight::getRange() const
+{
+	// Attenuation is 1 / (1 + d^2)
+	glm::vec3 color = getLinearColor();
+	return std::sqrt(std::max(getIntensity() * glm::max(color.r, glm::max(color.g, color.b)) / CUTOFF_RADIANCE - 1.0f, 0.0f));
+}
+
 void c3d::PointLight::duplicate(Entity& targetEntity) const
 {
 	PointLight& newComponent = targetEntity.addComponent<PointLight>();
@@ -160,6 +169,27 @@ void c3d::PointLight::deserialize(const ObjectSerialization& serialization)
 	}
 }
 
+void c3d::PointLight::updateRenderProxy()
+{
+	RenderData data{
+		.intensity = getIntensity(),
+		.color = getLinearColor(),
+		.castShadows = getCastShadows(),
+		.shadowMapResolution = getResolution(),
+		.range = getRange()
+	};
+
+	RenderRegistry& renderRegistry = getEntity().getScene().getRenderRegistry();
+	if (_renderProxy)
+	{
+		renderRegistry.updatePointLight(*_renderProxy, data);
+	}
+	else
+	{
+		_renderProxy = renderRegistry.addPointLight(getEntity(), data);
+	}
+}
+
 void c3d::PointLight::deserializeFromVersion1(const nlohmann::ordered_json& jsonRoot)
 {
 	setSrgbColor(glm::make_vec3(jsonRoot["color"].get<std::vector<float>>().data()));
@@ -3,24 +3,29 @@
 #include <Cyph3D/Entity/Component/LightBase.h>
 
 #include <nlohmann/json_fwd.hpp>
+#include <optional>
 
 namespace c3d
 {
-class PointLight : public LightBase
+class PointLight final : public LightBase
 {
 public:
 	struct RenderData
 	{
-		Transform& transform;
 		float intensity;
 		glm::vec3 color;
 		bool castShadows;
 		uint32_t shadowMapResolution;
+		// See getRange()
+		float range;
 	};
 
+	// Radiance below which a point light is considered to have no effect
+	static constexpr float CUTOFF_RADIANCE = 0.01f;
+
 	explicit PointLight(Entity& entity);
+	~PointLight() override;
 
-	void onPreRender(RenderRegistry& renderRegistry, Camera& camera) override;
 	void onDrawUi() override;
 
 	static const char* const identifier;
@@ -35,6 +40,9 @@ public:
 	float getRadius() const;
 	void setRadius(float value);
 
+	// Distance at which the light's radiance falls below CUTOFF_RADIANCE, the rasterizer ignores the light beyond it
+	float getRange() const;
+
 	void duplicate(Entity& targetEntity) const override;
 
 	ObjectSerialization serialize() const override;
@@ -46,6 +54,11 @@ private:
 	bool _castShadows = false;
 	uint32_t _resolution = 1024;
 
+	std::optional<uint32_t> _renderProxy;
+	sigslot::scoped_connection _renderProxyUpdateConnection;
+
+	void updateRenderProxy();
+
 	void deserializeFromVersion1(const nlohmann::ordered_json& jsonRoot);
 	void deserializeFromVersion2(const nlohmann::ordered_json& jsonRoot);
 };
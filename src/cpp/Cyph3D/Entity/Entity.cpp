@@ -17,14 +17,15 @@
 
 std::map<std::string, std::function<c3d::Component&(c3d::Entity&)>> c3d::Entity::_componentFactories;
 
-c3d::Entity::Entity(Transform& parent, Scene& scene):
+c3d::Entity::Entity(Transform& parent, Scene& scene, EntityId id):
 	_scene(scene),
+	_id(id),
 	_transform(this, &parent)
 {
 	_transformChangedConnection = _transform.getChangedSignal().connect(
 		[this]()
 		{
-			_changed();
+			notifyChanged(SceneChangeFlags::eTransform);
 		}
 	);
 }
@@ -53,7 +54,7 @@ c3d::ComponentIterator c3d::Entity::removeComponent(ComponentIterator where)
 {
 	ComponentIterator newIt = ComponentIterator(_components.erase(where.getUnderlyingIterator()));
 
-	_changed();
+	notifyChanged(SceneChangeFlags::eHierarchy);
 
 	return newIt;
 }
@@ -73,20 +74,9 @@ c3d::Scene& c3d::Entity::getScene() const
 	return _scene;
 }
 
-void c3d::Entity::onUpdate()
+c3d::EntityId c3d::Entity::getId() const
 {
-	for (Component& component : *this)
-	{
-		component.onUpdate();
-	}
-}
-
-void c3d::Entity::onPreRender(RenderRegistry& renderRegistry, Camera& camera)
-{
-	for (Component& component : *this)
-	{
-		component.onPreRender(renderRegistry, camera);
-	}
+	return _id;
 }
 
 c3d::ObjectSerialization c3d::Entity::serialize() const
@@ -134,13 +124,23 @@ void c3d::Entity::deserialize(const ObjectSerialization& entitySerialization)
 
 	for (const nlohmann::ordered_json& json : entitySerialization.data["components"])
 	{
-		ObjectSerialization componentSerialization = ObjectSerialization::fromJson(json);
-
-		Component& component = addComponentByIdentifier(componentSerialization.identifier);
-		component.deserialize(componentSerialization);
+		deserializeComponent(ObjectSerialization::fromJson(json));
 	}
 }
 
+void c3d::Entity::deserializeComponent(const ObjectSerialization& componentSerialization)
+{
+	Component& component = addComponentByIdentifier(componentSerialization.identifier);
+	component.deserialize(componentSerialization);
+}
+
+void c3d::Entity::notifyChanged(SceneChangeFlags category)
+{
+	_scene.getChangeTracker().markChanged(category);
+
+	_changed();
+}
+
 sigslot::signal<>& c3d::Entity::getChangedSignal()
 {
 	return _changed;
@@ -155,7 +155,7 @@ void c3d::Entity::setName(const std::string& name)
 {
 	_name = name;
 
-	_changed();
+	notifyChanged(SceneChangeFlags::eOther);
 }
 
 void c3d::Entity::onDrawUi()
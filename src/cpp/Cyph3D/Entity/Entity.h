@@ -1,6 +1,9 @@
 #pragma once
 
 #include <Cyph3D/Entity/Component/Component.h>
+#include <Cyph3D/Entity/Component/ComponentPool.h>
+#include <Cyph3D/Entity/EntityId.h>
+#include <Cyph3D/Scene/SceneChangeTracker.h>
 #include <Cyph3D/Scene/Transform.h>
 #include <Cyph3D/UI/IInspectable.h>
 
@@ -12,18 +15,16 @@
 
 namespace c3d
 {
-class Scene;
 class Component;
+class Scene;
 class ComponentIterator;
 class ComponentConstIterator;
-class RenderRegistry;
-class Camera;
 struct ObjectSerialization;
 
 class Entity : public IInspectable
 {
 public:
-	Entity(Transform& parent, Scene& scene);
+	Entity(Transform& parent, Scene& scene, EntityId id);
 
 	Entity(const Entity& other) = delete;
 	Entity& operator=(const Entity& other) = delete;
@@ -36,22 +37,9 @@ public:
 	ComponentConstIterator begin() const;
 	ComponentConstIterator end() const;
 
+	// Defined in Scene.h as it takes the component from the scene's pool
 	template<typename T>
-	T& addComponent()
-	{
-		ComponentContainer& container = _components.emplace_back();
-		container.component = std::make_unique<T>(*this);
-		container.componentChangedConnection = container.component->getChangedSignal().connect(
-			[this]()
-			{
-				_changed();
-			}
-		);
-
-		_changed();
-
-		return *static_cast<T*>(container.component.get());
-	}
+	T& addComponent();
 
 	ComponentIterator removeComponent(ComponentIterator where);
 
@@ -62,15 +50,15 @@ public:
 	void setName(const std::string& name);
 
 	void onDrawUi() override;
-	void onUpdate();
-	void onPreRender(RenderRegistry& renderRegistry, Camera& camera);
 
 	Scene& getScene() const;
+	EntityId getId() const;
 
 	void duplicate(Transform& parent) const;
 
 	ObjectSerialization serialize() const;
 	void deserialize(const ObjectSerialization& entitySerialization);
+	void deserializeComponent(const ObjectSerialization& componentSerialization);
 
 	sigslot::signal<>& getChangedSignal();
 
@@ -80,20 +68,26 @@ public:
 private:
 	struct ComponentContainer
 	{
-		std::unique_ptr<Component> component;
+		std::unique_ptr<Component, ComponentDeleter> component;
 		sigslot::scoped_connection componentChangedConnection;
 	};
 
 	std::string _name = "New Entity";
-	std::vector<ComponentContainer> _components;
 	Scene& _scene;
+	EntityId _id;
 	Transform _transform;
 	sigslot::scoped_connection _transformChangedConnection;
 
 	sigslot::signal<> _changed;
 
+	// Declared last so that components are destroyed while the rest of the entity is still alive
+	std::vector<ComponentContainer> _components;
+
 	Component& addComponentByIdentifier(const std::string& identifier);
 
+	// Records the change in the scene's change tracker and emits the changed signal
+	void notifyChanged(SceneChangeFlags category);
+
 	static std::map<std::string, std::function<Component&(Entity&)>> _componentFactories;
 	static void initComponentFactories();
 
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+
+namespace c3d
+{
+// Stable handle to an entity of a scene.
+// The generation is bumped every time a slot is freed, so a handle to a removed entity never resolves to the entity that reuses its slot.
+struct EntityId
+{
+	uint32_t index = UINT32_MAX;
+	uint32_t generation = 0;
+
+	bool operator==(const EntityId& other) const = default;
+};
+}
\ No newline at end of file
@@ -0,0 +1,267 @@
+#include "AffineMathHelper.h"
+
+#include <glm/gtc/matrix_inverse.hpp>
+#include <glm/gtx/quaternion.hpp>
+#include <glm/gtx/transform.hpp>
+#include <tuple>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	define C3D_AFFINE_MATH_SSE
+#	include <immintrin.h>
+#endif
+
+#if defined(C3D_AFFINE_MATH_SSE)
+namespace
+{
+__m128 load(const glm::vec4& vector)
+{
+	return _mm_loadu_ps(&vector.x);
+}
+
+__m128 load(const glm::vec3& vector)
+{
+	return _mm_set_ps(0.0f, vector.z, vector.y, vector.x);
+}
+
+void store(glm::vec4& destination, __m128 value)
+{
+	_mm_storeu_ps(&destination.x, value);
+}
+
+void store(glm::vec3& destination, __m128 value)
+{
+	alignas(16) float result[4];
+	_mm_store_ps(result, value);
+	destination = glm::vec3(result[0], result[1], result[2]);
+}
+
+// Clears the w component of a column so that it does not leak into 3D products
+__m128 maskXYZ(__m128 value)
+{
+	return _mm_and_ps(value, _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1)));
+}
+
+__m128 abs(__m128 value)
+{
+	return _mm_andnot_ps(_mm_set1_ps(-0.0f), value);
+}
+
+__m128 madd(__m128 a, __m128 b, __m128 c)
+{
+#if defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__))
+	return _mm_fmadd_ps(a, b, c);
+#else
+	return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+}
+
+template<int I>
+__m128 splat(__m128 value)
+{
+	return _mm_shuffle_ps(value, value, _MM_SHUFFLE(I, I, I, I));
+}
+
+__m128 cross(__m128 a, __m128 b)
+{
+	__m128 aYZX = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+	__m128 bYZX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+	__m128 result = _mm_sub_ps(_mm_mul_ps(a, bYZX), _mm_mul_ps(aYZX, b));
+	return _mm_shuffle_ps(result, result, _MM_SHUFFLE(3, 0, 2, 1));
+}
+
+// Returns the dot product of the xyz components in every lane
+__m128 dot3(__m128 a, __m128 b)
+{
+	__m128 product = _mm_mul_ps(a, b);
+	__m128 sum = _mm_add_ps(product, _mm_shuffle_ps(product, product, _MM_SHUFFLE(0, 0, 0, 1)));
+	sum = _mm_add_ss(sum, _mm_shuffle_ps(product, product, _MM_SHUFFLE(0, 0, 0, 2)));
+	return splat<0>(sum);
+}
+
+// Computes the rows of the inverse of the upper 3x3 part of the matrix formed by the columns a, b and c
+void inverse3x3Rows(__m128 a, __m128 b, __m128 c, __m128& row0, __m128& row1, __m128& row2)
+{
+	row0 = cross(b, c);
+	row1 = cross(c, a);
+	row2 = cross(a, b);
+
+	__m128 inverseDeterminant = _mm_div_ps(_mm_set1_ps(1.0f), dot3(a, row0));
+
+	row0 = _mm_mul_ps(row0, inverseDeterminant);
+	row1 = _mm_mul_ps(row1, inverseDeterminant);
+	row2 = _mm_mul_ps(row2, inverseDeterminant);
+}
+}
+#endif
+
+glm::mat4 c3d::AffineMathHelper::compose(glm::vec3 position, glm::quat rotation, glm::vec3 scale)
+{
+#if defined(C3D_AFFINE_MATH_SSE)
+	float xx = rotation.x * rotation.x;
+	float yy = rotation.y * rotation.y;
+	float zz = rotation.z * rotation.z;
+	float xy = rotation.x * rotation.y;
+	float xz = rotation.x * rotation.z;
+	float yz = rotation.y * rotation.z;
+	float wx = rotation.w * rotation.x;
+	float wy = rotation.w * rotation.y;
+	float wz = rotation.w * rotation.z;
+
+	__m128 column0 = _mm_set_ps(0.0f, xz - wy, xy + wz, 0.5f - (yy + zz));
+	__m128 column1 = _mm_set_ps(0.0f, yz + wx, 0.5f - (xx + zz), xy - wz);
+	__m128 column2 = _mm_set_ps(0.0f, 0.5f - (xx + yy), yz - wx, xz + wy);
+
+	// The rotation terms above are halved, the factor 2 is folded into the scale
+	__m128 scale2 = _mm_mul_ps(load(scale), _mm_set1_ps(2.0f));
+
+	glm::mat4 result;
+	store(result[0], _mm_mul_ps(column0, splat<0>(scale2)));
+	store(result[1], _mm_mul_ps(column1, splat<1>(scale2)));
+	store(result[2], _mm_mul_ps(column2, splat<2>(scale2)));
+	store(result[3], _mm_set_ps(1.0f, position.z, position.y, position.x));
+	return result;
+#else
+	return glm::translate(position) * glm::toMat4(rotation) * glm::scale(scale);
+#endif
+}
+
+void c3d::AffineMathHelper::compose(std::span<const glm::vec3> positions, std::span<const glm::quat> rotations, std::span<const glm::vec3> scales, std::span<glm::mat4> results)
+{
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		results[i] = compose(positions[i], rotations[i], scales[i]);
+	}
+}
+
+glm::mat4 c3d::AffineMathHelper::multiply(const glm::mat4& a, const glm::mat4& b)
+{
+#if defined(C3D_AFFINE_MATH_SSE)
+	__m128 a0 = load(a[0]);
+	__m128 a1 = load(a[1]);
+	__m128 a2 = load(a[2]);
+	__m128 a3 = load(a[3]);
+
+	glm::mat4 result;
+	for (int i = 0; i < 4; i++)
+	{
+		__m128 column = load(b[i]);
+
+		__m128 value = _mm_mul_ps(a0, splat<0>(column));
+		value = madd(a1, splat<1>(column), value);
+		value = madd(a2, splat<2>(column), value);
+
+		// Only the translation column of an affine matrix has a non-zero w
+		if (i == 3)
+		{
+			value = _mm_add_ps(value, a3);
+		}
+
+		store(result[i], value);
+	}
+	return result;
+#else
+	return a * b;
+#endif
+}
+
+glm::mat4 c3d::AffineMathHelper::inverse(const glm::mat4& matrix)
+{
+#if defined(C3D_AFFINE_MATH_SSE)
+	__m128 row0;
+	__m128 row1;
+	__m128 row2;
+	__m128 row3 = _mm_setzero_ps();
+	inverse3x3Rows(maskXYZ(load(matrix[0])), maskXYZ(load(matrix[1])), maskXYZ(load(matrix[2])), row0, row1, row2);
+
+	_MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+	__m128 translation = maskXYZ(load(matrix[3]));
+	__m128 inverseTranslation = _mm_mul_ps(row0, splat<0>(translation));
+	inverseTranslation = madd(row1, splat<1>(translation), inverseTranslation);
+	inverseTranslation = madd(row2, splat<2>(translation), inverseTranslation);
+	inverseTranslation = _mm_sub_ps(_mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f), inverseTranslation);
+
+	glm::mat4 result;
+	store(result[0], row0);
+	store(result[1], row1);
+	store(result[2], row2);
+	store(result[3], inverseTranslation);
+	return result;
+#else
+	return glm::affineInverse(matrix);
+#endif
+}
+
+glm::mat3 c3d::AffineMathHelper::normalMatrix(const glm::mat4& matrix)
+{
+#if defined(C3D_AFFINE_MATH_SSE)
+	__m128 row0;
+	__m128 row1;
+	__m128 row2;
+	inverse3x3Rows(maskXYZ(load(matrix[0])), maskXYZ(load(matrix[1])), maskXYZ(load(matrix[2])), row0, row1, row2);
+
+	// The rows of the inverse are the columns of the inverse transpose
+	glm::mat3 result;
+	store(result[0], row0);
+	store(result[1], row1);
+	store(result[2], row2);
+	return result;
+#else
+	return glm::inverseTranspose(glm::mat3(matrix));
+#endif
+}
+
+void c3d::AffineMathHelper::normalMatrix(std::span<const glm::mat4> matrices, std::span<glm::mat3> results)
+{
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		results[i] = normalMatrix(matrices[i]);
+	}
+}
+
+std::pair<glm::vec3, glm::vec3> c3d::AffineMathHelper::transformBoundingBox(const glm::mat4& matrix, glm::vec3 boundingBoxMin, glm::vec3 boundingBoxMax)
+{
+#if defined(C3D_AFFINE_MATH_SSE)
+	__m128 min = load(boundingBoxMin);
+	__m128 max = load(boundingBoxMax);
+
+	__m128 half = _mm_set1_ps(0.5f);
+	__m128 center = _mm_mul_ps(_mm_add_ps(min, max), half);
+	__m128 extent = _mm_mul_ps(_mm_sub_ps(max, min), half);
+
+	__m128 column0 = maskXYZ(load(matrix[0]));
+	__m128 column1 = maskXYZ(load(matrix[1]));
+	__m128 column2 = maskXYZ(load(matrix[2]));
+
+	__m128 newCenter = madd(column0, splat<0>(center), maskXYZ(load(matrix[3])));
+	newCenter = madd(column1, splat<1>(center), newCenter);
+	newCenter = madd(column2, splat<2>(center), newCenter);
+
+	__m128 newExtent = _mm_mul_ps(abs(column0), splat<0>(extent));
+	newExtent = madd(abs(column1), splat<1>(extent), newExtent);
+	newExtent = madd(abs(column2), splat<2>(extent), newExtent);
+
+	std::pair<glm::vec3, glm::vec3> result;
+	store(result.first, _mm_sub_ps(newCenter, newExtent));
+	store(result.second, _mm_add_ps(newCenter, newExtent));
+	return result;
+#else
+	glm::vec3 center = (boundingBoxMin + boundingBoxMax) * 0.5f;
+	glm::vec3 extent = (boundingBoxMax - boundingBoxMin) * 0.5f;
+
+	glm::vec3 newCenter = glm::vec3(matrix * glm::vec4(center, 1));
+	glm::vec3 newExtent = glm::abs(glm::mat3(matrix)[0]) * extent.x +
+	                      glm::abs(glm::mat3(matrix)[1]) * extent.y +
+	                      glm::abs(glm::mat3(matrix)[2]) * extent.z;
+
+	return {newCenter - newExtent, newCenter + newExtent};
+#endif
+}
+
+void c3d::AffineMathHelper::transformBoundingBox(std::span<const glm::mat4> matrices, std::span<const glm::vec3> boundingBoxMins, std::span<const glm::vec3> boundingBoxMaxs, std::span<glm::vec3> resultMins, std::span<glm::vec3> resultMaxs)
+{
+	for (size_t i = 0; i < matrices.size(); i++)
+	{
+		std::tie(resultMins[i], resultMaxs[i]) = transformBoundingBox(matrices[i], boundingBoxMins[i], boundingBoxMaxs[i]);
+	}
+}
\ No newline at end of file
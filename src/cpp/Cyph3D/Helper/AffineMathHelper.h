@@ -0,0 +1,33 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <span>
+#include <utility>
+
+namespace c3d
+{
+// Kernels for affine matrices stored as glm::mat4 whose last row is (0, 0, 0, 1).
+// They only touch the upper 3x4 part, use SSE (and FMA when available) and fall back to scalar code on other architectures.
+class AffineMathHelper
+{
+public:
+	// Equivalent to glm::translate(position) * glm::toMat4(rotation) * glm::scale(scale)
+	static glm::mat4 compose(glm::vec3 position, glm::quat rotation, glm::vec3 scale);
+	static void compose(std::span<const glm::vec3> positions, std::span<const glm::quat> rotations, std::span<const glm::vec3> scales, std::span<glm::mat4> results);
+
+	static glm::mat4 multiply(const glm::mat4& a, const glm::mat4& b);
+
+	// Equivalent to glm::affineInverse(matrix)
+	static glm::mat4 inverse(const glm::mat4& matrix);
+
+	// Equivalent to glm::inverseTranspose(glm::mat3(matrix))
+	static glm::mat3 normalMatrix(const glm::mat4& matrix);
+	static void normalMatrix(std::span<const glm::mat4> matrices, std::span<glm::mat3> results);
+
+	// Arvo's method: transforms the box center and accumulates the absolute value of the linear part into the extent,
+	// giving the same result as transforming the 8 corners for a fraction of the cost
+	static std::pair<glm::vec3, glm::vec3> transformBoundingBox(const glm::mat4& matrix, glm::vec3 boundingBoxMin, glm::vec3 boundingBoxMax);
+	static void transformBoundingBox(std::span<const glm::mat4> matrices, std::span<const glm::vec3> boundingBoxMins, std::span<const glm::vec3> boundingBoxMaxs, std::span<glm::vec3> resultMins, std::span<glm::vec3> resultMaxs);
+};
+}
\ No newline at end of file
@@ -1,7 +1,7 @@
 #include "MathHelper.h"
 
-#include <array>
 #include <glm/glm.hpp>
+#include <limits>
 
 bool c3d::MathHelper::between(int64_t number, int64_t lower, int64_t upper)
 {
@@ -13,33 +13,6 @@ float c3d::MathHelper::fovXtoY(float fovx, float aspect)
 	return 2.0f * glm::atan(glm::tan(glm::radians(fovx) * 0.5f) / aspect);
 }
 
-std::pair<glm::vec3, glm::vec3> c3d::MathHelper::transformBoundingBox(const glm::mat4& matrix, const glm::vec3& boundingBoxMin, const glm::vec3& boundingBoxMax)
-{
-	std::array<glm::vec3, 8> boundingBoxVertices = {
-		glm::vec3(boundingBoxMin.x, boundingBoxMin.y, boundingBoxMin.z),
-		glm::vec3(boundingBoxMin.x, boundingBoxMin.y, boundingBoxMax.z),
-		glm::vec3(boundingBoxMin.x, boundingBoxMax.y, boundingBoxMin.z),
-		glm::vec3(boundingBoxMin.x, boundingBoxMax.y, boundingBoxMax.z),
-		glm::vec3(boundingBoxMax.x, boundingBoxMin.y, boundingBoxMin.z),
-		glm::vec3(boundingBoxMax.x, boundingBoxMin.y, boundingBoxMax.z),
-		glm::vec3(boundingBoxMax.x, boundingBoxMax.y, boundingBoxMin.z),
-		glm::vec3(boundingBoxMax.x, boundingBoxMax.y, boundingBoxMax.z)
-	};
-
-	glm::vec3 min(std::numeric_limits<float>::max());
-	glm::vec3 max(std::numeric_limits<float>::lowest());
-
-	for (const glm::vec3& vertex : boundingBoxVertices)
-	{
-		glm::vec3 transformedVertex = glm::vec3(matrix * glm::vec4(vertex, 1));
-
-		min = glm::min(min, transformedVertex);
-		max = glm::max(max, transformedVertex);
-	}
-
-	return {min, max};
-}
-
 glm::vec3 c3d::MathHelper::srgbToLinear(glm::vec3 color)
 {
 	glm::bvec3 cutoff = lessThan(color, glm::vec3(0.04045f));
@@ -56,4 +29,53 @@ glm::vec3 c3d::MathHelper::linearToSrgb(glm::vec3 color)
 	glm::vec3 lower = color * glm::vec3(12.92f);
 
 	return glm::mix(higher, lower, cutoff);
+}
+
+std::array<glm::vec4, 6> c3d::MathHelper::extractFrustumPlanes(const glm::mat4& viewProjection)
+{
+	glm::mat4 rows = glm::transpose(viewProjection);
+
+	std::array<glm::vec4, 6> planes = {
+		rows[3] + rows[0],
+		rows[3] - rows[0],
+		rows[3] + rows[1],
+		rows[3] - rows[1],
+		rows[2],
+		rows[3] - rows[2]
+	};
+
+	for (glm::vec4& plane : planes)
+	{
+		plane /= glm::length(glm::vec3(plane));
+	}
+
+	return planes;
+}
+
+bool c3d::MathHelper::isBoundingBoxInFrustum(const std::array<glm::vec4, 6>& frustumPlanes, glm::vec3 boundingBoxMin, glm::vec3 boundingBoxMax)
+{
+	for (const glm::vec4& plane : frustumPlanes)
+	{
+		// Corner of the box the furthest along the plane normal
+		glm::vec3 corner = glm::mix(boundingBoxMin, boundingBoxMax, glm::greaterThanEqual(glm::vec3(plane), glm::vec3(0)));
+		if (glm::dot(glm::vec3(plane), corner) + plane.w < 0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+float c3d::MathHelper::rayBoundingBoxDistance(glm::vec3 origin, glm::vec3 inverseDirection, glm::vec3 boundingBoxMin, glm::vec3 boundingBoxMax)
+{
+	glm::vec3 t0 = (boundingBoxMin - origin) * inverseDirection;
+	glm::vec3 t1 = (boundingBoxMax - origin) * inverseDirection;
+	glm::vec3 tMin = glm::min(t0, t1);
+	glm::vec3 tMax = glm::max(t0, t1);
+
+	float entry = glm::max(glm::max(tMin.x, tMin.y), glm::max(tMin.z, 0.0f));
+	float exit = glm::min(glm::min(tMax.x, tMax.y), tMax.z);
+
+	return entry <= exit ? entry : std::numeric_limits<float>::infinity();
 }
\ No newline at end of file
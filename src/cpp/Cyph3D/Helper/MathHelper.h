@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <glm/glm.hpp>
 
@@ -10,9 +11,16 @@ class MathHelper
 public:
 	static bool between(int64_t number, int64_t lower, int64_t upper);
 	static float fovXtoY(float fovx, float aspect);
-	static std::pair<glm::vec3, glm::vec3> transformBoundingBox(const glm::mat4& matrix, const glm::vec3& boundingBoxMin, const glm::vec3& boundingBoxMax);
 
 	static glm::vec3 srgbToLinear(glm::vec3 color);
 	static glm::vec3 linearToSrgb(glm::vec3 color);
+
+	// Returns the left, right, bottom, top, near and far planes as (normal, distance) with normals pointing inside, for a [0, 1] depth range
+	static std::array<glm::vec4, 6> extractFrustumPlanes(const glm::mat4& viewProjection);
+	// Conservative: boxes close to the frustum corners may pass while being outside of it
+	static bool isBoundingBoxInFrustum(const std::array<glm::vec4, 6>& frustumPlanes, glm::vec3 boundingBoxMin, glm::vec3 boundingBoxMax);
+
+	// Returns the distance along the ray at which it enters the box, or infinity if it misses it
+	static float rayBoundingBoxDistance(glm::vec3 origin, glm::vec3 inverseDirection, glm::vec3 boundingBoxMin, glm::vec3 boundingBoxMax);
 };
 }
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include "MappedFile.h"
+
+#include <format>
+#include <system_error>
+
+#if defined(_WIN32)
+#	define WIN32_LEAN_AND_MEAN
+#	define NOMINMAX
+#	include <windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+c3d::MappedFile::MappedFile(const std::filesystem::path& path)
+{
+	_fileHandle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (_fileHandle == INVALID_HANDLE_VALUE)
+	{
+		_fileHandle = nullptr;
+		throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), std::format("Cannot open \"{}\" for reading", path.generic_string()));
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(_fileHandle, &fileSize))
+	{
+		DWORD error = GetLastError();
+		CloseHandle(_fileHandle);
+		throw std::system_error(static_cast<int>(error), std::system_category(), std::format("Cannot query the size of \"{}\"", path.generic_string()));
+	}
+	_size = static_cast<size_t>(fileSize.QuadPart);
+
+	// mapping an empty file is an error on Windows
+	if (_size == 0)
+	{
+		return;
+	}
+
+	_mappingHandle = CreateFileMappingW(_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (_mappingHandle == nullptr)
+	{
+		DWORD error = GetLastError();
+		CloseHandle(_fileHandle);
+		throw std::system_error(static_cast<int>(error), std::system_category(), std::format("Cannot map \"{}\"", path.generic_string()));
+	}
+
+	_data = static_cast<const std::byte*>(MapViewOfFile(_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+	if (_data == nullptr)
+	{
+		DWORD error = GetLastError();
+		CloseHandle(_mappingHandle);
+		CloseHandle(_fileHandle);
+		throw std::system_error(static_cast<int>(error), std::system_category(), std::format("Cannot map \"{}\"", path.generic_string()));
+	}
+}
+
+c3d::MappedFile::~MappedFile()
+{
+	if (_data != nullptr)
+	{
+		UnmapViewOfFile(_data);
+	}
+
+	if (_mappingHandle != nullptr)
+	{
+		CloseHandle(_mappingHandle);
+	}
+
+	if (_fileHandle != nullptr)
+	{
+		CloseHandle(_fileHandle);
+	}
+}
+#else
+c3d::MappedFile::MappedFile(const std::filesystem::path& path)
+{
+	_fileDescriptor = open(path.c_str(), O_RDONLY);
+	if (_fileDescriptor == -1)
+	{
+		throw std::system_error(errno, std::system_category(), std::format("Cannot open \"{}\" for reading", path.generic_string()));
+	}
+
+	struct stat fileStat;
+	if (fstat(_fileDescriptor, &fileStat) == -1)
+	{
+		int error = errno;
+		close(_fileDescriptor);
+		throw std::system_error(error, std::system_category(), std::format("Cannot query the size of \"{}\"", path.generic_string()));
+	}
+	_size = static_cast<size_t>(fileStat.st_size);
+
+	// mmap rejects zero-sized mappings
+	if (_size == 0)
+	{
+		return;
+	}
+
+	void* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _fileDescriptor, 0);
+	if (data == MAP_FAILED)
+	{
+		int error = errno;
+		close(_fileDescriptor);
+		throw std::system_error(error, std::system_category(), std::format("Cannot map \"{}\"", path.generic_string()));
+	}
+
+	// the file is read front to back
+	madvise(data, _size, MADV_SEQUENTIAL);
+
+	_data = static_cast<const std::byte*>(data);
+}
+
+c3d::MappedFile::~MappedFile()
+{
+	if (_data != nullptr)
+	{
+		munmap(const_cast<std::byte*>(_data), _size);
+	}
+
+	if (_fileDescriptor != -1)
+	{
+		close(_fileDescriptor);
+	}
+}
+#endif
+
+std::span<const std::byte> c3d::MappedFile::getData() const
+{
+	return {_data, _size};
+}
\ No newline at end of file
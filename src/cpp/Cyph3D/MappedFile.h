@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace c3d
+{
+class MappedFile
+{
+public:
+	explicit MappedFile(const std::filesystem::path& path);
+	~MappedFile();
+
+	MappedFile(const MappedFile& other) = delete;
+	MappedFile& operator=(const MappedFile& other) = delete;
+
+	MappedFile(MappedFile&& other) = delete;
+	MappedFile& operator=(MappedFile&& other) = delete;
+
+	std::span<const std::byte> getData() const;
+
+private:
+	const std::byte* _data = nullptr;
+	size_t _size = 0;
+
+#if defined(_WIN32)
+	void* _fileHandle = nullptr;
+	void* _mappingHandle = nullptr;
+#else
+	int _fileDescriptor = -1;
+#endif
+};
+}
\ No newline at end of file
@@ -16,4 +16,13 @@ c3d::ObjectSerialization c3d::ObjectSerialization::fromJson(const nlohmann::orde
 	result.data = json["data"];
 	result.identifier = json["identifier"].get<std::string>();
 	return result;
+}
+
+c3d::ObjectSerialization c3d::ObjectSerialization::fromJson(nlohmann::ordered_json&& json)
+{
+	ObjectSerialization result;
+	result.version = json["version"].get<int>();
+	result.data = std::move(json["data"]);
+	result.identifier = json["identifier"].get<std::string>();
+	return result;
 }
\ No newline at end of file
@@ -12,5 +12,6 @@ struct ObjectSerialization
 
 	nlohmann::ordered_json toJson();
 	static ObjectSerialization fromJson(const nlohmann::ordered_json& json);
+	static ObjectSerialization fromJson(nlohmann::ordered_json&& json);
 };
 }
\ No newline at end of file
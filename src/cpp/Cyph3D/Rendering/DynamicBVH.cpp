@@ -0,0 +1,322 @@
+#include "DynamicBVH.h"
+
+#include <algorithm>
+
+uint32_t c3d::DynamicBVH::insert(glm::vec3 boundingBoxMin, glm::vec3 boundingBoxMax, uint32_t userData)
+{
+	uint32_t leaf = allocateNode();
+
+	glm::vec3 margin = (boundingBoxMax - boundingBoxMin) * FAT_MARGIN_RATIO + FAT_MARGIN_MIN;
+
+	Node& node = _nodes[leaf];
+	node.boundingBoxMin = boundingBoxMin - margin;
+	node.boundingBoxMax = boundingBoxMax + margin;
+	node.userData = userData;
+	node.height = 0;
+
+	insertLeaf(leaf);
+	_leafCount++;
+
+	return leaf;
+}
+
+void c3d::DynamicBVH::remove(uint32_t leaf)
+{
+	removeLeaf(leaf);
+	freeNode(leaf);
+	_leafCount--;
+}
+
+bool c3d::DynamicBVH::move(uint32_t leaf, glm::vec3 boundingBoxMin, glm::vec3 boundingBoxMax)
+{
+	Node& node = _nodes[leaf];
+
+	glm::vec3 margin = (boundingBoxMax - boundingBoxMin) * FAT_MARGIN_RATIO + FAT_MARGIN_MIN;
+	glm::vec3 fatMin = boundingBoxMin - margin;
+	glm::vec3 fatMax = boundingBoxMax + margin;
+
+	bool contained = glm::all(glm::lessThanEqual(node.boundingBoxMin, boundingBoxMin)) && glm::all(glm::greaterThanEqual(node.boundingBoxMax, boundingBoxMax));
+	// An object that shrank a lot would otherwise keep a box much larger than itself
+	bool tooLarge = surfaceArea(node.boundingBoxMin, node.boundingBoxMax) > 4.0f * surfaceArea(fatMin, fatMax);
+	if (contained && !tooLarge)
+	{
+		return false;
+	}
+
+	removeLeaf(leaf);
+
+	node.boundingBoxMin = fatMin;
+	node.boundingBoxMax = fatMax;
+
+	insertLeaf(leaf);
+
+	return true;
+}
+
+uint32_t c3d::DynamicBVH::getUserData(uint32_t leaf) const
+{
+	return _nodes[leaf].userData;
+}
+
+uint32_t c3d::DynamicBVH::getLeafCount() const
+{
+	return _leafCount;
+}
+
+uint32_t c3d::DynamicBVH::getNodeCount() const
+{
+	return _leafCount > 0 ? _leafCount * 2 - 1 : 0;
+}
+
+uint32_t c3d::DynamicBVH::getHeight() const
+{
+	return _root != NULL_NODE ? _nodes[_root].height + 1 : 0;
+}
+
+float c3d::DynamicBVH::getAreaRatio() const
+{
+	if (_root == NULL_NODE)
+	{
+		return 0;
+	}
+
+	float totalArea = 0;
+	for (const Node& node : _nodes)
+	{
+		if (node.height > 0)
+		{
+			totalArea += surfaceArea(node.boundingBoxMin, node.boundingBoxMax);
+		}
+	}
+
+	return totalArea / surfaceArea(_nodes[_root].boundingBoxMin, _nodes[_root].boundingBoxMax);
+}
+
+uint32_t c3d::DynamicBVH::allocateNode()
+{
+	uint32_t index;
+	if (_freeList != NULL_NODE)
+	{
+		index = _freeList;
+		_freeList = _nodes[index].parent;
+	}
+	else
+	{
+		index = _nodes.size();
+		_nodes.emplace_back();
+	}
+
+	Node& node = _nodes[index];
+	node.parent = NULL_NODE;
+	node.children = {NULL_NODE, NULL_NODE};
+	node.userData = 0;
+	node.height = 0;
+
+	return index;
+}
+
+void c3d::DynamicBVH::freeNode(uint32_t index)
+{
+	_nodes[index].parent = _freeList;
+	_nodes[index].height = -1;
+	_freeList = index;
+}
+
+void c3d::DynamicBVH::insertLeaf(uint32_t leaf)
+{
+	if (_root == NULL_NODE)
+	{
+		_root = leaf;
+		_nodes[leaf].parent = NULL_NODE;
+		return;
+	}
+
+	glm::vec3 leafMin = _nodes[leaf].boundingBoxMin;
+	glm::vec3 leafMax = _nodes[leaf].boundingBoxMax;
+
+	// Descend towards the sibling that minimizes the surface area added to the tree
+	uint32_t index = _root;
+	while (!_nodes[index].isLeaf())
+	{
+		const Node& node = _nodes[index];
+
+		float area = surfaceArea(node.boundingBoxMin, node.boundingBoxMax);
+		float combinedArea = surfaceArea(glm::min(node.boundingBoxMin, leafMin), glm::max(node.boundingBoxMax, leafMax));
+
+		// Cost of making the leaf a sibling of this node
+		float cost = 2.0f * combinedArea;
+		// Minimum cost pushed down to the children if the leaf goes further
+		float inheritanceCost = 2.0f * (combinedArea - area);
+
+		std::array<float, 2> childCosts;
+		for (int i = 0; i < 2; i++)
+		{
+			const Node& child = _nodes[node.children[i]];
+			float childCombinedArea = surfaceArea(glm::min(child.boundingBoxMin, leafMin), glm::max(child.boundingBoxMax, leafMax));
+			if (child.isLeaf())
+			{
+				childCosts[i] = childCombinedArea + inheritanceCost;
+			}
+			else
+			{
+				childCosts[i] = childCombinedArea - surfaceArea(child.boundingBoxMin, child.boundingBoxMax) + inheritanceCost;
+			}
+		}
+
+		if (cost < childCosts[0] && cost < childCosts[1])
+		{
+			break;
+		}
+
+		index = childCosts[0] < childCosts[1] ? node.children[0] : node.children[1];
+	}
+
+	uint32_t sibling = index;
+	uint32_t oldParent = _nodes[sibling].parent;
+	uint32_t newParent = allocateNode();
+
+	Node& parentNode = _nodes[newParent];
+	parentNode.parent = oldParent;
+	parentNode.children = {sibling, leaf};
+	parentNode.boundingBoxMin = glm::min(_nodes[sibling].boundingBoxMin, leafMin);
+	parentNode.boundingBoxMax = glm::max(_nodes[sibling].boundingBoxMax, leafMax);
+	parentNode.height = _nodes[sibling].height + 1;
+
+	if (oldParent != NULL_NODE)
+	{
+		std::array<uint32_t, 2>& children = _nodes[oldParent].children;
+		children[children[0] == sibling ? 0 : 1] = newParent;
+	}
+	else
+	{
+		_root = newParent;
+	}
+
+	_nodes[sibling].parent = newParent;
+	_nodes[leaf].parent = newParent;
+
+	refitAncestors(_nodes[leaf].parent);
+}
+
+void c3d::DynamicBVH::removeLeaf(uint32_t leaf)
+{
+	if (leaf == _root)
+	{
+		_root = NULL_NODE;
+		return;
+	}
+
+	uint32_t parent = _nodes[leaf].parent;
+	uint32_t grandParent = _nodes[parent].parent;
+	uint32_t sibling = _nodes[parent].children[_nodes[parent].children[0] == leaf ? 1 : 0];
+
+	freeNode(parent);
+
+	if (grandParent != NULL_NODE)
+	{
+		std::array<uint32_t, 2>& children = _nodes[grandParent].children;
+		children[children[0] == parent ? 0 : 1] = sibling;
+		_nodes[sibling].parent = grandParent;
+
+		refitAncestors(grandParent);
+	}
+	else
+	{
+		_root = sibling;
+		_nodes[sibling].parent = NULL_NODE;
+	}
+}
+
+uint32_t c3d::DynamicBVH::balance(uint32_t index)
+{
+	Node& a = _nodes[index];
+	if (a.isLeaf() || a.height < 2)
+	{
+		return index;
+	}
+
+	uint32_t indexB = a.children[0];
+	uint32_t indexC = a.children[1];
+	Node& b = _nodes[indexB];
+	Node& c = _nodes[indexC];
+
+	int32_t heightDifference = c.height - b.height;
+
+	// Rotates the taller child up, its own taller child staying below it and its shorter one moving under the old root
+	auto rotate = [&](uint32_t indexUp, Node& up, int upSide, const Node& other)
+	{
+		uint32_t indexF = up.children[0];
+		uint32_t indexG = up.children[1];
+		Node& f = _nodes[indexF];
+		Node& g = _nodes[indexG];
+
+		up.children[0] = index;
+		up.parent = a.parent;
+		a.parent = indexUp;
+
+		if (up.parent != NULL_NODE)
+		{
+			std::array<uint32_t, 2>& children = _nodes[up.parent].children;
+			children[children[0] == index ? 0 : 1] = indexUp;
+		}
+		else
+		{
+			_root = indexUp;
+		}
+
+		uint32_t indexKept = f.height > g.height ? indexF : indexG;
+		uint32_t indexMoved = f.height > g.height ? indexG : indexF;
+		const Node& kept = _nodes[indexKept];
+		Node& moved = _nodes[indexMoved];
+
+		up.children[1] = indexKept;
+		a.children[upSide] = indexMoved;
+		moved.parent = index;
+
+		a.boundingBoxMin = glm::min(other.boundingBoxMin, moved.boundingBoxMin);
+		a.boundingBoxMax = glm::max(other.boundingBoxMax, moved.boundingBoxMax);
+		a.height = 1 + std::max(other.height, moved.height);
+
+		up.boundingBoxMin = glm::min(a.boundingBoxMin, kept.boundingBoxMin);
+		up.boundingBoxMax = glm::max(a.boundingBoxMax, kept.boundingBoxMax);
+		up.height = 1 + std::max(a.height, kept.height);
+	};
+
+	if (heightDifference > 1)
+	{
+		rotate(indexC, c, 1, b);
+		return indexC;
+	}
+
+	if (heightDifference < -1)
+	{
+		rotate(indexB, b, 0, c);
+		return indexB;
+	}
+
+	return index;
+}
+
+void c3d::DynamicBVH::refitAncestors(uint32_t index)
+{
+	while (index != NULL_NODE)
+	{
+		index = balance(index);
+
+		Node& node = _nodes[index];
+		const Node& child0 = _nodes[node.children[0]];
+		const Node& child1 = _nodes[node.children[1]];
+
+		node.boundingBoxMin = glm::min(child0.boundingBoxMin, child1.boundingBoxMin);
+		node.boundingBoxMax = glm::max(child0.boundingBoxMax, child1.boundingBoxMax);
+		node.height = 1 + std::max(child0.height, child1.height);
+
+		index = node.parent;
+	}
+}
+
+float c3d::DynamicBVH::surfaceArea(glm::vec3 boundingBoxMin, glm::vec3 boundingBoxMax)
+{
+	glm::vec3 size = boundingBoxMax - boundingBoxMin;
+	return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
\ No newline at end of file
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <Cyph3D/Helper/MathHelper.h>
+
+#include <array>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <limits>
+#include <vector>
+
+namespace c3d
+{
+// Bounding volume hierarchy over axis-aligned bounding boxes that can be inserted, moved and removed one at a time.
+// Leaves store a slightly enlarged box so that small movements do not touch the tree, and the tree is kept balanced with rotations.
+// Queries test these enlarged boxes, callers needing exact results must test the objects they get back themselves.
+class DynamicBVH
+{
+public:
+	static constexpr uint32_t NULL_NODE = UINT32_MAX;
+
+	DynamicBVH() = default;
+	DynamicBVH(const DynamicBVH& other) = default;
+	DynamicBVH& operator=(const DynamicBVH& other) = delete;
+	DynamicBVH(DynamicBVH&& other) = default;
+	DynamicBVH& operator=(DynamicBVH&& other) = default;
+
+	// Returns the leaf to pass to move() and remove()
+	uint32_t insert(glm::vec3 boundingBoxMin, glm::vec3 boundingBoxMax, uint32_t userData);
+	void remove(uint32_t leaf);
+	// Returns true if the box left the enlarged box of the leaf, in which case the leaf has been reinserted
+	bool move(uint32_t leaf, glm::vec3 boundingBoxMin, glm::vec3 boundingBoxMax);
+
+	uint32_t getUserData(uint32_t leaf) const;
+
+	uint32_t getLeafCount() const;
+	uint32_t getNodeCount() const;
+	// 0 when empty, 1 for a single leaf
+	uint32_t getHeight() const;
+	// Sum of the surface areas of the internal nodes divided by the surface area of the root, lower is better
+	float getAreaRatio() const;
+
+	// callback(uint32_t userData) is called for every leaf overlapping the box and returns false to stop the query
+	template<typename F>
+	void queryBoundingBox(glm::vec3 boundingBoxMin, glm::vec3 boundingBoxMax, F&& callback) const
+	{
+		traverse(
+			[&](const Node& node)
+			{
+				return glm::all(glm::lessThanEqual(node.boundingBoxMin, boundingBoxMax)) && glm::all(glm::greaterThanEqual(node.boundingBoxMax, boundingBoxMin));
+			},
+			callback
+		);
+	}
+
+	template<typename F>
+	void querySphere(glm::vec3 center, float radius, F&& callback) const
+	{
+		float radiusSquared = radius * radius;
+		traverse(
+			[&](const Node& node)
+			{
+				glm::vec3 closestPoint = glm::clamp(center, node.boundingBoxMin, node.boundingBoxMax);
+				glm::vec3 offset = closestPoint - center;
+				return glm::dot(offset, offset) <= radiusSquared;
+			},
+			callback
+		);
+	}
+
+	// Planes point inward, as returned by MathHelper::extractFrustumPlanes()
+	template<typename F>
+	void queryFrustum(const std::array<glm::vec4, 6>& planes, F&& callback) const
+	{
+		traverse(
+			[&](const Node& node)
+			{
+				return MathHelper::isBoundingBoxInFrustum(planes, node.boundingBoxMin, node.boundingBoxMax);
+			},
+			callback
+		);
+	}
+
+	// callback(uint32_t userData) is called for every leaf the ray may hit and returns the distance to its closest hit, or infinity if there is none.
+	// Nodes further than the closest hit found so far are skipped. Returns the distance to the closest hit.
+	template<typename F>
+	float queryRay(glm::vec3 origin, glm::vec3 direction, float maxDistance, F&& callback) const
+	{
+		if (_root == NULL_NODE)
+		{
+			return std::numeric_limits<float>::infinity();
+		}
+
+		glm::vec3 inverseDirection = 1.0f / direction;
+		float closestDistance = maxDistance;
+		bool hit = false;
+
+		std::vector<uint32_t> stack;
+		stack.reserve(64);
+		stack.push_back(_root);
+
+		while (!stack.empty())
+		{
+			const Node& node = _nodes[stack.back()];
+			stack.pop_back();
+
+			if (MathHelper::rayBoundingBoxDistance(origin, inverseDirection, node.boundingBoxMin, node.boundingBoxMax) > closestDistance)
+			{
+				continue;
+			}
+
+			if (node.isLeaf())
+			{
+				float distance = callback(node.userData);
+				if (distance <= closestDistance)
+				{
+					closestDistance = distance;
+					hit = true;
+				}
+				continue;
+			}
+
+			// Visit the nearest child first so that its hits prune the other one
+			float distance0 = MathHelper::rayBoundingBoxDistance(origin, inverseDirection, _nodes[node.children[0]].boundingBoxMin, _nodes[node.children[0]].boundingBoxMax);
+			float distance1 = MathHelper::rayBoundingBoxDistance(origin, inverseDirection, _nodes[node.children[1]].boundingBoxMin, _nodes[node.children[1]].boundingBoxMax);
+			if (distance0 < distance1)
+			{
+				stack.push_back(node.children[1]);
+				stack.push_back(node.children[0]);
+			}
+			else
+			{
+				stack.push_back(node.children[0]);
+				stack.push_back(node.children[1]);
+			}
+		}
+
+		return hit ? closestDistance : std::numeric_limits<float>::infinity();
+	}
+
+private:
+	// Enlargement of leaf boxes, relative to their size plus a constant part for flat or point-like boxes
+	static constexpr float FAT_MARGIN_RATIO = 0.1f;
+	static constexpr float FAT_MARGIN_MIN = 0.01f;
+
+	struct Node
+	{
+		glm::vec3 boundingBoxMin;
+		glm::vec3 boundingBoxMax;
+		// Next free node for nodes in the free list
+		uint32_t parent;
+		std::array<uint32_t, 2> children;
+		uint32_t userData;
+		// 0 for leaves, -1 for free nodes
+		int32_t height;
+
+		bool isLeaf() const
+		{
+			return children[0] == NULL_NODE;
+		}
+	};
+
+	std::vector<Node> _nodes;
+	uint32_t _root = NULL_NODE;
+	uint32_t _freeList = NULL_NODE;
+	uint32_t _leafCount = 0;
+
+	uint32_t allocateNode();
+	void freeNode(uint32_t index);
+
+	void insertLeaf(uint32_t leaf);
+	void removeLeaf(uint32_t leaf);
+	// Rotates the subtree rooted at index if it is unbalanced and returns its new root
+	uint32_t balance(uint32_t index);
+	// Recomputes the boxes and heights of index and all its ancestors, balancing them on the way
+	void refitAncestors(uint32_t index);
+
+	static float surfaceArea(glm::vec3 boundingBoxMin, glm::vec3 boundingBoxMax);
+
+	template<typename Overlaps, typename F>
+	void traverse(Overlaps&& overlaps, F&& callback) const
+	{
+		if (_root == NULL_NODE)
+		{
+			return;
+		}
+
+		std::vector<uint32_t> stack;
+		stack.reserve(64);
+		stack.push_back(_root);
+
+		while (!stack.empty())
+		{
+			const Node& node = _nodes[stack.back()];
+			stack.pop_back();
+
+			if (!overlaps(node))
+			{
+				continue;
+			}
+
+			if (node.isLeaf())
+			{
+				if (!callback(node.userData))
+				{
+					return;
+				}
+			}
+			else
+			{
+				stack.push_back(node.children[0]);
+				stack.push_back(node.children[1]);
+			}
+		}
+	}
+};
+}
\ No newline at end of file
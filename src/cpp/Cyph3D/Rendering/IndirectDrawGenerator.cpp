@@ -0,0 +1,500 @@
+#include "IndirectDrawGenerator.h"
+
+#include <Cyph3D/Asset/AssetManager.h>
+#include <Cyph3D/Engine.h>
+#include <Cyph3D/VKObject/Buffer/VKResizableBuffer.h>
+#include <Cyph3D/VKObject/CommandBuffer/VKCommandBuffer.h>
+#include <Cyph3D/VKObject/DescriptorSet/VKDescriptorSetLayout.h>
+#include <Cyph3D/VKObject/Pipeline/VKComputePipeline.h>
+#include <Cyph3D/VKObject/Pipeline/VKPipelineLayout.h>
+#include <Cyph3D/VKObject/Sampler/VKSampler.h>
+
+#include <algorithm>
+#include <format>
+#include <numeric>
+
+c3d::IndirectDrawGenerator::IndirectDrawGenerator(const char* name):
+	_testedObjectCounts(Engine::getVKContext().getConcurrentFrameCount())
+{
+	createDescriptorSetLayouts();
+	createPipelineLayouts();
+	createPipelines();
+	createSampler();
+	createBuffers(name);
+}
+
+void c3d::IndirectDrawGenerator::generate(const std::shared_ptr<VKCommandBuffer>& commandBuffer, const ObjectTable& objectTable, std::span<const View> views)
+{
+	prepare(objectTable, views, views.size(), views.size());
+
+	if (_objectCount == 0 || views.empty())
+	{
+		return;
+	}
+
+	beginGeneration(commandBuffer);
+
+	commandBuffer->bindPipeline(_pipeline);
+
+	commandBuffer->pushDescriptor(0, 0, objectTable.getBuffer(), 0, _objectCount);
+	commandBuffer->pushDescriptor(0, 1, _viewBuffer.getCurrent()->getBuffer(), 0, views.size());
+	commandBuffer->pushDescriptor(0, 2, _drawCommandBuffer.getCurrent()->getBuffer(), 0, views.size() * _objectCount);
+	commandBuffer->pushDescriptor(0, 3, _drawCountBuffer.getCurrent()->getBuffer(), 0, views.size() * _blockDrawRanges.size());
+
+	PushConstantData pushConstantData{
+		.objectCount = _objectCount,
+		.blockCount = static_cast<uint32_t>(_blockDrawRanges.size())
+	};
+	commandBuffer->pushConstants(pushConstantData);
+
+	commandBuffer->dispatch({(_objectCount + 63) / 64, static_cast<uint32_t>(views.size()), 1});
+
+	commandBuffer->unbindPipeline();
+
+	endGeneration(commandBuffer);
+}
+
+void c3d::IndirectDrawGenerator::generateLayered(const std::shared_ptr<VKCommandBuffer>& commandBuffer, const ObjectTable& objectTable, std::span<const View> views, uint32_t layerCount)
+{
+	uint32_t groupCount = views.size() / layerCount;
+
+	prepare(objectTable, views, groupCount, groupCount);
+
+	_layerInstanceCount = groupCount * _objectCount * layerCount;
+	_layerInstanceBuffer->resizeSmart(_layerInstanceCount);
+
+	if (_objectCount == 0 || views.empty())
+	{
+		return;
+	}
+
+	beginGeneration(commandBuffer);
+
+	commandBuffer->bufferMemoryBarrier(
+		_layerInstanceBuffer.getCurrent()->getBuffer(),
+		vk::PipelineStageFlagBits2::eComputeShader,
+		vk::AccessFlagBits2::eShaderStorageWrite
+	);
+
+	commandBuffer->bindPipeline(_layeredPipeline);
+
+	commandBuffer->pushDescriptor(0, 0, objectTable.getBuffer(), 0, _objectCount);
+	commandBuffer->pushDescriptor(0, 1, _viewBuffer.getCurrent()->getBuffer(), 0, views.size());
+	commandBuffer->pushDescriptor(0, 2, _drawCommandBuffer.getCurrent()->getBuffer(), 0, groupCount * _objectCount);
+	commandBuffer->pushDescriptor(0, 3, _drawCountBuffer.getCurrent()->getBuffer(), 0, groupCount * _blockDrawRanges.size());
+	commandBuffer->pushDescriptor(0, 4, _layerInstanceBuffer.getCurrent()->getBuffer(), 0, _layerInstanceCount);
+
+	LayeredPushConstantData pushConstantData{
+		.objectCount = _objectCount,
+		.blockCount = static_cast<uint32_t>(_blockDrawRanges.size()),
+		.layerCount = layerCount
+	};
+	commandBuffer->pushConstants(pushConstantData);
+
+	commandBuffer->dispatch({(_objectCount + 63) / 64, groupCount, 1});
+
+	commandBuffer->unbindPipeline();
+
+	endGeneration(commandBuffer);
+
+	commandBuffer->bufferMemoryBarrier(
+		_layerInstanceBuffer.getCurrent()->getBuffer(),
+		vk::PipelineStageFlagBits2::eVertexShader,
+		vk::AccessFlagBits2::eShaderStorageRead
+	);
+}
+
+const std::shared_ptr<c3d::VKBuffer<uint32_t>>& c3d::IndirectDrawGenerator::getLayerInstanceBuffer() const
+{
+	return _layerInstanceBuffer.getCurrent()->getBuffer();
+}
+
+uint32_t c3d::IndirectDrawGenerator::getLayerInstanceCount() const
+{
+	return _layerInstanceCount;
+}
+
+void c3d::IndirectDrawGenerator::generateFirstPhase(const std::shared_ptr<VKCommandBuffer>& commandBuffer, const ObjectTable& objectTable, const View& view, const glm::mat4& viewProjection)
+{
+	prepare(objectTable, std::span(&view, 1), 2, 1);
+
+	_occlusionViewProjection = viewProjection;
+
+	// New objects are not known to be visible, they are left to the second phase
+	size_t previousVisibilityCount = _visibilityBuffer->getSize();
+	_visibilityBuffer->resizeSmart(_objectCount);
+	if (_visibilityBuffer->getSize() != previousVisibilityCount)
+	{
+		std::fill_n(_visibilityBuffer->getHostPointer(), _visibilityBuffer->getSize(), 0);
+	}
+
+	if (_objectCount == 0)
+	{
+		return;
+	}
+
+	beginGeneration(commandBuffer);
+
+	commandBuffer->bufferMemoryBarrier(
+		_visibilityBuffer->getBuffer(),
+		vk::PipelineStageFlagBits2::eComputeShader,
+		vk::AccessFlagBits2::eShaderStorageRead
+	);
+
+	commandBuffer->bindPipeline(_firstPhasePipeline);
+
+	commandBuffer->pushDescriptor(0, 0, objectTable.getBuffer(), 0, _objectCount);
+	commandBuffer->pushDescriptor(0, 1, _viewBuffer.getCurrent()->getBuffer(), 0, 1);
+	commandBuffer->pushDescriptor(0, 2, _drawCommandBuffer.getCurrent()->getBuffer(), 0, 2 * _objectCount);
+	commandBuffer->pushDescriptor(0, 3, _drawCountBuffer.getCurrent()->getBuffer(), 0, 2 * _blockDrawRanges.size());
+	commandBuffer->pushDescriptor(0, 4, _visibilityBuffer->getBuffer(), 0, _objectCount);
+
+	OcclusionPushConstantData pushConstantData{
+		.viewProjection = _occlusionViewProjection,
+		.objectCount = _objectCount,
+		.blockCount = static_cast<uint32_t>(_blockDrawRanges.size())
+	};
+	commandBuffer->pushConstants(pushConstantData);
+
+	commandBuffer->dispatch({(_objectCount + 63) / 64, 1, 1});
+
+	commandBuffer->unbindPipeline();
+
+	endGeneration(commandBuffer);
+}
+
+void c3d::IndirectDrawGenerator::generateSecondPhase(const std::shared_ptr<VKCommandBuffer>& commandBuffer, const ObjectTable& objectTable, const std::shared_ptr<VKImage>& depthPyramid)
+{
+	if (_objectCount == 0)
+	{
+		return;
+	}
+
+	beginGeneration(commandBuffer);
+
+	commandBuffer->bufferMemoryBarrier(
+		_visibilityBuffer->getBuffer(),
+		vk::PipelineStageFlagBits2::eComputeShader,
+		vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite
+	);
+
+	commandBuffer->bindPipeline(_secondPhasePipeline);
+
+	commandBuffer->pushDescriptor(0, 0, objectTable.getBuffer(), 0, _objectCount);
+	commandBuffer->pushDescriptor(0, 1, _viewBuffer.getCurrent()->getBuffer(), 0, 1);
+	commandBuffer->pushDescriptor(0, 2, _drawCommandBuffer.getCurrent()->getBuffer(), 0, 2 * _objectCount);
+	commandBuffer->pushDescriptor(0, 3, _drawCountBuffer.getCurrent()->getBuffer(), 0, 2 * _blockDrawRanges.size());
+	commandBuffer->pushDescriptor(0, 4, _visibilityBuffer->getBuffer(), 0, _objectCount);
+	commandBuffer->pushDescriptor(0, 5, depthPyramid, _depthPyramidSampler);
+
+	OcclusionPushConstantData pushConstantData{
+		.viewProjection = _occlusionViewProjection,
+		.objectCount = _objectCount,
+		.blockCount = static_cast<uint32_t>(_blockDrawRanges.size())
+	};
+	commandBuffer->pushConstants(pushConstantData);
+
+	commandBuffer->dispatch({(_objectCount + 63) / 64, 1, 1});
+
+	commandBuffer->unbindPipeline();
+
+	endGeneration(commandBuffer);
+}
+
+uint32_t c3d::IndirectDrawGenerator::getViewCount() const
+{
+	return _viewCount;
+}
+
+void c3d::IndirectDrawGenerator::draw(const std::shared_ptr<VKCommandBuffer>& commandBuffer, uint32_t viewIndex, bool bindMaterialVertices) const
+{
+	MeshPool& meshPool = Engine::getAssetManager().getMeshPool();
+
+	for (uint32_t block = 0; block < _blockDrawRanges.size(); block++)
+	{
+		const ObjectTable::BlockDrawRange& range = _blockDrawRanges[block];
+		if (range.count == 0)
+		{
+			continue;
+		}
+
+		commandBuffer->bindVertexBuffer(0, meshPool.getPositionVertexBuffer(block));
+		if (bindMaterialVertices)
+		{
+			commandBuffer->bindVertexBuffer(1, meshPool.getMaterialVertexBuffer(block));
+		}
+		commandBuffer->bindIndexBuffer(meshPool.getIndexBuffer(block));
+
+		commandBuffer->drawIndexedIndirectCount(
+			_drawCommandBuffer.getCurrent()->getBuffer(),
+			viewIndex * _objectCount + range.offset,
+			_drawCountBuffer.getCurrent()->getBuffer(),
+			viewIndex * _blockDrawRanges.size() + block,
+			range.count
+		);
+	}
+}
+
+uint32_t c3d::IndirectDrawGenerator::getDrawnObjectCount() const
+{
+	return _drawnObjectCount;
+}
+
+uint32_t c3d::IndirectDrawGenerator::getCulledObjectCount() const
+{
+	return _culledObjectCount;
+}
+
+void c3d::IndirectDrawGenerator::prepare(const ObjectTable& objectTable, std::span<const View> views, uint32_t viewCount, uint32_t testedViewCount)
+{
+	// The GPU is done with the previous commands of this frame, their counts can be read back before being reset
+	std::optional<uint32_t>& testedObjectCount = _testedObjectCounts[Engine::getVKContext().getCurrentConcurrentFrame()];
+	if (testedObjectCount)
+	{
+		_drawnObjectCount = std::reduce(_drawCountBuffer->getHostPointer(), _drawCountBuffer->getHostPointer() + _drawCountBuffer->getSize());
+		_culledObjectCount = *testedObjectCount - _drawnObjectCount;
+	}
+
+	_objectCount = objectTable.getObjectCount();
+	_viewCount = viewCount;
+	_blockDrawRanges = objectTable.getBlockDrawRanges();
+	testedObjectCount = _objectCount * testedViewCount;
+
+	_viewBuffer->resizeSmart(views.size());
+	std::ranges::copy(views, _viewBuffer->getHostPointer());
+
+	_drawCommandBuffer->resizeSmart(viewCount * _objectCount);
+
+	_drawCountBuffer->resizeSmart(viewCount * _blockDrawRanges.size());
+	std::fill_n(_drawCountBuffer->getHostPointer(), _drawCountBuffer->getSize(), 0);
+}
+
+void c3d::IndirectDrawGenerator::beginGeneration(const std::shared_ptr<VKCommandBuffer>& commandBuffer)
+{
+	commandBuffer->bufferMemoryBarrier(
+		_drawCommandBuffer.getCurrent()->getBuffer(),
+		vk::PipelineStageFlagBits2::eComputeShader,
+		vk::AccessFlagBits2::eShaderStorageWrite
+	);
+
+	commandBuffer->bufferMemoryBarrier(
+		_drawCountBuffer.getCurrent()->getBuffer(),
+		vk::PipelineStageFlagBits2::eComputeShader,
+		vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite
+	);
+}
+
+void c3d::IndirectDrawGenerator::endGeneration(const std::shared_ptr<VKCommandBuffer>& commandBuffer)
+{
+	commandBuffer->bufferMemoryBarrier(
+		_drawCommandBuffer.getCurrent()->getBuffer(),
+		vk::PipelineStageFlagBits2::eDrawIndirect,
+		vk::AccessFlagBits2::eIndirectCommandRead
+	);
+
+	// The counts are also read back by the host in prepare() once the frame has completed
+	commandBuffer->bufferMemoryBarrier(
+		_drawCountBuffer.getCurrent()->getBuffer(),
+		vk::PipelineStageFlagBits2::eDrawIndirect | vk::PipelineStageFlagBits2::eHost,
+		vk::AccessFlagBits2::eIndirectCommandRead | vk::AccessFlagBits2::eHostRead
+	);
+}
+
+void c3d::IndirectDrawGenerator::createDescriptorSetLayouts()
+{
+	{
+		VKDescriptorSetLayoutInfo info(true);
+		info.addBinding(vk::DescriptorType::eStorageBuffer, 1);
+		info.addBinding(vk::DescriptorType::eStorageBuffer, 1);
+		info.addBinding(vk::DescriptorType::eStorageBuffer, 1);
+		info.addBinding(vk::DescriptorType::eStorageBuffer, 1);
+
+		_descriptorSetLayout = VKDescriptorSetLayout::create(Engine::getVKContext(), info);
+	}
+
+	{
+		VKDescriptorSetLayoutInfo info(true);
+		info.addBinding(vk::DescriptorType::eStorageBuffer, 1);
+		info.addBinding(vk::DescriptorType::eStorageBuffer, 1);
+		info.addBinding(vk::DescriptorType::eStorageBuffer, 1);
+		info.addBinding(vk::DescriptorType::eStorageBuffer, 1);
+		info.addBinding(vk::DescriptorType::eStorageBuffer, 1);
+
+		_layeredDescriptorSetLayout = VKDescriptorSetLayout::create(Engine::getVKContext(), info);
+	}
+
+	{
+		VKDescriptorSetLayoutInfo info(true);
+		info.addBinding(vk::DescriptorType::eStorageBuffer, 1);
+		info.addBinding(vk::DescriptorType::eStorageBuffer, 1);
+		info.addBinding(vk::DescriptorType::eStorageBuffer, 1);
+		info.addBinding(vk::DescriptorType::eStorageBuffer, 1);
+		info.addBinding(vk::DescriptorType::eStorageBuffer, 1);
+		info.addBinding(vk::DescriptorType::eCombinedImageSampler, 1);
+
+		_occlusionDescriptorSetLayout = VKDescriptorSetLayout::create(Engine::getVKContext(), info);
+	}
+}
+
+void c3d::IndirectDrawGenerator::createPipelineLayouts()
+{
+	{
+		VKPipelineLayoutInfo info;
+		info.addDescriptorSetLayout(_descriptorSetLayout);
+		info.setPushConstantLayout<PushConstantData>();
+
+		_pipelineLayout = VKPipelineLayout::create(Engine::getVKContext(), info);
+	}
+
+	{
+		VKPipelineLayoutInfo info;
+		info.addDescriptorSetLayout(_layeredDescriptorSetLayout);
+		info.setPushConstantLayout<LayeredPushConstantData>();
+
+		_layeredPipelineLayout = VKPipelineLayout::create(Engine::getVKContext(), info);
+	}
+
+	{
+		VKPipelineLayoutInfo info;
+		info.addDescriptorSetLayout(_occlusionDescriptorSetLayout);
+		info.setPushConstantLayout<OcclusionPushConstantData>();
+
+		_occlusionPipelineLayout = VKPipelineLayout::create(Engine::getVKContext(), info);
+	}
+}
+
+void c3d::IndirectDrawGenerator::createPipelines()
+{
+	{
+		VKComputePipelineInfo info(
+			_pipelineLayout,
+			"culling/generate draws.comp"
+		);
+
+		_pipeline = VKComputePipeline::create(Engine::getVKContext(), info);
+	}
+
+	{
+		VKComputePipelineInfo info(
+			_layeredPipelineLayout,
+			"culling/generate layered draws.comp"
+		);
+
+		_layeredPipeline = VKComputePipeline::create(Engine::getVKContext(), info);
+	}
+
+	{
+		VKComputePipelineInfo info(
+			_occlusionPipelineLayout,
+			"culling/occlusion cull first phase.comp"
+		);
+
+		_firstPhasePipeline = VKComputePipeline::create(Engine::getVKContext(), info);
+	}
+
+	{
+		VKComputePipelineInfo info(
+			_occlusionPipelineLayout,
+			"culling/occlusion cull second phase.comp"
+		);
+
+		_secondPhasePipeline = VKComputePipeline::create(Engine::getVKContext(), info);
+	}
+}
+
+void c3d::IndirectDrawGenerator::createSampler()
+{
+	vk::SamplerCreateInfo createInfo;
+	createInfo.flags = {};
+	createInfo.magFilter = vk::Filter::eNearest;
+	createInfo.minFilter = vk::Filter::eNearest;
+	createInfo.mipmapMode = vk::SamplerMipmapMode::eNearest;
+	createInfo.addressModeU = vk::SamplerAddressMode::eClampToEdge;
+	createInfo.addressModeV = vk::SamplerAddressMode::eClampToEdge;
+	createInfo.addressModeW = vk::SamplerAddressMode::eClampToEdge;
+	createInfo.mipLodBias = 0.0f;
+	createInfo.anisotropyEnable = false;
+	createInfo.maxAnisotropy = 1;
+	createInfo.compareEnable = false;
+	createInfo.compareOp = vk::CompareOp::eNever;
+	createInfo.minLod = -1000.0f;
+	createInfo.maxLod = 1000.0f;
+	createInfo.borderColor = vk::BorderColor::eIntOpaqueBlack;
+	createInfo.unnormalizedCoordinates = false;
+
+	_depthPyramidSampler = VKSampler::create(Engine::getVKContext(), createInfo);
+}
+
+void c3d::IndirectDrawGenerator::createBuffers(const char* name)
+{
+	{
+		VKResizableBufferInfo bufferInfo(vk::BufferUsageFlagBits::eStorageBuffer);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eDeviceLocal);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostVisible);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostCoherent);
+		bufferInfo.setName(std::format("{} view buffer", name));
+
+		_viewBuffer = VKDynamic<VKResizableBuffer<View>>(
+			Engine::getVKContext(),
+			[&](VKContext& context, int index)
+			{
+				return VKResizableBuffer<View>::create(context, bufferInfo);
+			}
+		);
+	}
+
+	{
+		VKResizableBufferInfo bufferInfo(vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eDeviceLocal);
+		bufferInfo.setName(std::format("{} draw command buffer", name));
+
+		_drawCommandBuffer = VKDynamic<VKResizableBuffer<vk::DrawIndexedIndirectCommand>>(
+			Engine::getVKContext(),
+			[&](VKContext& context, int index)
+			{
+				return VKResizableBuffer<vk::DrawIndexedIndirectCommand>::create(context, bufferInfo);
+			}
+		);
+	}
+
+	{
+		// Host visible to be reset and read back without transfers
+		VKResizableBufferInfo bufferInfo(vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eDeviceLocal);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostVisible);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostCoherent);
+		bufferInfo.setName(std::format("{} draw count buffer", name));
+
+		_drawCountBuffer = VKDynamic<VKResizableBuffer<uint32_t>>(
+			Engine::getVKContext(),
+			[&](VKContext& context, int index)
+			{
+				return VKResizableBuffer<uint32_t>::create(context, bufferInfo);
+			}
+		);
+	}
+
+	{
+		VKResizableBufferInfo bufferInfo(vk::BufferUsageFlagBits::eStorageBuffer);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eDeviceLocal);
+		bufferInfo.setName(std::format("{} layer instance buffer", name));
+
+		_layerInstanceBuffer = VKDynamic<VKResizableBuffer<uint32_t>>(
+			Engine::getVKContext(),
+			[&](VKContext& context, int index)
+			{
+				return VKResizableBuffer<uint32_t>::create(context, bufferInfo);
+			}
+		);
+	}
+
+	{
+		VKResizableBufferInfo bufferInfo(vk::BufferUsageFlagBits::eStorageBuffer);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eDeviceLocal);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostVisible);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostCoherent);
+		bufferInfo.setName(std::format("{} visibility buffer", name));
+
+		_visibilityBuffer = VKResizableBuffer<uint32_t>::create(Engine::getVKContext(), bufferInfo);
+	}
+}
\ No newline at end of file
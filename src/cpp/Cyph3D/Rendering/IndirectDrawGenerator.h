@@ -0,0 +1,148 @@
+#pragma once
+
+#include <Cyph3D/Rendering/ObjectTable.h>
+#include <Cyph3D/VKObject/VKDynamic.h>
+
+#include <array>
+#include <glm/glm.hpp>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace c3d
+{
+class VKCommandBuffer;
+class VKDescriptorSetLayout;
+class VKPipelineLayout;
+class VKComputePipeline;
+template<typename T>
+class VKBuffer;
+class VKImage;
+class VKSampler;
+template<typename T>
+class VKResizableBuffer;
+
+// Culls the objects of an ObjectTable against a set of views in a compute shader.
+// For each view and mesh pool block, the shader writes a list of indirect draw commands and their count.
+// Drawing a view then takes one indirect draw per mesh pool block, whatever the number of objects.
+// A single view can also be occlusion culled in two phases, see generateFirstPhase(), and groups of views can be drawn with a single draw per object,
+// see generateLayered().
+class IndirectDrawGenerator
+{
+public:
+	struct View
+	{
+		std::array<glm::vec4, 6> frustumPlanes;
+		// ObjectTable flags an object must have to be drawn in this view
+		uint32_t requiredFlags;
+	};
+
+	// Must match culling.glsl
+	static constexpr uint32_t LAYER_INSTANCE_LAYER_BITS = 3;
+	static constexpr uint32_t MAX_LAYER_COUNT = 1 << LAYER_INSTANCE_LAYER_BITS;
+
+	explicit IndirectDrawGenerator(const char* name);
+
+	// Must be recorded outside of rendering, before the draws of the views in the same command buffer
+	void generate(const std::shared_ptr<VKCommandBuffer>& commandBuffer, const ObjectTable& objectTable, std::span<const View> views);
+
+	// Two-phase occlusion culling of a single view, whose draws are split over view indices 0 and 1.
+	// The first phase keeps the objects found visible by the previous frame's second phase. Once they are drawn, the second phase tests
+	// the other objects against a depth pyramid of these draws, the objects found visible are then drawn on top.
+	// Object visibilities are kept by object index, an index change only delays the detection of an object to the second phase.
+	void generateFirstPhase(const std::shared_ptr<VKCommandBuffer>& commandBuffer, const ObjectTable& objectTable, const View& view, const glm::mat4& viewProjection);
+	// The depth pyramid must hold the farthest depth of the first phase's draws, with level 0 having the size of the depth image
+	void generateSecondPhase(const std::shared_ptr<VKCommandBuffer>& commandBuffer, const ObjectTable& objectTable, const std::shared_ptr<VKImage>& depthPyramid);
+
+	// Views are grouped by layerCount, which must divide their number and be at most MAX_LAYER_COUNT, each group being drawn with the view index of the group.
+	// The layer of a view is its position in its group. An object touching several views of a group is drawn once, with one instance per layer it must be rasterized to.
+	// Shaders find the object and the layer of an instance in the buffer returned by getLayerInstanceBuffer() and place the instance in the region of the render target
+	// holding that view, such as a tile of an atlas.
+	void generateLayered(const std::shared_ptr<VKCommandBuffer>& commandBuffer, const ObjectTable& objectTable, std::span<const View> views, uint32_t layerCount);
+
+	// Indexed by gl_InstanceIndex in draws of a layered generation, each entry holds the object index shifted by LAYER_INSTANCE_LAYER_BITS and the layer
+	const std::shared_ptr<VKBuffer<uint32_t>>& getLayerInstanceBuffer() const;
+	// Number of entries of the layer instance buffer written by the last layered generation
+	uint32_t getLayerInstanceCount() const;
+
+	// Number of view indices written by the last generation
+	uint32_t getViewCount() const;
+
+	// Must be recorded in rendering, with a pipeline taking positions in vertex slot 0 and, if bindMaterialVertices is true, material vertices in slot 1
+	void draw(const std::shared_ptr<VKCommandBuffer>& commandBuffer, uint32_t viewIndex, bool bindMaterialVertices) const;
+
+	// Summed over all views of a previous generation, read back once the GPU has executed it
+	uint32_t getDrawnObjectCount() const;
+	uint32_t getCulledObjectCount() const;
+
+private:
+	struct PushConstantData
+	{
+		uint32_t objectCount;
+		uint32_t blockCount;
+	};
+
+	struct LayeredPushConstantData
+	{
+		uint32_t objectCount;
+		uint32_t blockCount;
+		uint32_t layerCount;
+	};
+
+	struct OcclusionPushConstantData
+	{
+		glm::mat4 viewProjection;
+		uint32_t objectCount;
+		uint32_t blockCount;
+	};
+
+	std::shared_ptr<VKDescriptorSetLayout> _descriptorSetLayout;
+	std::shared_ptr<VKPipelineLayout> _pipelineLayout;
+	std::shared_ptr<VKComputePipeline> _pipeline;
+
+	std::shared_ptr<VKDescriptorSetLayout> _layeredDescriptorSetLayout;
+	std::shared_ptr<VKPipelineLayout> _layeredPipelineLayout;
+	std::shared_ptr<VKComputePipeline> _layeredPipeline;
+
+	std::shared_ptr<VKDescriptorSetLayout> _occlusionDescriptorSetLayout;
+	std::shared_ptr<VKPipelineLayout> _occlusionPipelineLayout;
+	std::shared_ptr<VKComputePipeline> _firstPhasePipeline;
+	std::shared_ptr<VKComputePipeline> _secondPhasePipeline;
+
+	std::shared_ptr<VKSampler> _depthPyramidSampler;
+
+	VKDynamic<VKResizableBuffer<View>> _viewBuffer;
+	VKDynamic<VKResizableBuffer<vk::DrawIndexedIndirectCommand>> _drawCommandBuffer;
+	VKDynamic<VKResizableBuffer<uint32_t>> _drawCountBuffer;
+	VKDynamic<VKResizableBuffer<uint32_t>> _layerInstanceBuffer;
+
+	// Shared by all frames, each frame's first phase reads the visibilities written by the previous frame's second phase
+	std::shared_ptr<VKResizableBuffer<uint32_t>> _visibilityBuffer;
+
+	// Layout of the commands of the last generation
+	uint32_t _objectCount = 0;
+	uint32_t _viewCount = 0;
+	uint32_t _layerInstanceCount = 0;
+	std::vector<ObjectTable::BlockDrawRange> _blockDrawRanges;
+
+	glm::mat4 _occlusionViewProjection;
+
+	// Objects times views tested by the last generation of each concurrent frame, if any
+	std::vector<std::optional<uint32_t>> _testedObjectCounts;
+	uint32_t _drawnObjectCount = 0;
+	uint32_t _culledObjectCount = 0;
+
+	// Reads back the statistics of the current frame's previous generation and sizes the buffers for a new one
+	void prepare(const ObjectTable& objectTable, std::span<const View> views, uint32_t viewCount, uint32_t testedViewCount);
+	void beginGeneration(const std::shared_ptr<VKCommandBuffer>& commandBuffer);
+	void endGeneration(const std::shared_ptr<VKCommandBuffer>& commandBuffer);
+
+	void createDescriptorSetLayouts();
+	void createPipelineLayouts();
+	void createPipelines();
+	void createSampler();
+	void createBuffers(const char* name);
+};
+}
\ No newline at end of file
@@ -0,0 +1,208 @@
+#include "MeshBVH.h"
+
+#include <Cyph3D/Helper/MathHelper.h>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+namespace
+{
+struct BuildTriangle
+{
+	glm::vec3 boundingBoxMin;
+	glm::vec3 boundingBoxMax;
+	glm::vec3 centroid;
+	uint32_t index;
+};
+
+uint32_t buildNode(std::vector<c3d::MeshBVHNode>& nodes, std::vector<BuildTriangle>& triangles, uint32_t begin, uint32_t end, uint32_t maxLeafTriangles)
+{
+	uint32_t nodeIndex = nodes.size();
+	nodes.emplace_back();
+
+	glm::vec3 boundingBoxMin(std::numeric_limits<float>::max());
+	glm::vec3 boundingBoxMax(std::numeric_limits<float>::lowest());
+	glm::vec3 centroidMin(std::numeric_limits<float>::max());
+	glm::vec3 centroidMax(std::numeric_limits<float>::lowest());
+	for (uint32_t i = begin; i < end; i++)
+	{
+		boundingBoxMin = glm::min(boundingBoxMin, triangles[i].boundingBoxMin);
+		boundingBoxMax = glm::max(boundingBoxMax, triangles[i].boundingBoxMax);
+		centroidMin = glm::min(centroidMin, triangles[i].centroid);
+		centroidMax = glm::max(centroidMax, triangles[i].centroid);
+	}
+
+	nodes[nodeIndex].boundingBoxMin = boundingBoxMin;
+	nodes[nodeIndex].boundingBoxMax = boundingBoxMax;
+
+	if (end - begin <= maxLeafTriangles)
+	{
+		nodes[nodeIndex].offset = begin;
+		nodes[nodeIndex].triangleCount = end - begin;
+		return nodeIndex;
+	}
+
+	// Median split along the axis where the centroids are the most spread out
+	glm::vec3 centroidExtent = centroidMax - centroidMin;
+	int axis = 0;
+	if (centroidExtent.y > centroidExtent[axis]) axis = 1;
+	if (centroidExtent.z > centroidExtent[axis]) axis = 2;
+
+	uint32_t middle = begin + (end - begin) / 2;
+	std::nth_element(
+		triangles.begin() + begin, triangles.begin() + middle, triangles.begin() + end,
+		[axis](const BuildTriangle& a, const BuildTriangle& b)
+		{
+			return a.centroid[axis] < b.centroid[axis];
+		}
+	);
+
+	buildNode(nodes, triangles, begin, middle, maxLeafTriangles);
+	uint32_t rightIndex = buildNode(nodes, triangles, middle, end, maxLeafTriangles);
+
+	nodes[nodeIndex].offset = rightIndex;
+	nodes[nodeIndex].triangleCount = 0;
+
+	return nodeIndex;
+}
+
+// Möller-Trumbore, only accepting hits on front faces
+float rayTriangleDistance(glm::vec3 origin, glm::vec3 direction, glm::vec3 v0, glm::vec3 v1, glm::vec3 v2, bool clockwiseFrontFaces)
+{
+	glm::vec3 edge1 = v1 - v0;
+	glm::vec3 edge2 = v2 - v0;
+
+	glm::vec3 p = glm::cross(direction, edge2);
+	// Positive when the ray faces the counter-clockwise side of the triangle
+	float determinant = glm::dot(edge1, p);
+	if ((clockwiseFrontFaces ? -determinant : determinant) <= 0.0f)
+	{
+		return std::numeric_limits<float>::infinity();
+	}
+
+	float inverseDeterminant = 1.0f / determinant;
+
+	glm::vec3 s = origin - v0;
+	float u = glm::dot(s, p) * inverseDeterminant;
+	if (u < 0.0f || u > 1.0f)
+	{
+		return std::numeric_limits<float>::infinity();
+	}
+
+	glm::vec3 q = glm::cross(s, edge1);
+	float v = glm::dot(direction, q) * inverseDeterminant;
+	if (v < 0.0f || u + v > 1.0f)
+	{
+		return std::numeric_limits<float>::infinity();
+	}
+
+	float distance = glm::dot(edge2, q) * inverseDeterminant;
+	return distance >= 0.0f ? distance : std::numeric_limits<float>::infinity();
+}
+}
+
+std::vector<c3d::MeshBVHNode> c3d::MeshBVH::build(const std::vector<PositionVertexData>& vertices, std::vector<uint32_t>& indices)
+{
+	uint32_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0)
+	{
+		return {};
+	}
+
+	std::vector<BuildTriangle> triangles(triangleCount);
+	for (uint32_t i = 0; i < triangleCount; i++)
+	{
+		glm::vec3 v0 = vertices[indices[i * 3 + 0]].position;
+		glm::vec3 v1 = vertices[indices[i * 3 + 1]].position;
+		glm::vec3 v2 = vertices[indices[i * 3 + 2]].position;
+
+		triangles[i].boundingBoxMin = glm::min(glm::min(v0, v1), v2);
+		triangles[i].boundingBoxMax = glm::max(glm::max(v0, v1), v2);
+		triangles[i].centroid = (v0 + v1 + v2) / 3.0f;
+		triangles[i].index = i;
+	}
+
+	std::vector<MeshBVHNode> nodes;
+	nodes.reserve(2 * (triangleCount / MAX_LEAF_TRIANGLES + 1));
+	buildNode(nodes, triangles, 0, triangleCount, MAX_LEAF_TRIANGLES);
+
+	std::vector<uint32_t> sortedIndices(triangleCount * 3);
+	for (uint32_t i = 0; i < triangleCount; i++)
+	{
+		sortedIndices[i * 3 + 0] = indices[triangles[i].index * 3 + 0];
+		sortedIndices[i * 3 + 1] = indices[triangles[i].index * 3 + 1];
+		sortedIndices[i * 3 + 2] = indices[triangles[i].index * 3 + 2];
+	}
+	indices = std::move(sortedIndices);
+
+	return nodes;
+}
+
+float c3d::MeshBVH::raycast(const std::vector<MeshBVHNode>& nodes, const std::vector<PositionVertexData>& vertices, const std::vector<uint32_t>& indices, glm::vec3 origin, glm::vec3 direction, float maxDistance, bool clockwiseFrontFaces)
+{
+	if (nodes.empty())
+	{
+		return std::numeric_limits<float>::infinity();
+	}
+
+	glm::vec3 inverseDirection = 1.0f / direction;
+	float closestDistance = maxDistance;
+	bool hit = false;
+
+	// Median splits keep the tree depth close to log2 of the leaf count
+	std::array<uint32_t, 64> stack;
+	uint32_t stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const MeshBVHNode& node = nodes[stack[--stackSize]];
+
+		if (MathHelper::rayBoundingBoxDistance(origin, inverseDirection, node.boundingBoxMin, node.boundingBoxMax) > closestDistance)
+		{
+			continue;
+		}
+
+		if (node.triangleCount > 0)
+		{
+			for (uint32_t i = node.offset; i < node.offset + node.triangleCount; i++)
+			{
+				float distance = rayTriangleDistance(
+					origin,
+					direction,
+					vertices[indices[i * 3 + 0]].position,
+					vertices[indices[i * 3 + 1]].position,
+					vertices[indices[i * 3 + 2]].position,
+					clockwiseFrontFaces
+				);
+
+				if (distance <= closestDistance)
+				{
+					closestDistance = distance;
+					hit = true;
+				}
+			}
+			continue;
+		}
+
+		uint32_t leftIndex = &node - nodes.data() + 1;
+		uint32_t rightIndex = node.offset;
+
+		// Visit the nearest child first so that its hits prune the other one
+		float leftDistance = MathHelper::rayBoundingBoxDistance(origin, inverseDirection, nodes[leftIndex].boundingBoxMin, nodes[leftIndex].boundingBoxMax);
+		float rightDistance = MathHelper::rayBoundingBoxDistance(origin, inverseDirection, nodes[rightIndex].boundingBoxMin, nodes[rightIndex].boundingBoxMax);
+		if (leftDistance < rightDistance)
+		{
+			stack[stackSize++] = rightIndex;
+			stack[stackSize++] = leftIndex;
+		}
+		else
+		{
+			stack[stackSize++] = leftIndex;
+			stack[stackSize++] = rightIndex;
+		}
+	}
+
+	return hit ? closestDistance : std::numeric_limits<float>::infinity();
+}
\ No newline at end of file
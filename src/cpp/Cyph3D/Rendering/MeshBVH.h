@@ -0,0 +1,36 @@
+#pragma once
+
+#include <Cyph3D/Rendering/VertexData.h>
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace c3d
+{
+// Nodes are stored depth first: the left child of an internal node directly follows it.
+struct MeshBVHNode
+{
+	glm::vec3 boundingBoxMin;
+	// First triangle for leaves, right child for internal nodes
+	uint32_t offset;
+	glm::vec3 boundingBoxMax;
+	// 0 for internal nodes
+	uint32_t triangleCount;
+};
+
+// Static bounding volume hierarchy over the triangles of a mesh, built when the mesh is processed and used for CPU ray casts.
+class MeshBVH
+{
+public:
+	// Reorders the triangles of indices so that every leaf references a contiguous range of them
+	static std::vector<MeshBVHNode> build(const std::vector<PositionVertexData>& vertices, std::vector<uint32_t>& indices);
+
+	// Returns the distance along the ray to the closest front face it hits, or infinity if there is none.
+	// Distances are expressed in multiples of direction, which does not need to be normalized.
+	static float raycast(const std::vector<MeshBVHNode>& nodes, const std::vector<PositionVertexData>& vertices, const std::vector<uint32_t>& indices, glm::vec3 origin, glm::vec3 direction, float maxDistance, bool clockwiseFrontFaces);
+
+private:
+	static constexpr uint32_t MAX_LEAF_TRIANGLES = 4;
+};
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include "ObjectTable.h"
+
+#include <Cyph3D/Asset/RuntimeAsset/MaterialAsset.h>
+#include <Cyph3D/Asset/RuntimeAsset/MeshAsset.h>
+#include <Cyph3D/Engine.h>
+#include <Cyph3D/Rendering/RenderRegistry.h>
+#include <Cyph3D/VKObject/Buffer/VKResizableBuffer.h>
+
+c3d::ObjectTable::ObjectTable()
+{
+	createBuffers();
+}
+
+void c3d::ObjectTable::update(const RenderRegistry& registry)
+{
+	const RenderProxyList<ModelRenderer::RenderData>& models = registry.getModels();
+
+	_objectCount = models.getSize();
+
+	_blockDrawRanges.clear();
+	for (const ModelRenderer::RenderData& model : models.getData())
+	{
+		uint32_t block = model.mesh->getMeshPoolAllocation().block;
+		if (block >= _blockDrawRanges.size())
+		{
+			_blockDrawRanges.resize(block + 1, {0, 0});
+		}
+
+		_blockDrawRanges[block].count++;
+	}
+
+	uint32_t blockDrawOffset = 0;
+	for (BlockDrawRange& range : _blockDrawRanges)
+	{
+		range.offset = blockDrawOffset;
+		blockDrawOffset += range.count;
+	}
+
+	_buffer->resizeSmart(_objectCount);
+	for (int i = 0; i < _objectCount; i++)
+	{
+		const ModelRenderer::RenderData& model = models.getData()[i];
+		const MeshPool::Allocation& allocation = model.mesh->getMeshPoolAllocation();
+
+		ObjectData* objectDataPtr = _buffer->getHostPointer() + i;
+		objectDataPtr->localToWorld = glm::mat4x3(models.getLocalToWorldMatrices()[i]);
+		objectDataPtr->worldBoundingBoxMin = models.getWorldBoundingBoxMins()[i];
+		objectDataPtr->indexCount = allocation.indexCount;
+		objectDataPtr->worldBoundingBoxMax = models.getWorldBoundingBoxMaxs()[i];
+		objectDataPtr->firstIndex = allocation.indexOffset;
+		objectDataPtr->vertexOffset = allocation.vertexOffset;
+		objectDataPtr->meshPoolBlock = allocation.block;
+		objectDataPtr->blockDrawOffset = _blockDrawRanges[allocation.block].offset;
+		objectDataPtr->flags = model.contributeShadows ? FLAG_CONTRIBUTE_SHADOWS : 0;
+		objectDataPtr->materialIndex = model.material->getMaterialIndex();
+	}
+}
+
+const std::shared_ptr<c3d::VKBuffer<c3d::ObjectTable::ObjectData>>& c3d::ObjectTable::getBuffer() const
+{
+	return _buffer.getCurrent()->getBuffer();
+}
+
+uint32_t c3d::ObjectTable::getObjectCount() const
+{
+	return _objectCount;
+}
+
+const std::vector<c3d::ObjectTable::BlockDrawRange>& c3d::ObjectTable::getBlockDrawRanges() const
+{
+	return _blockDrawRanges;
+}
+
+void c3d::ObjectTable::createBuffers()
+{
+	{
+		VKResizableBufferInfo bufferInfo(vk::BufferUsageFlagBits::eStorageBuffer);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eDeviceLocal);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostVisible);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostCoherent);
+		bufferInfo.setName("Object table buffer");
+
+		_buffer = VKDynamic<VKResizableBuffer<ObjectData>>(
+			Engine::getVKContext(),
+			[&](VKContext& context, int index)
+			{
+				return VKResizableBuffer<ObjectData>::create(context, bufferInfo);
+			}
+		);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <Cyph3D/VKObject/VKDynamic.h>
+
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+namespace c3d
+{
+class RenderRegistry;
+template<typename T>
+class VKBuffer;
+template<typename T>
+class VKResizableBuffer;
+
+// GPU copy of the data needed to cull and draw the models of a RenderRegistry, uploaded every frame and bound once per pass.
+// Objects are at the position of their model in RenderRegistry::getModels(). Draws use that position as their first instance, so shaders find their object with gl_InstanceIndex.
+// Tightly packed to match the scalar layout, shaders derive the normal matrix from the 3x4 local to world matrix.
+class ObjectTable
+{
+public:
+	struct ObjectData
+	{
+		glm::mat4x3 localToWorld;
+		glm::vec3 worldBoundingBoxMin;
+		uint32_t indexCount;
+		glm::vec3 worldBoundingBoxMax;
+		uint32_t firstIndex;
+		int32_t vertexOffset;
+		uint32_t meshPoolBlock;
+		// Offset of the draw commands of the object's mesh pool block in each view, see getBlockDrawRanges()
+		uint32_t blockDrawOffset;
+		uint32_t flags;
+		// Slot of the object's material in the MaterialRegistry
+		uint32_t materialIndex;
+	};
+
+	// Draw commands reserved for the objects of a mesh pool block in each view
+	struct BlockDrawRange
+	{
+		uint32_t offset;
+		uint32_t count;
+	};
+
+	static constexpr uint32_t FLAG_CONTRIBUTE_SHADOWS = 1 << 0;
+
+	ObjectTable();
+
+	void update(const RenderRegistry& registry);
+
+	const std::shared_ptr<VKBuffer<ObjectData>>& getBuffer() const;
+	uint32_t getObjectCount() const;
+	// Indexed by mesh pool block, up to the last block used by an object
+	const std::vector<BlockDrawRange>& getBlockDrawRanges() const;
+
+private:
+	VKDynamic<VKResizableBuffer<ObjectData>> _buffer;
+	uint32_t _objectCount = 0;
+	std::vector<BlockDrawRange> _blockDrawRanges;
+
+	void createBuffers();
+};
+}
\ No newline at end of file
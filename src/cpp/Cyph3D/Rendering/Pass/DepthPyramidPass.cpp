@@ -0,0 +1,207 @@
+#include "DepthPyramidPass.h"
+
+#include <Cyph3D/Engine.h>
+#include <Cyph3D/VKObject/CommandBuffer/VKCommandBuffer.h>
+#include <Cyph3D/VKObject/DescriptorSet/VKDescriptorSetLayout.h>
+#include <Cyph3D/VKObject/Image/VKImage.h>
+#include <Cyph3D/VKObject/Pipeline/VKComputePipeline.h>
+#include <Cyph3D/VKObject/Pipeline/VKPipelineLayout.h>
+#include <Cyph3D/VKObject/Sampler/VKSampler.h>
+
+c3d::DepthPyramidPass::DepthPyramidPass(glm::uvec2 size):
+	RenderPass(size, "Depth pyramid pass")
+{
+	createDescriptorSetLayouts();
+	createPipelineLayouts();
+	createPipelines();
+	createSampler();
+	createImage();
+}
+
+c3d::DepthPyramidPassOutput c3d::DepthPyramidPass::onRender(const std::shared_ptr<VKCommandBuffer>& commandBuffer, DepthPyramidPassInput& input)
+{
+	uint32_t levels = _depthPyramidImage->getInfo().getLevels();
+	vk::Format format = _depthPyramidImage->getInfo().getFormat();
+
+	commandBuffer->imageMemoryBarrier(
+		input.multisampledDepthImage,
+		vk::PipelineStageFlagBits2::eComputeShader,
+		vk::AccessFlagBits2::eShaderSampledRead,
+		vk::ImageLayout::eReadOnlyOptimal
+	);
+
+	commandBuffer->imageMemoryBarrier(
+		_depthPyramidImage,
+		vk::PipelineStageFlagBits2::eComputeShader,
+		vk::AccessFlagBits2::eShaderStorageWrite,
+		vk::ImageLayout::eGeneral,
+		{0, 0},
+		{0, 0}
+	);
+
+	commandBuffer->bindPipeline(_resolvePipeline);
+
+	commandBuffer->pushDescriptor(0, 0, input.multisampledDepthImage, _depthSampler);
+	commandBuffer->pushDescriptor(0, 1, _depthPyramidImage, vk::ImageViewType::e2D, {0, 0}, {0, 0}, format);
+
+	commandBuffer->dispatch({(_size.x + 7) / 8, (_size.y + 7) / 8, 1});
+
+	commandBuffer->unbindPipeline();
+
+	for (uint32_t level = 1; level < levels; level++)
+	{
+		commandBuffer->imageMemoryBarrier(
+			_depthPyramidImage,
+			vk::PipelineStageFlagBits2::eComputeShader,
+			vk::AccessFlagBits2::eShaderStorageRead,
+			vk::ImageLayout::eGeneral,
+			{0, 0},
+			{level - 1, level - 1}
+		);
+
+		commandBuffer->imageMemoryBarrier(
+			_depthPyramidImage,
+			vk::PipelineStageFlagBits2::eComputeShader,
+			vk::AccessFlagBits2::eShaderStorageWrite,
+			vk::ImageLayout::eGeneral,
+			{0, 0},
+			{level, level}
+		);
+
+		commandBuffer->bindPipeline(_reducePipeline);
+
+		commandBuffer->pushDescriptor(0, 0, _depthPyramidImage, vk::ImageViewType::e2D, {0, 0}, {level - 1, level - 1}, format);
+		commandBuffer->pushDescriptor(0, 1, _depthPyramidImage, vk::ImageViewType::e2D, {0, 0}, {level, level}, format);
+
+		glm::uvec2 levelSize = _depthPyramidImage->getSize(level);
+		commandBuffer->dispatch({(levelSize.x + 7) / 8, (levelSize.y + 7) / 8, 1});
+
+		commandBuffer->unbindPipeline();
+	}
+
+	// Every level but the last one has been read to compute the next one, their states differ from the last level's
+	if (levels > 1)
+	{
+		commandBuffer->imageMemoryBarrier(
+			_depthPyramidImage,
+			vk::PipelineStageFlagBits2::eComputeShader,
+			vk::AccessFlagBits2::eShaderSampledRead,
+			vk::ImageLayout::eReadOnlyOptimal,
+			{0, 0},
+			{0, levels - 2}
+		);
+	}
+
+	commandBuffer->imageMemoryBarrier(
+		_depthPyramidImage,
+		vk::PipelineStageFlagBits2::eComputeShader,
+		vk::AccessFlagBits2::eShaderSampledRead,
+		vk::ImageLayout::eReadOnlyOptimal,
+		{0, 0},
+		{levels - 1, levels - 1}
+	);
+
+	return {
+		.depthPyramidImage = _depthPyramidImage
+	};
+}
+
+void c3d::DepthPyramidPass::onResize()
+{
+	createImage();
+}
+
+void c3d::DepthPyramidPass::createDescriptorSetLayouts()
+{
+	{
+		VKDescriptorSetLayoutInfo info(true);
+		info.addBinding(vk::DescriptorType::eCombinedImageSampler, 1);
+		info.addBinding(vk::DescriptorType::eStorageImage, 1);
+
+		_resolveDescriptorSetLayout = VKDescriptorSetLayout::create(Engine::getVKContext(), info);
+	}
+
+	{
+		VKDescriptorSetLayoutInfo info(true);
+		info.addBinding(vk::DescriptorType::eStorageImage, 1);
+		info.addBinding(vk::DescriptorType::eStorageImage, 1);
+
+		_reduceDescriptorSetLayout = VKDescriptorSetLayout::create(Engine::getVKContext(), info);
+	}
+}
+
+void c3d::DepthPyramidPass::createPipelineLayouts()
+{
+	{
+		VKPipelineLayoutInfo info;
+		info.addDescriptorSetLayout(_resolveDescriptorSetLayout);
+
+		_resolvePipelineLayout = VKPipelineLayout::create(Engine::getVKContext(), info);
+	}
+
+	{
+		VKPipelineLayoutInfo info;
+		info.addDescriptorSetLayout(_reduceDescriptorSetLayout);
+
+		_reducePipelineLayout = VKPipelineLayout::create(Engine::getVKContext(), info);
+	}
+}
+
+void c3d::DepthPyramidPass::createPipelines()
+{
+	{
+		VKComputePipelineInfo info(
+			_resolvePipelineLayout,
+			"depth pyramid/resolve.comp"
+		);
+
+		_resolvePipeline = VKComputePipeline::create(Engine::getVKContext(), info);
+	}
+
+	{
+		VKComputePipelineInfo info(
+			_reducePipelineLayout,
+			"depth pyramid/reduce.comp"
+		);
+
+		_reducePipeline = VKComputePipeline::create(Engine::getVKContext(), info);
+	}
+}
+
+void c3d::DepthPyramidPass::createSampler()
+{
+	vk::SamplerCreateInfo createInfo;
+	createInfo.flags = {};
+	createInfo.magFilter = vk::Filter::eNearest;
+	createInfo.minFilter = vk::Filter::eNearest;
+	createInfo.mipmapMode = vk::SamplerMipmapMode::eNearest;
+	createInfo.addressModeU = vk::SamplerAddressMode::eClampToEdge;
+	createInfo.addressModeV = vk::SamplerAddressMode::eClampToEdge;
+	createInfo.addressModeW = vk::SamplerAddressMode::eClampToEdge;
+	createInfo.mipLodBias = 0.0f;
+	createInfo.anisotropyEnable = false;
+	createInfo.maxAnisotropy = 1;
+	createInfo.compareEnable = false;
+	createInfo.compareOp = vk::CompareOp::eNever;
+	createInfo.minLod = -1000.0f;
+	createInfo.maxLod = 1000.0f;
+	createInfo.borderColor = vk::BorderColor::eIntOpaqueBlack;
+	createInfo.unnormalizedCoordinates = false;
+
+	_depthSampler = VKSampler::create(Engine::getVKContext(), createInfo);
+}
+
+void c3d::DepthPyramidPass::createImage()
+{
+	VKImageInfo imageInfo(
+		vk::Format::eR32Sfloat,
+		_size,
+		1,
+		VKImage::calcMaxMipLevels(_size),
+		vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eSampled
+	);
+	imageInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eDeviceLocal);
+	imageInfo.setName("Depth pyramid image");
+
+	_depthPyramidImage = VKImage::create(Engine::getVKContext(), imageInfo);
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <Cyph3D/Rendering/Pass/RenderPass.h>
+
+namespace c3d
+{
+class VKDescriptorSetLayout;
+class VKPipelineLayout;
+class VKComputePipeline;
+class VKSampler;
+class VKImage;
+
+struct DepthPyramidPassInput
+{
+	const std::shared_ptr<VKImage>& multisampledDepthImage;
+};
+
+struct DepthPyramidPassOutput
+{
+	// Farthest depth of each texel footprint, level 0 having the size of the depth image
+	const std::shared_ptr<VKImage>& depthPyramidImage;
+};
+
+class DepthPyramidPass : public RenderPass<DepthPyramidPassInput, DepthPyramidPassOutput>
+{
+public:
+	explicit DepthPyramidPass(glm::uvec2 size);
+
+private:
+	std::shared_ptr<VKDescriptorSetLayout> _resolveDescriptorSetLayout;
+	std::shared_ptr<VKDescriptorSetLayout> _reduceDescriptorSetLayout;
+
+	std::shared_ptr<VKPipelineLayout> _resolvePipelineLayout;
+	std::shared_ptr<VKPipelineLayout> _reducePipelineLayout;
+
+	std::shared_ptr<VKComputePipeline> _resolvePipeline;
+	std::shared_ptr<VKComputePipeline> _reducePipeline;
+
+	std::shared_ptr<VKSampler> _depthSampler;
+
+	std::shared_ptr<VKImage> _depthPyramidImage;
+
+	DepthPyramidPassOutput onRender(const std::shared_ptr<VKCommandBuffer>& commandBuffer, DepthPyramidPassInput& input) override;
+	void onResize() override;
+
+	void createDescriptorSetLayouts();
+	void createPipelineLayouts();
+	void createPipelines();
+	void createSampler();
+	void createImage();
+};
+}
\ No newline at end of file
@@ -2,24 +2,25 @@
 
 #include <Cyph3D/Asset/AssetManager.h>
 #include <Cyph3D/Asset/BindlessTextureManager.h>
-#include <Cyph3D/Asset/RuntimeAsset/MaterialAsset.h>
-#include <Cyph3D/Asset/RuntimeAsset/MeshAsset.h>
+#include <Cyph3D/Asset/MaterialRegistry.h>
 #include <Cyph3D/Engine.h>
 #include <Cyph3D/Helper/FileHelper.h>
-#include <Cyph3D/Helper/MathHelper.h>
+#include <Cyph3D/Rendering/IndirectDrawGenerator.h>
+#include <Cyph3D/Rendering/ObjectTable.h>
 #include <Cyph3D/Rendering/RenderRegistry.h>
 #include <Cyph3D/Rendering/SceneRenderer/SceneRenderer.h>
 #include <Cyph3D/Scene/Camera.h>
-#include <Cyph3D/Scene/Transform.h>
 #include <Cyph3D/VKObject/Buffer/VKResizableBuffer.h>
+#include <Cyph3D/VKObject/CommandBuffer/VKCommandBuffer.h>
 #include <Cyph3D/VKObject/DescriptorSet/VKDescriptorSet.h>
 #include <Cyph3D/VKObject/DescriptorSet/VKDescriptorSetLayout.h>
 #include <Cyph3D/VKObject/Image/VKImage.h>
+#include <Cyph3D/VKObject/Pipeline/VKComputePipeline.h>
 #include <Cyph3D/VKObject/Pipeline/VKGraphicsPipeline.h>
 #include <Cyph3D/VKObject/Pipeline/VKPipelineLayout.h>
 #include <Cyph3D/VKObject/Sampler/VKSampler.h>
 
-#include <glm/gtc/matrix_inverse.hpp>
+#include <cmath>
 
 c3d::LightingPass::LightingPass(glm::uvec2 size):
 	RenderPass(size, "Lighting pass")
@@ -27,9 +28,11 @@ c3d::LightingPass::LightingPass(glm::uvec2 size):
 	createUniformBuffers();
 	createSamplers();
 	createDescriptorSetLayouts();
-	createPipelineLayout();
-	createPipeline();
+	createDescriptorSets();
+	createPipelineLayouts();
+	createPipelines();
 	createImage();
+	createClusterBuffers();
 }
 
 c3d::LightingPassOutput c3d::LightingPass::onRender(const std::shared_ptr<VKCommandBuffer>& commandBuffer, LightingPassInput& input)
@@ -51,10 +54,10 @@ c3d::LightingPassOutput c3d::LightingPass::onRender(const std::shared_ptr<VKComm
 		);
 	}
 
-	for (const PointShadowMapInfo& info : input.pointShadowMapInfos)
+	if (input.pointShadowAtlas)
 	{
 		commandBuffer->imageMemoryBarrier(
-			info.image,
+			input.pointShadowAtlas,
 			vk::PipelineStageFlagBits2::eFragmentShader,
 			vk::AccessFlagBits2::eShaderSampledRead,
 			vk::ImageLayout::eReadOnlyOptimal
@@ -68,16 +71,18 @@ c3d::LightingPassOutput c3d::LightingPass::onRender(const std::shared_ptr<VKComm
 		vk::ImageLayout::eColorAttachmentOptimal
 	);
 
-	descriptorSetsResizeSmart(input.directionalShadowMapInfos.size(), input.pointShadowMapInfos.size());
+	descriptorSetsResizeSmart(input.directionalShadowMapInfos.size());
 
-	_directionalLightsUniforms->resizeSmart(input.registry.getDirectionalLightRenderRequests().size());
+	const RenderProxyList<DirectionalLight::RenderData>& directionalLights = input.registry.getDirectionalLights();
+	_directionalLightsUniforms->resizeSmart(directionalLights.getSize());
 	uint32_t directionalLightShadowIndex = 0;
-	for (int i = 0; i < input.registry.getDirectionalLightRenderRequests().size(); i++)
+	for (int i = 0; i < directionalLights.getSize(); i++)
 	{
-		const DirectionalLight::RenderData& light = input.registry.getDirectionalLightRenderRequests()[i];
+		const DirectionalLight::RenderData& light = directionalLights.getData()[i];
 
 		DirectionalLightUniforms* directionalLightUniformsPtr = _directionalLightsUniforms->getHostPointer() + i;
-		directionalLightUniformsPtr->fragToLightDirection = light.transform.getUp();
+		// Local up axis in world space
+		directionalLightUniformsPtr->fragToLightDirection = glm::normalize(glm::vec3(directionalLights.getLocalToWorldMatrices()[i][1]));
 		directionalLightUniformsPtr->intensity = light.intensity;
 		directionalLightUniformsPtr->color = light.color;
 		directionalLightUniformsPtr->castShadows = light.castShadows;
@@ -85,43 +90,116 @@ c3d::LightingPassOutput c3d::LightingPass::onRender(const std::shared_ptr<VKComm
 		{
 			const DirectionalShadowMapInfo& shadowMapInfo = input.directionalShadowMapInfos[directionalLightShadowIndex];
 
-			directionalLightUniformsPtr->lightViewProjection = shadowMapInfo.viewProjection;
+			for (int j = 0; j < SceneRenderer::DIRECTIONAL_SHADOW_MAP_CASCADE_COUNT; j++)
+			{
+				directionalLightUniformsPtr->lightViewProjections[j] = shadowMapInfo.viewProjections[j];
+				directionalLightUniformsPtr->shadowMapTexelWorldSizes[j] = shadowMapInfo.worldSizes[j] / light.shadowMapResolution;
+				directionalLightUniformsPtr->cascadeFarDepths[j] = shadowMapInfo.cascadeFarDepths[j];
+			}
 			directionalLightUniformsPtr->textureIndex = directionalLightShadowIndex;
-			directionalLightUniformsPtr->shadowMapTexelWorldSize = shadowMapInfo.worldSize / light.shadowMapResolution;
 
-			_directionalLightDescriptorSet->bindDescriptor(1, shadowMapInfo.image, _directionalLightSampler, directionalLightShadowIndex);
+			_directionalLightDescriptorSet->bindDescriptor(
+				1,
+				shadowMapInfo.image,
+				vk::ImageViewType::e2DArray,
+				{0, SceneRenderer::DIRECTIONAL_SHADOW_MAP_CASCADE_COUNT - 1},
+				{0, 0},
+				shadowMapInfo.image->getInfo().getFormat(),
+				_directionalLightSampler,
+				directionalLightShadowIndex
+			);
 
 			directionalLightShadowIndex++;
 		}
 	}
-	if (!input.registry.getDirectionalLightRenderRequests().empty())
-		_directionalLightDescriptorSet->bindDescriptor(0, _directionalLightsUniforms.getCurrent()->getBuffer(), 0, input.registry.getDirectionalLightRenderRequests().size());
+	if (!directionalLights.isEmpty())
+		_directionalLightDescriptorSet->bindDescriptor(0, _directionalLightsUniforms.getCurrent()->getBuffer(), 0, directionalLights.getSize());
 
-	_pointLightsUniforms->resizeSmart(input.registry.getPointLightRenderRequests().size());
+	const RenderProxyList<PointLight::RenderData>& pointLights = input.registry.getPointLights();
+	_pointLightsUniforms->resizeSmart(pointLights.getSize());
 	uint32_t pointLightShadowIndex = 0;
-	for (int i = 0; i < input.registry.getPointLightRenderRequests().size(); i++)
+	for (int i = 0; i < pointLights.getSize(); i++)
 	{
-		const PointLight::RenderData& light = input.registry.getPointLightRenderRequests()[i];
+		const PointLight::RenderData& light = pointLights.getData()[i];
 
 		PointLightUniforms* pointLightUniformsPtr = _pointLightsUniforms->getHostPointer() + i;
-		pointLightUniformsPtr->pos = light.transform.getWorldPosition();
+		pointLightUniformsPtr->pos = glm::vec3(pointLights.getLocalToWorldMatrices()[i][3]);
 		pointLightUniformsPtr->intensity = light.intensity;
 		pointLightUniformsPtr->color = light.color;
-		pointLightUniformsPtr->castShadows = light.castShadows;
+		pointLightUniformsPtr->castShadows = false;
+		pointLightUniformsPtr->range = light.range;
 		if (light.castShadows)
 		{
 			const PointShadowMapInfo& shadowMapInfo = input.pointShadowMapInfos[pointLightShadowIndex];
 
-			pointLightUniformsPtr->textureIndex = pointLightShadowIndex;
-			pointLightUniformsPtr->maxTexelSizeAtUnitDistance = 2.0f / light.shadowMapResolution;
-
-			_pointLightDescriptorSet->bindDescriptor(1, shadowMapInfo.image, _pointLightSampler, pointLightShadowIndex);
+			// Lights that did not fit in the atlas cast no shadow
+			if (shadowMapInfo.faceSize > 0)
+			{
+				pointLightUniformsPtr->castShadows = true;
+				pointLightUniformsPtr->shadowMapFaceOffsets = shadowMapInfo.faceOffsets;
+				pointLightUniformsPtr->shadowMapFaceSize = shadowMapInfo.faceSize;
+				pointLightUniformsPtr->maxTexelSizeAtUnitDistance = 2.0f / shadowMapInfo.faceSize;
+			}
 
 			pointLightShadowIndex++;
 		}
 	}
-	if (!input.registry.getPointLightRenderRequests().empty())
-		_pointLightDescriptorSet->bindDescriptor(0, _pointLightsUniforms.getCurrent()->getBuffer(), 0, input.registry.getPointLightRenderRequests().size());
+	if (!pointLights.isEmpty())
+		_pointLightDescriptorSet->bindDescriptor(0, _pointLightsUniforms.getCurrent()->getBuffer(), 0, pointLights.getSize());
+	if (input.pointShadowAtlas)
+		_pointLightDescriptorSet->bindDescriptor(1, input.pointShadowAtlas, _pointLightSampler);
+
+	glm::mat4 view = input.camera.getView();
+	glm::mat4 projection = input.camera.getProjection();
+
+	if (!pointLights.isEmpty())
+	{
+		commandBuffer->bufferMemoryBarrier(
+			_clusterLightCountBuffer,
+			vk::PipelineStageFlagBits2::eComputeShader,
+			vk::AccessFlagBits2::eShaderStorageWrite
+		);
+
+		commandBuffer->bufferMemoryBarrier(
+			_clusterLightIndexBuffer,
+			vk::PipelineStageFlagBits2::eComputeShader,
+			vk::AccessFlagBits2::eShaderStorageWrite
+		);
+
+		commandBuffer->bindPipeline(_clusterPipeline);
+
+		commandBuffer->pushDescriptor(0, 0, _pointLightsUniforms.getCurrent()->getBuffer(), 0, pointLights.getSize());
+		commandBuffer->pushDescriptor(0, 1, _clusterLightCountBuffer, 0, _clusterLightCountBuffer->getInfo().getSize());
+		commandBuffer->pushDescriptor(0, 2, _clusterLightIndexBuffer, 0, _clusterLightIndexBuffer->getInfo().getSize());
+
+		ClusterPushConstantData clusterPushConstantData{
+			.view = view,
+			.tanHalfFov = glm::vec2(1.0f / projection[0][0], 1.0f / glm::abs(projection[1][1])),
+			.screenSize = _size,
+			.clusterCount = _clusterCount,
+			.cameraNear = Camera::NEAR_DISTANCE,
+			.cameraFar = Camera::FAR_DISTANCE,
+			.pointLightCount = static_cast<uint32_t>(pointLights.getSize())
+		};
+		commandBuffer->pushConstants(clusterPushConstantData);
+
+		uint32_t clusterCount = _clusterCount.x * _clusterCount.y * CLUSTER_DEPTH_SLICES;
+		commandBuffer->dispatch({(clusterCount + 63) / 64, 1, 1});
+
+		commandBuffer->unbindPipeline();
+
+		commandBuffer->bufferMemoryBarrier(
+			_clusterLightCountBuffer,
+			vk::PipelineStageFlagBits2::eFragmentShader,
+			vk::AccessFlagBits2::eShaderStorageRead
+		);
+
+		commandBuffer->bufferMemoryBarrier(
+			_clusterLightIndexBuffer,
+			vk::PipelineStageFlagBits2::eFragmentShader,
+			vk::AccessFlagBits2::eShaderStorageRead
+		);
+	}
 
 	VKRenderingInfo renderingInfo(_size);
 
@@ -153,47 +231,33 @@ c3d::LightingPassOutput c3d::LightingPass::onRender(const std::shared_ptr<VKComm
 	commandBuffer->bindDescriptorSet(2, _pointLightDescriptorSet.getCurrent());
 
 	PushConstantData pushConstantData{};
+	pushConstantData.viewProjection = projection * view;
 	pushConstantData.viewPos = input.camera.getPosition();
 	pushConstantData.frameIndex = _frameIndex;
-	pushConstantData.directionalLightCount = input.registry.getDirectionalLightRenderRequests().size();
-	pushConstantData.pointLightCount = input.registry.getPointLightRenderRequests().size();
+	pushConstantData.directionalLightCount = directionalLights.getSize();
+	pushConstantData.pointLightCount = pointLights.getSize();
 	pushConstantData.pointLightMaxDistance = input.pointLightMaxDistance;
+	// Maps the log of the view depth to the exponentially distributed depth slices
+	pushConstantData.clusterCount = _clusterCount;
+	pushConstantData.clusterDepthScale = CLUSTER_DEPTH_SLICES / std::log(Camera::FAR_DISTANCE / Camera::NEAR_DISTANCE);
+	pushConstantData.clusterDepthBias = -pushConstantData.clusterDepthScale * std::log(Camera::NEAR_DISTANCE);
+	pushConstantData.cameraNear = Camera::NEAR_DISTANCE;
+	pushConstantData.cameraFar = Camera::FAR_DISTANCE;
 	commandBuffer->pushConstants(pushConstantData);
 
-	glm::mat4 viewProjection = input.camera.getProjection() * input.camera.getView();
+	if (input.objectTable.getObjectCount() > 0)
+	{
+		commandBuffer->pushDescriptor(3, 0, input.objectTable.getBuffer(), 0, input.objectTable.getObjectCount());
+		const std::shared_ptr<VKBuffer<MaterialRegistry::MaterialData>>& materialBuffer = Engine::getAssetManager().getMaterialRegistry().getBuffer();
+		commandBuffer->pushDescriptor(3, 1, materialBuffer, 0, materialBuffer->getInfo().getSize());
+		commandBuffer->pushDescriptor(3, 2, _clusterLightCountBuffer, 0, _clusterLightCountBuffer->getInfo().getSize());
+		commandBuffer->pushDescriptor(3, 3, _clusterLightIndexBuffer, 0, _clusterLightIndexBuffer->getInfo().getSize());
+	}
 
-	_objectUniforms->resizeSmart(input.registry.getModelRenderRequests().size());
-	for (int i = 0; i < input.registry.getModelRenderRequests().size(); i++)
+	// Each draw of a multi-draw is its own invocation group, so the shader can index textures without nonuniformEXT
+	for (uint32_t i = 0; i < input.drawGenerator.getViewCount(); i++)
 	{
-		ModelRenderer::RenderData model = input.registry.getModelRenderRequests()[i];
-
-		const std::shared_ptr<VKBuffer<PositionVertexData>>& positionVertexBuffer = model.mesh.getPositionVertexBuffer();
-		const std::shared_ptr<VKBuffer<MaterialVertexData>>& materialVertexBuffer = model.mesh.getMaterialVertexBuffer();
-		const std::shared_ptr<VKBuffer<uint32_t>>& indexBuffer = model.mesh.getIndexBuffer();
-
-		commandBuffer->bindVertexBuffer(0, positionVertexBuffer);
-		commandBuffer->bindVertexBuffer(1, materialVertexBuffer);
-		commandBuffer->bindIndexBuffer(indexBuffer);
-
-		ObjectUniforms* objectUniformsPtr = _objectUniforms->getHostPointer() + i;
-		objectUniformsPtr->normalMatrix = glm::inverseTranspose(glm::mat3(model.transform.getLocalToWorldMatrix()));
-		objectUniformsPtr->model = model.transform.getLocalToWorldMatrix();
-		objectUniformsPtr->mvp = viewProjection * model.transform.getLocalToWorldMatrix();
-		objectUniformsPtr->albedoIndex = model.material.getAlbedoTextureBindlessIndex();
-		objectUniformsPtr->normalIndex = model.material.getNormalTextureBindlessIndex();
-		objectUniformsPtr->roughnessIndex = model.material.getRoughnessTextureBindlessIndex();
-		objectUniformsPtr->metalnessIndex = model.material.getMetalnessTextureBindlessIndex();
-		objectUniformsPtr->displacementIndex = model.material.getDisplacementTextureBindlessIndex();
-		objectUniformsPtr->emissiveIndex = model.material.getEmissiveTextureBindlessIndex();
-		objectUniformsPtr->albedoValue = MathHelper::srgbToLinear(model.material.getAlbedoValue());
-		objectUniformsPtr->roughnessValue = model.material.getRoughnessValue();
-		objectUniformsPtr->metalnessValue = model.material.getMetalnessValue();
-		objectUniformsPtr->displacementScale = model.material.getDisplacementScale();
-		objectUniformsPtr->emissiveScale = model.material.getEmissiveScale();
-
-		commandBuffer->pushDescriptor(3, 0, _objectUniforms.getCurrent()->getBuffer(), i, 1);
-
-		commandBuffer->drawIndexed(indexBuffer->getInfo().getSize(), 0, 0);
+		input.drawGenerator.draw(commandBuffer, i, true);
 	}
 
 	commandBuffer->unbindPipeline();
@@ -210,6 +274,7 @@ c3d::LightingPassOutput c3d::LightingPass::onRender(const std::shared_ptr<VKComm
 void c3d::LightingPass::onResize()
 {
 	createImage();
+	createClusterBuffers();
 }
 
 void c3d::LightingPass::createUniformBuffers()
@@ -241,20 +306,6 @@ void c3d::LightingPass::createUniformBuffers()
 			return VKResizableBuffer<PointLightUniforms>::create(context, pointLightsUniformsBufferInfo);
 		}
 	);
-
-	VKResizableBufferInfo objectUniformsBufferInfo(vk::BufferUsageFlagBits::eStorageBuffer);
-	objectUniformsBufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eDeviceLocal);
-	objectUniformsBufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostVisible);
-	objectUniformsBufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostCoherent);
-	objectUniformsBufferInfo.setName("Objects uniform buffer");
-
-	_objectUniforms = VKDynamic<VKResizableBuffer<ObjectUniforms>>(
-		Engine::getVKContext(),
-		[&](VKContext& context, int index)
-		{
-			return VKResizableBuffer<ObjectUniforms>::create(context, objectUniformsBufferInfo);
-		}
-	);
 }
 
 void c3d::LightingPass::createSamplers()
@@ -317,7 +368,8 @@ void c3d::LightingPass::createDescriptorSetLayouts()
 	{
 		VKDescriptorSetLayoutInfo info(false);
 		info.addBinding(vk::DescriptorType::eStorageBuffer, 1);
-		info.addIndexedBinding(vk::DescriptorType::eCombinedImageSampler, 1024);
+		// Partially bound, the atlas only exists once a point light casts shadows
+		info.addIndexedBinding(vk::DescriptorType::eCombinedImageSampler, 1);
 
 		_pointLightDescriptorSetLayout = VKDescriptorSetLayout::create(Engine::getVKContext(), info);
 	}
@@ -325,48 +377,95 @@ void c3d::LightingPass::createDescriptorSetLayouts()
 	{
 		VKDescriptorSetLayoutInfo info(true);
 		info.addBinding(vk::DescriptorType::eStorageBuffer, 1);
+		info.addBinding(vk::DescriptorType::eStorageBuffer, 1);
+		info.addBinding(vk::DescriptorType::eStorageBuffer, 1);
+		info.addBinding(vk::DescriptorType::eStorageBuffer, 1);
 
 		_objectDescriptorSetLayout = VKDescriptorSetLayout::create(Engine::getVKContext(), info);
 	}
+
+	{
+		VKDescriptorSetLayoutInfo info(true);
+		info.addBinding(vk::DescriptorType::eStorageBuffer, 1);
+		info.addBinding(vk::DescriptorType::eStorageBuffer, 1);
+		info.addBinding(vk::DescriptorType::eStorageBuffer, 1);
+
+		_clusterDescriptorSetLayout = VKDescriptorSetLayout::create(Engine::getVKContext(), info);
+	}
 }
 
-void c3d::LightingPass::createPipelineLayout()
+void c3d::LightingPass::createDescriptorSets()
 {
-	VKPipelineLayoutInfo info;
-	info.addDescriptorSetLayout(Engine::getAssetManager().getBindlessTextureManager().getDescriptorSetLayout());
-	info.addDescriptorSetLayout(_directionalLightDescriptorSetLayout);
-	info.addDescriptorSetLayout(_pointLightDescriptorSetLayout);
-	info.addDescriptorSetLayout(_objectDescriptorSetLayout);
-	info.setPushConstantLayout<PushConstantData>();
-
-	_pipelineLayout = VKPipelineLayout::create(Engine::getVKContext(), info);
+	VKDescriptorSetInfo info(_pointLightDescriptorSetLayout);
+	info.setVariableSizeAllocatedCount(1);
+
+	_pointLightDescriptorSet = VKDynamic<VKDescriptorSet>(
+		Engine::getVKContext(),
+		[&](VKContext& context, int index)
+		{
+			return VKDescriptorSet::create(context, info);
+		}
+	);
 }
 
-void c3d::LightingPass::createPipeline()
+void c3d::LightingPass::createPipelineLayouts()
 {
-	VKGraphicsPipelineInfo info(
-		_pipelineLayout,
-		"lighting/lighting.vert",
-		vk::PrimitiveTopology::eTriangleList,
-		vk::CullModeFlagBits::eBack,
-		vk::FrontFace::eCounterClockwise
-	);
+	{
+		VKPipelineLayoutInfo info;
+		info.addDescriptorSetLayout(Engine::getAssetManager().getBindlessTextureManager().getDescriptorSetLayout());
+		info.addDescriptorSetLayout(_directionalLightDescriptorSetLayout);
+		info.addDescriptorSetLayout(_pointLightDescriptorSetLayout);
+		info.addDescriptorSetLayout(_objectDescriptorSetLayout);
+		info.setPushConstantLayout<PushConstantData>();
+
+		_pipelineLayout = VKPipelineLayout::create(Engine::getVKContext(), info);
+	}
+
+	{
+		VKPipelineLayoutInfo info;
+		info.addDescriptorSetLayout(_clusterDescriptorSetLayout);
+		info.setPushConstantLayout<ClusterPushConstantData>();
+
+		_clusterPipelineLayout = VKPipelineLayout::create(Engine::getVKContext(), info);
+	}
+}
+
+void c3d::LightingPass::createPipelines()
+{
+	{
+		VKComputePipelineInfo info(
+			_clusterPipelineLayout,
+			"lighting/cluster point lights.comp"
+		);
+
+		_clusterPipeline = VKComputePipeline::create(Engine::getVKContext(), info);
+	}
+
+	{
+		VKGraphicsPipelineInfo info(
+			_pipelineLayout,
+			"lighting/lighting.vert",
+			vk::PrimitiveTopology::eTriangleList,
+			vk::CullModeFlagBits::eBack,
+			vk::FrontFace::eCounterClockwise
+		);
 
-	info.setFragmentShader("lighting/lighting.frag");
+		info.setFragmentShader("lighting/lighting.frag");
 
-	info.getVertexInputLayoutInfo().defineSlot(0, sizeof(PositionVertexData), vk::VertexInputRate::eVertex);
-	info.getVertexInputLayoutInfo().defineSlot(1, sizeof(MaterialVertexData), vk::VertexInputRate::eVertex);
-	info.getVertexInputLayoutInfo().defineAttribute(0, 0, vk::Format::eR32G32B32Sfloat, offsetof(PositionVertexData, position));
-	info.getVertexInputLayoutInfo().defineAttribute(1, 1, vk::Format::eR32G32Sfloat, offsetof(MaterialVertexData, uv));
-	info.getVertexInputLayoutInfo().defineAttribute(1, 2, vk::Format::eR32G32B32Sfloat, offsetof(MaterialVertexData, normal));
-	info.getVertexInputLayoutInfo().defineAttribute(1, 3, vk::Format::eR32G32B32A32Sfloat, offsetof(MaterialVertexData, tangent));
+		info.getVertexInputLayoutInfo().defineSlot(0, sizeof(PositionVertexData), vk::VertexInputRate::eVertex);
+		info.getVertexInputLayoutInfo().defineSlot(1, sizeof(MaterialVertexData), vk::VertexInputRate::eVertex);
+		info.getVertexInputLayoutInfo().defineAttribute(0, 0, vk::Format::eR32G32B32Sfloat, offsetof(PositionVertexData, position));
+		info.getVertexInputLayoutInfo().defineAttribute(1, 1, vk::Format::eR32G32Sfloat, offsetof(MaterialVertexData, uv));
+		info.getVertexInputLayoutInfo().defineAttribute(1, 2, vk::Format::eR32G32B32Sfloat, offsetof(MaterialVertexData, normal));
+		info.getVertexInputLayoutInfo().defineAttribute(1, 3, vk::Format::eR32G32B32A32Sfloat, offsetof(MaterialVertexData, tangent));
 
-	info.setRasterizationSampleCount(vk::SampleCountFlagBits::e4);
+		info.setRasterizationSampleCount(vk::SampleCountFlagBits::e4);
 
-	info.getPipelineAttachmentInfo().addColorAttachment(SceneRenderer::HDR_COLOR_FORMAT);
-	info.getPipelineAttachmentInfo().setDepthAttachment(SceneRenderer::DEPTH_FORMAT, vk::CompareOp::eEqual, false);
+		info.getPipelineAttachmentInfo().addColorAttachment(SceneRenderer::HDR_COLOR_FORMAT);
+		info.getPipelineAttachmentInfo().setDepthAttachment(SceneRenderer::DEPTH_FORMAT, vk::CompareOp::eEqual, false);
 
-	_pipeline = VKGraphicsPipeline::create(Engine::getVKContext(), info);
+		_pipeline = VKGraphicsPipeline::create(Engine::getVKContext(), info);
+	}
 }
 
 void c3d::LightingPass::createImage()
@@ -385,42 +484,43 @@ void c3d::LightingPass::createImage()
 	_multisampledRawRenderImage = VKImage::create(Engine::getVKContext(), imageInfo);
 }
 
-void c3d::LightingPass::descriptorSetsResizeSmart(uint32_t directionalLightShadowsCount, uint32_t pointLightShadowsCount)
+void c3d::LightingPass::createClusterBuffers()
 {
-	if (!_directionalLightDescriptorSet || _directionalLightDescriptorSet->getInfo().getVariableSizeAllocatedCount() < directionalLightShadowsCount)
+	_clusterCount = (_size + CLUSTER_TILE_SIZE - 1u) / CLUSTER_TILE_SIZE;
+	uint32_t clusterCount = _clusterCount.x * _clusterCount.y * CLUSTER_DEPTH_SLICES;
+
 	{
-		// resize to next power of 2
-		size_t tentativeCount = 1;
-		while (tentativeCount < directionalLightShadowsCount)
-		{
-			tentativeCount *= 2;
-		}
+		VKBufferInfo bufferInfo(clusterCount, vk::BufferUsageFlagBits::eStorageBuffer);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eDeviceLocal);
+		bufferInfo.setName("Cluster light count buffer");
 
-		VKDescriptorSetInfo info(_directionalLightDescriptorSetLayout);
-		info.setVariableSizeAllocatedCount(tentativeCount);
+		_clusterLightCountBuffer = VKBuffer<uint32_t>::create(Engine::getVKContext(), bufferInfo);
+	}
 
-		_directionalLightDescriptorSet = VKDynamic<VKDescriptorSet>(
-			Engine::getVKContext(),
-			[&](VKContext& context, int index)
-			{
-				return VKDescriptorSet::create(context, info);
-			}
-		);
+	{
+		VKBufferInfo bufferInfo(clusterCount * MAX_LIGHTS_PER_CLUSTER, vk::BufferUsageFlagBits::eStorageBuffer);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eDeviceLocal);
+		bufferInfo.setName("Cluster light index buffer");
+
+		_clusterLightIndexBuffer = VKBuffer<uint32_t>::create(Engine::getVKContext(), bufferInfo);
 	}
+}
 
-	if (!_pointLightDescriptorSet || _pointLightDescriptorSet->getInfo().getVariableSizeAllocatedCount() < pointLightShadowsCount)
+void c3d::LightingPass::descriptorSetsResizeSmart(uint32_t directionalLightShadowsCount)
+{
+	if (!_directionalLightDescriptorSet || _directionalLightDescriptorSet->getInfo().getVariableSizeAllocatedCount() < directionalLightShadowsCount)
 	{
 		// resize to next power of 2
 		size_t tentativeCount = 1;
-		while (tentativeCount < pointLightShadowsCount)
+		while (tentativeCount < directionalLightShadowsCount)
 		{
 			tentativeCount *= 2;
 		}
 
-		VKDescriptorSetInfo info(_pointLightDescriptorSetLayout);
+		VKDescriptorSetInfo info(_directionalLightDescriptorSetLayout);
 		info.setVariableSizeAllocatedCount(tentativeCount);
 
-		_pointLightDescriptorSet = VKDynamic<VKDescriptorSet>(
+		_directionalLightDescriptorSet = VKDynamic<VKDescriptorSet>(
 			Engine::getVKContext(),
 			[&](VKContext& context, int index)
 			{
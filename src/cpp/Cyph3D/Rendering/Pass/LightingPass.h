@@ -8,20 +8,30 @@ namespace c3d
 {
 class RenderRegistry;
 class Camera;
+class IndirectDrawGenerator;
+class ObjectTable;
 class VKPipelineLayout;
 class VKGraphicsPipeline;
+class VKComputePipeline;
 class VKDescriptorSetLayout;
 class VKImage;
 template<typename T>
+class VKBuffer;
+template<typename T>
 class VKResizableBuffer;
 
 struct LightingPassInput
 {
 	const std::shared_ptr<VKImage>& multisampledDepthImage;
 	const RenderRegistry& registry;
+	const ObjectTable& objectTable;
+	// Draws of the camera view, every view index being drawn
+	const IndirectDrawGenerator& drawGenerator;
 	Camera& camera;
 	const std::vector<DirectionalShadowMapInfo>& directionalShadowMapInfos;
 	const std::vector<PointShadowMapInfo>& pointShadowMapInfos;
+	// nullptr until a point light first casts shadows
+	const std::shared_ptr<VKImage>& pointShadowAtlas;
 	float pointLightMaxDistance;
 };
 
@@ -30,21 +40,29 @@ struct LightingPassOutput
 	const std::shared_ptr<VKImage>& multisampledRawRenderImage;
 };
 
+// Point lights are first binned into view space clusters made of screen tiles and exponentially distributed depth slices,
+// each fragment then only shades the lights reaching its cluster. A point light reaches up to PointLight::getRange().
 class LightingPass : public RenderPass<LightingPassInput, LightingPassOutput>
 {
 public:
 	explicit LightingPass(glm::uvec2 size);
 
 private:
+	// Must match common/point lights.glsl
+	static constexpr uint32_t CLUSTER_TILE_SIZE = 64;
+	static constexpr uint32_t CLUSTER_DEPTH_SLICES = 24;
+	static constexpr uint32_t MAX_LIGHTS_PER_CLUSTER = 256;
+
 	struct DirectionalLightUniforms
 	{
 		glm::vec3 fragToLightDirection;
 		float intensity;
 		glm::vec3 color;
 		vk::Bool32 castShadows;
-		glm::mat4 lightViewProjection;
+		std::array<glm::mat4, SceneRenderer::DIRECTIONAL_SHADOW_MAP_CASCADE_COUNT> lightViewProjections;
+		std::array<float, SceneRenderer::DIRECTIONAL_SHADOW_MAP_CASCADE_COUNT> shadowMapTexelWorldSizes;
+		std::array<float, SceneRenderer::DIRECTIONAL_SHADOW_MAP_CASCADE_COUNT> cascadeFarDepths;
 		uint32_t textureIndex;
-		float shadowMapTexelWorldSize;
 	};
 
 	struct PointLightUniforms
@@ -53,43 +71,41 @@ private:
 		float intensity;
 		glm::vec3 color;
 		vk::Bool32 castShadows;
-		uint32_t textureIndex;
+		std::array<glm::uvec2, 6> shadowMapFaceOffsets;
+		uint32_t shadowMapFaceSize;
 		float maxTexelSizeAtUnitDistance;
-	};
-
-	//FIXME: properly align storage buffer offset
-	struct alignas(16) ObjectUniforms
-	{
-		glm::mat4 normalMatrix;
-		glm::mat4 model;
-		glm::mat4 mvp;
-		int32_t albedoIndex;
-		int32_t normalIndex;
-		int32_t roughnessIndex;
-		int32_t metalnessIndex;
-		int32_t displacementIndex;
-		int32_t emissiveIndex;
-		glm::vec3 albedoValue;
-		float roughnessValue;
-		float metalnessValue;
-		float displacementScale;
-		float emissiveScale;
+		float range;
 	};
 
 	struct PushConstantData
 	{
+		glm::mat4 viewProjection;
 		glm::vec3 viewPos;
 		uint32_t frameIndex;
 		int32_t directionalLightCount;
 		int32_t pointLightCount;
 		float pointLightMaxDistance;
+		glm::uvec2 clusterCount;
+		float clusterDepthScale;
+		float clusterDepthBias;
+		float cameraNear;
+		float cameraFar;
+	};
+
+	struct ClusterPushConstantData
+	{
+		glm::mat4 view;
+		glm::vec2 tanHalfFov;
+		glm::vec2 screenSize;
+		glm::uvec2 clusterCount;
+		float cameraNear;
+		float cameraFar;
+		uint32_t pointLightCount;
 	};
 
 	VKDynamic<VKResizableBuffer<DirectionalLightUniforms>> _directionalLightsUniforms;
 	VKDynamic<VKResizableBuffer<PointLightUniforms>> _pointLightsUniforms;
 
-	VKDynamic<VKResizableBuffer<ObjectUniforms>> _objectUniforms;
-
 	std::shared_ptr<VKSampler> _directionalLightSampler;
 	std::shared_ptr<VKSampler> _pointLightSampler;
 
@@ -99,12 +115,20 @@ private:
 	VKDynamic<VKDescriptorSet> _pointLightDescriptorSet;
 
 	std::shared_ptr<VKDescriptorSetLayout> _objectDescriptorSetLayout;
+	std::shared_ptr<VKDescriptorSetLayout> _clusterDescriptorSetLayout;
 
 	std::shared_ptr<VKPipelineLayout> _pipelineLayout;
 	std::shared_ptr<VKGraphicsPipeline> _pipeline;
 
+	std::shared_ptr<VKPipelineLayout> _clusterPipelineLayout;
+	std::shared_ptr<VKComputePipeline> _clusterPipeline;
+
 	std::shared_ptr<VKImage> _multisampledRawRenderImage;
 
+	glm::uvec2 _clusterCount;
+	std::shared_ptr<VKBuffer<uint32_t>> _clusterLightCountBuffer;
+	std::shared_ptr<VKBuffer<uint32_t>> _clusterLightIndexBuffer;
+
 	uint32_t _frameIndex = 0;
 
 	LightingPassOutput onRender(const std::shared_ptr<VKCommandBuffer>& commandBuffer, LightingPassInput& input) override;
@@ -113,10 +137,12 @@ private:
 	void createUniformBuffers();
 	void createSamplers();
 	void createDescriptorSetLayouts();
-	void createPipelineLayout();
-	void createPipeline();
+	void createDescriptorSets();
+	void createPipelineLayouts();
+	void createPipelines();
 	void createImage();
+	void createClusterBuffers();
 
-	void descriptorSetsResizeSmart(uint32_t directionalLightShadowsCount, uint32_t pointLightShadowsCount);
+	void descriptorSetsResizeSmart(uint32_t directionalLightShadowsCount);
 };
 }
\ No newline at end of file
@@ -2,16 +2,16 @@
 
 #include <Cyph3D/Asset/AssetManager.h>
 #include <Cyph3D/Asset/BindlessTextureManager.h>
+#include <Cyph3D/Asset/MaterialRegistry.h>
 #include <Cyph3D/Asset/RuntimeAsset/MaterialAsset.h>
 #include <Cyph3D/Asset/RuntimeAsset/MeshAsset.h>
 #include <Cyph3D/Engine.h>
+#include <Cyph3D/Helper/AffineMathHelper.h>
 #include <Cyph3D/Helper/FileHelper.h>
-#include <Cyph3D/Helper/MathHelper.h>
 #include <Cyph3D/Rendering/RenderRegistry.h>
 #include <Cyph3D/Rendering/SceneRenderer/SceneRenderer.h>
 #include <Cyph3D/Scene/Camera.h>
 #include <Cyph3D/Scene/Scene.h>
-#include <Cyph3D/Scene/Transform.h>
 #include <Cyph3D/VKObject/AccelerationStructure/VKAccelerationStructure.h>
 #include <Cyph3D/VKObject/Buffer/VKBuffer.h>
 #include <Cyph3D/VKObject/Buffer/VKResizableBuffer.h>
@@ -23,8 +23,8 @@
 #include <Cyph3D/VKObject/ShaderBindingTable/VKShaderBindingTable.h>
 #include <Cyph3D/VKObject/VKHelper.h>
 
-#include <glm/gtc/matrix_inverse.hpp>
 #include <glm/gtx/transform.hpp>
+#include <vector>
 
 c3d::PathTracePass::PathTracePass(const glm::uvec2& size):
 	RenderPass(size, "Path trace pass")
@@ -37,7 +37,12 @@ c3d::PathTracePass::PathTracePass(const glm::uvec2& size):
 
 c3d::PathTracePassOutput c3d::PathTracePass::onRender(const std::shared_ptr<VKCommandBuffer>& commandBuffer, PathTracePassInput& input)
 {
-	if (input.sceneChanged || input.cameraChanged)
+	// Lights are not used by the path tracer, only emissive materials are
+	SceneChangeFlags geometryChanges = SceneChangeFlags::eTransform | SceneChangeFlags::eModel | SceneChangeFlags::eHierarchy;
+	bool sbtChanged = input.sceneChanges.contains(geometryChanges | SceneChangeFlags::eSkybox) || input.cameraChanged;
+
+	// Material parameters are read from the MaterialRegistry at trace time, only the accumulation is affected
+	if (sbtChanged || input.sceneChanges.contains(SceneChangeFlags::eMaterial))
 	{
 		_accumulatedSamples = 0;
 	}
@@ -54,14 +59,14 @@ c3d::PathTracePassOutput c3d::PathTracePass::onRender(const std::shared_ptr<VKCo
 
 	bool recreateDescriptorSet = false;
 
-	if (input.sceneChanged)
+	if (input.sceneChanges.contains(geometryChanges))
 	{
 		setupTLAS(commandBuffer, input);
 
 		recreateDescriptorSet = true;
 	}
 
-	if (input.sceneChanged || input.cameraChanged)
+	if (sbtChanged)
 	{
 		setupSBT(commandBuffer, input);
 
@@ -97,8 +102,11 @@ c3d::PathTracePassOutput c3d::PathTracePass::onRender(const std::shared_ptr<VKCo
 	commandBuffer->bindDescriptorSet(0, Engine::getAssetManager().getBindlessTextureManager().getDescriptorSet());
 	commandBuffer->bindDescriptorSet(1, _descriptorSet);
 
+	const std::shared_ptr<VKBuffer<MaterialRegistry::MaterialData>>& materialBuffer = Engine::getAssetManager().getMaterialRegistry().getBuffer();
+
 	FramePushConstants framePushConstants{
 		.topLevelAS = std::bit_cast<glm::uvec2>(_tlas->getDeviceAddress()),
+		.materialBuffer = materialBuffer->getDeviceAddress(),
 		.batchIndex = _batchIndex,
 		.sampleCount = input.sampleCount,
 		.resetAccumulation = _accumulatedSamples == 0
@@ -106,6 +114,7 @@ c3d::PathTracePassOutput c3d::PathTracePass::onRender(const std::shared_ptr<VKCo
 
 	commandBuffer->pushConstants(framePushConstants);
 	commandBuffer->addExternallyUsedObject(_tlas);
+	commandBuffer->addExternallyUsedObject(materialBuffer);
 
 	commandBuffer->traceRays(_sbt, _size);
 
@@ -127,17 +136,19 @@ void c3d::PathTracePass::onResize()
 
 void c3d::PathTracePass::setupTLAS(const std::shared_ptr<VKCommandBuffer>& commandBuffer, const PathTracePassInput& input)
 {
+	const RenderProxyList<ModelRenderer::RenderData>& models = input.registry.getModels();
+
 	VKTopLevelAccelerationStructureBuildInfo buildInfo;
-	buildInfo.instancesInfos.reserve(input.registry.getModelRenderRequests().size());
-	for (int i = 0; i < input.registry.getModelRenderRequests().size(); i++)
+	buildInfo.instancesInfos.reserve(models.getSize());
+	for (int i = 0; i < models.getSize(); i++)
 	{
-		const ModelRenderer::RenderData& model = input.registry.getModelRenderRequests()[i];
+		const ModelRenderer::RenderData& model = models.getData()[i];
 
 		VKTopLevelAccelerationStructureBuildInfo::InstanceInfo& instanceInfo = buildInfo.instancesInfos.emplace_back();
-		instanceInfo.localToWorld = model.transform.getLocalToWorldMatrix();
+		instanceInfo.localToWorld = models.getLocalToWorldMatrices()[i];
 		instanceInfo.customIndex = 0;
 		instanceInfo.recordIndex = i;
-		instanceInfo.accelerationStructure = model.mesh.getAccelerationStructure();
+		instanceInfo.accelerationStructure = model.mesh->getAccelerationStructure();
 	}
 
 	vk::AccelerationStructureBuildSizesInfoKHR buildSizesInfo = VKAccelerationStructure::getTopLevelBuildSizesInfo(Engine::getVKContext(), buildInfo);
@@ -187,25 +198,21 @@ void c3d::PathTracePass::setupSBT(const std::shared_ptr<VKCommandBuffer>& comman
 
 	VKShaderBindingTableInfo info(_pipeline->getRaygenGroupHandle(0), rayGenUniforms);
 
-	for (int i = 0; i < input.registry.getModelRenderRequests().size(); i++)
+	const RenderProxyList<ModelRenderer::RenderData>& models = input.registry.getModels();
+
+	std::vector<glm::mat3> normalMatrices(models.getSize());
+	AffineMathHelper::normalMatrix(models.getLocalToWorldMatrices(), normalMatrices);
+
+	for (int i = 0; i < models.getSize(); i++)
 	{
-		const ModelRenderer::RenderData& model = input.registry.getModelRenderRequests()[i];
+		const ModelRenderer::RenderData& model = models.getData()[i];
 
 		RayClosestHitUniforms rayClosestHitUniforms{
-			.normalMatrix = glm::inverseTranspose(glm::mat3(model.transform.getLocalToWorldMatrix())),
-			.positionVertexBuffer = model.mesh.getPositionVertexBuffer()->getDeviceAddress(),
-			.materialVertexBuffer = model.mesh.getMaterialVertexBuffer()->getDeviceAddress(),
-			.indexBuffer = model.mesh.getIndexBuffer()->getDeviceAddress(),
-			.albedoIndex = model.material.getAlbedoTextureBindlessIndex(),
-			.normalIndex = model.material.getNormalTextureBindlessIndex(),
-			.roughnessIndex = model.material.getRoughnessTextureBindlessIndex(),
-			.metalnessIndex = model.material.getMetalnessTextureBindlessIndex(),
-			.displacementIndex = model.material.getDisplacementTextureBindlessIndex(),
-			.emissiveIndex = model.material.getEmissiveTextureBindlessIndex(),
-			.albedoValue = MathHelper::srgbToLinear(model.material.getAlbedoValue()),
-			.roughnessValue = model.material.getRoughnessValue(),
-			.metalnessValue = model.material.getMetalnessValue(),
-			.emissiveScale = model.material.getEmissiveScale()
+			.normalMatrix = normalMatrices[i],
+			.positionVertexBuffer = model.mesh->getPositionVertexBuffer()->getDeviceAddress(),
+			.materialVertexBuffer = model.mesh->getMaterialVertexBuffer()->getDeviceAddress(),
+			.indexBuffer = model.mesh->getIndexBuffer()->getDeviceAddress(),
+			.materialIndex = model.material->getMaterialIndex()
 		};
 
 		info.addTriangleHitRecord(_pipeline->getTriangleHitGroupHandle(0), rayClosestHitUniforms);
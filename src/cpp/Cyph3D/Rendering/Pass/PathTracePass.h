@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Cyph3D/Rendering/Pass/RenderPass.h>
+#include <Cyph3D/Scene/SceneChangeTracker.h>
 
 namespace c3d
 {
@@ -18,7 +19,7 @@ struct PathTracePassInput
 	const RenderRegistry& registry;
 	Camera& camera;
 	uint32_t sampleCount;
-	bool sceneChanged;
+	const SceneChanges& sceneChanges;
 	bool cameraChanged;
 };
 
@@ -49,16 +50,8 @@ private:
 		vk::DeviceAddress positionVertexBuffer;
 		vk::DeviceAddress materialVertexBuffer;
 		vk::DeviceAddress indexBuffer;
-		int32_t albedoIndex;
-		int32_t normalIndex;
-		int32_t roughnessIndex;
-		int32_t metalnessIndex;
-		int32_t displacementIndex;
-		int32_t emissiveIndex;
-		glm::vec3 albedoValue;
-		float roughnessValue;
-		float metalnessValue;
-		float emissiveScale;
+		// Slot of the material in the MaterialRegistry, whose buffer is given to the shaders in the push constants
+		uint32_t materialIndex;
 	};
 
 	struct RayMissUniforms
@@ -71,6 +64,7 @@ private:
 	struct FramePushConstants
 	{
 		glm::uvec2 topLevelAS;
+		vk::DeviceAddress materialBuffer;
 		uint32_t batchIndex;
 		uint32_t sampleCount;
 		vk::Bool32 resetAccumulation;
@@ -3,17 +3,23 @@
 #include <Cyph3D/Asset/RuntimeAsset/MeshAsset.h>
 #include <Cyph3D/Engine.h>
 #include <Cyph3D/Entity/Component/DirectionalLight.h>
+#include <Cyph3D/Entity/Entity.h>
+#include <Cyph3D/Helper/AffineMathHelper.h>
 #include <Cyph3D/Helper/FileHelper.h>
 #include <Cyph3D/Helper/MathHelper.h>
+#include <Cyph3D/Rendering/ObjectTable.h>
 #include <Cyph3D/Rendering/RenderRegistry.h>
 #include <Cyph3D/Rendering/SceneRenderer/SceneRenderer.h>
-#include <Cyph3D/Scene/Transform.h>
+#include <Cyph3D/Scene/Camera.h>
 #include <Cyph3D/VKObject/Buffer/VKResizableBuffer.h>
 #include <Cyph3D/VKObject/DescriptorSet/VKDescriptorSetLayout.h>
 #include <Cyph3D/VKObject/Image/VKImage.h>
 #include <Cyph3D/VKObject/Pipeline/VKGraphicsPipeline.h>
 #include <Cyph3D/VKObject/Pipeline/VKPipelineLayout.h>
 
+#include <algorithm>
+#include <bit>
+#include <cmath>
 #include <glm/gtc/matrix_inverse.hpp>
 
 namespace
@@ -21,6 +27,9 @@ namespace
 constexpr float POINT_SHADOW_MAP_NEAR = 0.01f;
 constexpr float POINT_SHADOW_MAP_FAR = 100.0f;
 
+// Memory budget of all point light shadow maps, 8192x8192 texels of POINT_SHADOW_MAP_DEPTH_FORMAT take 256 MiB
+constexpr uint32_t POINT_SHADOW_ATLAS_SIZE = 8192;
+
 const glm::mat4 POINT_SHADOW_MAP_PROJECTION = []
 {
 	glm::mat4 projection = glm::perspective(glm::radians(90.0f), 1.0f, POINT_SHADOW_MAP_NEAR, POINT_SHADOW_MAP_FAR);
@@ -30,134 +39,230 @@ const glm::mat4 POINT_SHADOW_MAP_PROJECTION = []
 	return projection;
 }();
 
-glm::mat4 calcDirectionalShadowMapView(const c3d::DirectionalLight::RenderData& light)
+glm::mat4 calcDirectionalShadowMapView(const glm::mat4& lightLocalToWorld)
 {
 	return glm::lookAt(
 		{0, 0, 0},
-		light.transform.getDown(),
-		light.transform.getForward()
+		-glm::normalize(glm::vec3(lightLocalToWorld[1])),
+		-glm::normalize(glm::vec3(lightLocalToWorld[2]))
 	);
 }
 
-std::tuple<glm::mat4, float, float> calcDirectionalShadowMapProjection(const glm::mat4& view, const std::vector<c3d::ModelRenderer::RenderData>& models)
+// Weight of the logarithmic distribution of the cascade splits, the rest being uniform
+constexpr float DIRECTIONAL_SHADOW_CASCADE_LOG_WEIGHT = 0.8f;
+
+constexpr uint32_t CASCADE_COUNT = c3d::SceneRenderer::DIRECTIONAL_SHADOW_MAP_CASCADE_COUNT;
+
+// Distance from the camera to the farthest point of the scene, rounded up to a power of two and clamped to the camera's far plane.
+// The rounding keeps the cascades from changing as the camera moves, they only do when it crosses a power of two.
+float calcDirectionalShadowDistance(glm::vec3 cameraPosition, glm::vec3 sceneBoundingBoxMin, glm::vec3 sceneBoundingBoxMax)
+{
+	glm::vec3 farthestCorner = glm::mix(sceneBoundingBoxMin, sceneBoundingBoxMax, glm::lessThan(cameraPosition, (sceneBoundingBoxMin + sceneBoundingBoxMax) * 0.5f));
+	float distance = glm::distance(cameraPosition, farthestCorner);
+
+	return std::clamp(std::exp2(std::ceil(std::log2(distance))), 1.0f, c3d::Camera::FAR_DISTANCE);
+}
+
+// View depths delimiting the cascades, cascade n spans from split n to split n+1
+std::array<float, CASCADE_COUNT + 1> calcDirectionalShadowCascadeSplits(float shadowDistance)
+{
+	std::array<float, CASCADE_COUNT + 1> splits;
+
+	for (int i = 0; i <= CASCADE_COUNT; i++)
+	{
+		float ratio = static_cast<float>(i) / CASCADE_COUNT;
+		float logSplit = c3d::Camera::NEAR_DISTANCE * std::pow(shadowDistance / c3d::Camera::NEAR_DISTANCE, ratio);
+		float uniformSplit = c3d::Camera::NEAR_DISTANCE + (shadowDistance - c3d::Camera::NEAR_DISTANCE) * ratio;
+
+		splits[i] = glm::mix(uniformSplit, logSplit, DIRECTIONAL_SHADOW_CASCADE_LOG_WEIGHT);
+	}
+
+	return splits;
+}
+
+std::pair<glm::vec3, glm::vec3> calcDirectionalShadowMapSceneBoundingBox(const glm::mat4& view, const c3d::RenderProxyList<c3d::ModelRenderer::RenderData>& models)
 {
 	glm::vec3 min(std::numeric_limits<float>::max());
 	glm::vec3 max(std::numeric_limits<float>::lowest());
 
-	for (const c3d::ModelRenderer::RenderData& model : models)
+	for (int i = 0; i < models.getSize(); i++)
 	{
-		glm::mat4 modelView = view * model.transform.getLocalToWorldMatrix();
+		const c3d::ModelRenderer::RenderData& model = models.getData()[i];
 
-		auto [boundingBoxMin_SMS, boundingBoxMax_SMS] = c3d::MathHelper::transformBoundingBox(
+		glm::mat4 modelView = c3d::AffineMathHelper::multiply(view, models.getLocalToWorldMatrices()[i]);
+
+		auto [boundingBoxMin_SMS, boundingBoxMax_SMS] = c3d::AffineMathHelper::transformBoundingBox(
 			modelView,
-			model.mesh.getBoundingBoxMin(),
-			model.mesh.getBoundingBoxMax()
+			model.mesh->getBoundingBoxMin(),
+			model.mesh->getBoundingBoxMax()
 		);
 
 		min = glm::min(min, boundingBoxMin_SMS);
 		max = glm::max(max, boundingBoxMax_SMS);
 	}
 
-	min -= 0.01f;
-	max += 0.01f;
+	return {min, max};
+}
 
-	glm::vec3 center = (max + min) / 2.0f;
+// The radius only depends on the depths and the camera's field of view, the sphere therefore keeps its size as the camera moves or rotates
+std::pair<glm::vec3, float> calcFrustumSliceBoundingSphere(const glm::mat4& inverseViewProjection, float nearDepth, float farDepth)
+{
+	std::array<glm::vec3, 8> corners;
+	for (int i = 0; i < 8; i++)
+	{
+		float depth = (i & 4) != 0 ? farDepth : nearDepth;
+		// Perspective depth mapping for a [0, 1] depth range
+		float ndcDepth = c3d::Camera::FAR_DISTANCE * (depth - c3d::Camera::NEAR_DISTANCE) / ((c3d::Camera::FAR_DISTANCE - c3d::Camera::NEAR_DISTANCE) * depth);
 
-	glm::vec3 size = max - min;
-	size.x = size.y = std::max(size.x, size.y); // force the matrix to have the same width and height to get square shadow map pixels in worldspace
+		glm::vec4 corner = inverseViewProjection * glm::vec4((i & 1) != 0 ? 1 : -1, (i & 2) != 0 ? 1 : -1, ndcDepth, 1);
+		corners[i] = glm::vec3(corner) / corner.w;
+	}
+
+	glm::vec3 center(0);
+	for (const glm::vec3& corner : corners)
+	{
+		center += corner / 8.0f;
+	}
+
+	float radius = 0;
+	for (const glm::vec3& corner : corners)
+	{
+		radius = std::max(radius, glm::distance(center, corner));
+	}
+
+	// Rounded up so that floating point errors do not change the size either
+	radius = std::ceil(radius * 16.0f) / 16.0f;
+
+	return {center, radius};
+}
+
+// Square projection around the sphere, extended towards the light up to the scene bounds to keep the casters outside of the sphere.
+// The projection only moves by whole texels, so that static casters keep the same rasterization as the camera moves.
+std::pair<glm::mat4, float> calcDirectionalShadowCascadeProjection(const glm::mat4& view, glm::vec3 sphereCenter, float sphereRadius, uint32_t resolution, float sceneMaxZ)
+{
+	float texelWorldSize = sphereRadius * 2.0f / resolution;
+
+	glm::vec3 center = glm::vec3(view * glm::vec4(sphereCenter, 1.0f));
+	center.x = std::floor(center.x / texelWorldSize) * texelWorldSize;
+	center.y = std::floor(center.y / texelWorldSize) * texelWorldSize;
+
+	float minZ = std::floor((center.z - sphereRadius) / texelWorldSize) * texelWorldSize;
+	float maxZ = std::max(std::ceil((center.z + sphereRadius) / texelWorldSize) * texelWorldSize, sceneMaxZ + 0.01f);
 
 	glm::mat4 projection = glm::ortho(
-		center.x - size.x / 2, center.x + size.x / 2,
-		center.y + size.y / 2, center.y - size.y / 2,
-		-center.z - size.z / 2, -center.z + size.z / 2
+		center.x - sphereRadius, center.x + sphereRadius,
+		center.y + sphereRadius, center.y - sphereRadius,
+		-maxZ, -minZ
 	);
 
-	return {projection, size.x, size.z};
+	return {projection, sphereRadius * 2.0f};
 }
 
-std::array<glm::mat4, 6> calcPointShadowMapView(const c3d::PointLight::RenderData& light)
+// Must match common/point lights.glsl, which finds the face and the position in the face of a direction from the light
+constexpr std::array<glm::vec3, 6> POINT_SHADOW_MAP_FACE_FORWARDS = {
+	glm::vec3(1, 0, 0),
+	glm::vec3(-1, 0, 0),
+	glm::vec3(0, 1, 0),
+	glm::vec3(0, -1, 0),
+	glm::vec3(0, 0, -1),
+	glm::vec3(0, 0, 1)
+};
+constexpr std::array<glm::vec3, 6> POINT_SHADOW_MAP_FACE_UPS = {
+	glm::vec3(0, 1, 0),
+	glm::vec3(0, 1, 0),
+	glm::vec3(0, 0, 1),
+	glm::vec3(0, 0, -1),
+	glm::vec3(0, 1, 0),
+	glm::vec3(0, 1, 0)
+};
+
+std::array<glm::mat4, 6> calcPointShadowMapView(glm::vec3 position)
 {
-	glm::vec3 position = light.transform.getWorldPosition();
+	std::array<glm::mat4, 6> views;
+	for (int i = 0; i < 6; i++)
+	{
+		views[i] = glm::lookAt(position, position + POINT_SHADOW_MAP_FACE_FORWARDS[i], POINT_SHADOW_MAP_FACE_UPS[i]);
+	}
 
-	return {
-		glm::lookAt(position, position + glm::vec3(1, 0, 0), glm::vec3(0, 1, 0)),
-		glm::lookAt(position, position + glm::vec3(-1, 0, 0), glm::vec3(0, 1, 0)),
-		glm::lookAt(position, position + glm::vec3(0, 1, 0), glm::vec3(0, 0, 1)),
-		glm::lookAt(position, position + glm::vec3(0, -1, 0), glm::vec3(0, 0, -1)),
-		glm::lookAt(position, position + glm::vec3(0, 0, -1), glm::vec3(0, 1, 0)),
-		glm::lookAt(position, position + glm::vec3(0, 0, 1), glm::vec3(0, 1, 0))
-	};
-}
+	return views;
 }
 
-c3d::ShadowMapPass::ShadowMapPass(glm::uvec2 size):
-	RenderPass(size, "Shadow map pass")
+// Radiant intensity of the light's brightest channel
+float calcPointLightBrightness(const c3d::PointLight::RenderData& light)
 {
-	createDescriptorSetLayout();
-	createBuffer();
-	createPipelineLayouts();
-	createPipelines();
+	return light.intensity * std::max({light.color.r, light.color.g, light.color.b});
 }
 
-c3d::ShadowMapPassOutput c3d::ShadowMapPass::onRender(const std::shared_ptr<VKCommandBuffer>& commandBuffer, ShadowMapPassInput& input)
+// Size giving a face texel per pixel covered by the light's influence sphere, measured at the center of the screen and rounded up to a power of two.
+// The size is scaled by the square root of the light's importance, between 0 and 1, so that its texel count is proportional to it.
+// Sizes between 0.4 and 1.2 times the current one keep it, so that a camera moving around a size boundary does not render the shadow map
+// again every frame.
+uint32_t calcPointShadowMapFaceSize(glm::vec3 lightPosition, float influenceRadius, float importance, const c3d::Camera& camera, float viewportHeight, uint32_t maxFaceSize, uint32_t currentFaceSize)
 {
-	if (input.sceneChanged || input.cameraChanged)
+	float distance = glm::distance(camera.getPosition(), lightPosition);
+
+	float coveredPixels = std::numeric_limits<float>::max();
+	if (distance > influenceRadius)
 	{
-		_shadowMapManager.resetDirectionalShadowMapAllocations();
-		_directionalShadowMapInfos.clear();
+		float tanHalfFov = 1.0f / glm::abs(camera.getProjection()[1][1]);
+		float tanAngularRadius = influenceRadius / std::sqrt(distance * distance - influenceRadius * influenceRadius);
 
-		int shadowCastingDirectionalLightIndex = 0;
-		for (const DirectionalLight::RenderData& light : input.registry.getDirectionalLightRenderRequests())
-		{
-			if (!light.castShadows)
-			{
-				continue;
-			}
+		coveredPixels = tanAngularRadius / tanHalfFov * viewportHeight * 0.5f;
+	}
 
-			commandBuffer->pushDebugGroup(std::format("Directional light ({})", shadowCastingDirectionalLightIndex));
-			renderDirectionalShadowMap(commandBuffer, light, input.registry.getModelRenderRequests());
-			commandBuffer->popDebugGroup();
+	float faceSize = std::clamp(coveredPixels * std::sqrt(importance), static_cast<float>(c3d::ShadowAtlas::MIN_TILE_SIZE), static_cast<float>(maxFaceSize));
 
-			shadowCastingDirectionalLightIndex++;
-		}
+	if (currentFaceSize != 0 && currentFaceSize <= maxFaceSize && faceSize > currentFaceSize * 0.4f && faceSize < currentFaceSize * 1.2f)
+	{
+		return currentFaceSize;
 	}
 
-	if (input.sceneChanged)
-	{
-		_shadowMapManager.resetPointShadowMapAllocations();
-		_pointShadowMapInfos.clear();
+	return std::bit_ceil(static_cast<uint32_t>(std::ceil(faceSize)));
+}
+}
 
-		int shadowCastingPointLights = 0;
-		for (const PointLight::RenderData& light : input.registry.getPointLightRenderRequests())
-		{
-			if (light.castShadows)
-			{
-				shadowCastingPointLights++;
-			}
-		}
+c3d::ShadowMapPass::ShadowMapPass(glm::uvec2 size):
+	RenderPass(size, "Shadow map pass"),
+	_pointShadowAtlas(POINT_SHADOW_ATLAS_SIZE),
+	_directionalLightDrawGenerator("Directional light shadow culling"),
+	_pointLightDrawGenerator("Point light shadow culling")
+{
+	createDescriptorSetLayouts();
+	createBuffers();
+	createPipelineLayouts();
+	createPipelines();
+}
 
-		_pointLightUniformBuffer->resizeSmart(shadowCastingPointLights * 6);
+c3d::ShadowMapPassOutput c3d::ShadowMapPass::onRender(const std::shared_ptr<VKCommandBuffer>& commandBuffer, ShadowMapPassInput& input)
+{
+	// Light parameters are included because they control whether and at which resolution shadows are rendered
+	SceneChangeFlags shadowAffectingChanges = SceneChangeFlags::eTransform | SceneChangeFlags::eModel | SceneChangeFlags::eLight | SceneChangeFlags::eHierarchy;
 
-		int shadowCastingPointLightIndex = 0;
-		for (const PointLight::RenderData& light : input.registry.getPointLightRenderRequests())
-		{
-			if (!light.castShadows)
-			{
-				continue;
-			}
+	_renderedShadowMapCount = 0;
 
-			commandBuffer->pushDebugGroup(std::format("Point light ({})", shadowCastingPointLightIndex));
-			renderPointShadowMap(commandBuffer, light, input.registry.getModelRenderRequests(), shadowCastingPointLightIndex);
-			commandBuffer->popDebugGroup();
+	// Without such changes, every light and shadow caster is where it was when the shadow maps were checked last
+	bool sceneChanged = input.sceneChanges.contains(shadowAffectingChanges);
 
-			shadowCastingPointLightIndex++;
-		}
+	// Directional shadow cascades also follow the camera
+	if (sceneChanged || input.cameraChanged)
+	{
+		updateDirectionalShadowMaps(commandBuffer, input.registry, input.objectTable, input.camera);
+	}
+
+	// The tile sizes of point shadow maps follow the camera
+	if (sceneChanged || input.cameraChanged)
+	{
+		updatePointShadowMaps(commandBuffer, input.registry, input.objectTable, input.camera, sceneChanged);
 	}
 
 	return {
 		.directionalShadowMapInfos = _directionalShadowMapInfos,
 		.pointShadowMapInfos = _pointShadowMapInfos,
-		.pointLightMaxDistance = POINT_SHADOW_MAP_FAR
+		.pointShadowAtlas = _pointShadowAtlas.getImage(),
+		.pointLightMaxDistance = POINT_SHADOW_MAP_FAR,
+		.drawnModelCount = _directionalLightDrawGenerator.getDrawnObjectCount() + _pointLightDrawGenerator.getDrawnObjectCount(),
+		.culledModelCount = _directionalLightDrawGenerator.getCulledObjectCount() + _pointLightDrawGenerator.getCulledObjectCount(),
+		.renderedShadowMapCount = _renderedShadowMapCount
 	};
 }
 
@@ -165,35 +270,49 @@ void c3d::ShadowMapPass::onResize()
 {
 }
 
-void c3d::ShadowMapPass::createDescriptorSetLayout()
+void c3d::ShadowMapPass::createDescriptorSetLayouts()
 {
-	VKDescriptorSetLayoutInfo info(true);
-	info.addBinding(vk::DescriptorType::eStorageBuffer, 1);
+	{
+		VKDescriptorSetLayoutInfo info(true);
+		info.addBinding(vk::DescriptorType::eStorageBuffer, 1);
 
-	_pointLightDescriptorSetLayout = VKDescriptorSetLayout::create(Engine::getVKContext(), info);
+		_directionalLightDescriptorSetLayout = VKDescriptorSetLayout::create(Engine::getVKContext(), info);
+	}
+
+	{
+		VKDescriptorSetLayoutInfo info(true);
+		info.addBinding(vk::DescriptorType::eStorageBuffer, 1);
+		info.addBinding(vk::DescriptorType::eStorageBuffer, 1);
+		info.addBinding(vk::DescriptorType::eStorageBuffer, 1);
+
+		_pointLightDescriptorSetLayout = VKDescriptorSetLayout::create(Engine::getVKContext(), info);
+	}
 }
 
-void c3d::ShadowMapPass::createBuffer()
+void c3d::ShadowMapPass::createBuffers()
 {
-	VKResizableBufferInfo bufferInfo(vk::BufferUsageFlagBits::eStorageBuffer);
-	bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eDeviceLocal);
-	bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostVisible);
-	bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostCoherent);
-	bufferInfo.setName("Point light shadow generation uniform buffer");
-
-	_pointLightUniformBuffer = VKDynamic<VKResizableBuffer<PointLightUniforms>>(
-		Engine::getVKContext(),
-		[&](VKContext& context, int index)
-		{
-			return VKResizableBuffer<PointLightUniforms>::create(context, bufferInfo);
-		}
-	);
+	{
+		VKResizableBufferInfo bufferInfo(vk::BufferUsageFlagBits::eStorageBuffer);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eDeviceLocal);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostVisible);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostCoherent);
+		bufferInfo.setName("Point light shadow generation uniform buffer");
+
+		_pointLightUniformBuffer = VKDynamic<VKResizableBuffer<PointLightUniforms>>(
+			Engine::getVKContext(),
+			[&](VKContext& context, int index)
+			{
+				return VKResizableBuffer<PointLightUniforms>::create(context, bufferInfo);
+			}
+		);
+	}
 }
 
 void c3d::ShadowMapPass::createPipelineLayouts()
 {
 	{
 		VKPipelineLayoutInfo info;
+		info.addDescriptorSetLayout(_directionalLightDescriptorSetLayout);
 		info.setPushConstantLayout<DirectionalLightPushConstantData>();
 
 		_directionalLightPipelineLayout = VKPipelineLayout::create(Engine::getVKContext(), info);
@@ -202,7 +321,6 @@ void c3d::ShadowMapPass::createPipelineLayouts()
 	{
 		VKPipelineLayoutInfo info;
 		info.addDescriptorSetLayout(_pointLightDescriptorSetLayout);
-		info.setPushConstantLayout<PointLightPushConstantData>();
 
 		_pointLightPipelineLayout = VKPipelineLayout::create(Engine::getVKContext(), info);
 	}
@@ -247,165 +365,570 @@ void c3d::ShadowMapPass::createPipelines()
 	}
 }
 
-void c3d::ShadowMapPass::renderDirectionalShadowMap(
-	const std::shared_ptr<VKCommandBuffer>& commandBuffer,
-	const DirectionalLight::RenderData& light,
-	const std::vector<ModelRenderer::RenderData>& models
-)
+void c3d::ShadowMapPass::updateDirectionalShadowMaps(const std::shared_ptr<VKCommandBuffer>& commandBuffer, const RenderRegistry& registry, const ObjectTable& objectTable, const Camera& camera)
 {
-	std::shared_ptr<VKImage> shadowMap = _shadowMapManager.allocateDirectionalShadowMap(light.shadowMapResolution);
+	const RenderProxyList<DirectionalLight::RenderData>& directionalLights = registry.getDirectionalLights();
+	const RenderProxyList<ModelRenderer::RenderData>& models = registry.getModels();
+
+	// Cascades take casters from the whole scene, every shadow caster is relevant to all of them
+	std::vector<ShadowCaster> casters;
+	glm::vec3 sceneBoundingBoxMin(std::numeric_limits<float>::max());
+	glm::vec3 sceneBoundingBoxMax(std::numeric_limits<float>::lowest());
+	for (int i = 0; i < models.getSize(); i++)
+	{
+		if (models.getData()[i].contributeShadows)
+		{
+			casters.push_back(getShadowCaster(models, i));
+		}
 
-	commandBuffer->imageMemoryBarrier(
-		shadowMap,
-		vk::PipelineStageFlagBits2::eEarlyFragmentTests | vk::PipelineStageFlagBits2::eLateFragmentTests,
-		vk::AccessFlagBits2::eDepthStencilAttachmentRead | vk::AccessFlagBits2::eDepthStencilAttachmentWrite,
-		vk::ImageLayout::eDepthAttachmentOptimal
+		sceneBoundingBoxMin = glm::min(sceneBoundingBoxMin, models.getWorldBoundingBoxMins()[i]);
+		sceneBoundingBoxMax = glm::max(sceneBoundingBoxMax, models.getWorldBoundingBoxMaxs()[i]);
+	}
+	std::ranges::sort(
+		casters,
+		std::less(),
+		[](const ShadowCaster& caster)
+		{
+			return caster.owner.index;
+		}
 	);
 
-	VKRenderingInfo renderingInfo({light.shadowMapResolution, light.shadowMapResolution});
-
-	renderingInfo.setDepthAttachment(shadowMap)
-		.setLoadOpClear(1.0f)
-		.setStoreOpStore();
+	bool castersChanged = casters != _directionalShadowCasters;
+	if (castersChanged)
+	{
+		_directionalShadowCasters = std::move(casters);
+	}
 
-	commandBuffer->beginRendering(renderingInfo);
+	for (CachedDirectionalShadowMap& cache : _directionalShadowMapCache)
+	{
+		cache.used = false;
+	}
 
-	commandBuffer->bindPipeline(_directionalLightPipeline);
+	glm::mat4 inverseCameraViewProjection = glm::inverse(camera.getProjection() * camera.getView());
 
-	VKPipelineViewport viewport;
-	viewport.offset = {0, 0};
-	viewport.size = {light.shadowMapResolution, light.shadowMapResolution};
-	viewport.depthRange = {0.0f, 1.0f};
-	commandBuffer->setViewport(viewport);
+	// Cascades reach every model in view, fragments beyond the last one are not shadowed
+	float shadowDistance = models.isEmpty() ? Camera::FAR_DISTANCE : calcDirectionalShadowDistance(camera.getPosition(), sceneBoundingBoxMin, sceneBoundingBoxMax);
+	std::array<float, CASCADE_COUNT + 1> cascadeSplits = calcDirectionalShadowCascadeSplits(shadowDistance);
 
-	VKPipelineScissor scissor;
-	scissor.offset = {0, 0};
-	scissor.size = {light.shadowMapResolution, light.shadowMapResolution};
-	commandBuffer->setScissor(scissor);
+	std::array<std::pair<glm::vec3, float>, CASCADE_COUNT> cascadeBoundingSpheres;
+	for (int i = 0; i < CASCADE_COUNT; i++)
+	{
+		cascadeBoundingSpheres[i] = calcFrustumSliceBoundingSphere(inverseCameraViewProjection, cascadeSplits[i], cascadeSplits[i + 1]);
+	}
 
-	glm::mat4 view = calcDirectionalShadowMapView(light);
-	auto [projection, worldSize, worldDepth] = calcDirectionalShadowMapProjection(view, models);
-	glm::mat4 viewProjection = projection * view;
+	_directionalShadowMapInfos.clear();
+	_outdatedShadowMaps.clear();
+	_views.clear();
 
-	for (const ModelRenderer::RenderData& model : models)
+	for (int i = 0; i < directionalLights.getSize(); i++)
 	{
-		if (!model.contributeShadows)
+		const DirectionalLight::RenderData& light = directionalLights.getData()[i];
+		if (!light.castShadows)
 		{
 			continue;
 		}
 
-		const std::shared_ptr<VKBuffer<PositionVertexData>>& vertexBuffer = model.mesh.getPositionVertexBuffer();
-		const std::shared_ptr<VKBuffer<uint32_t>>& indexBuffer = model.mesh.getIndexBuffer();
+		EntityId lightId = directionalLights.getOwners()[i]->getId();
+		if (lightId.index >= _directionalShadowMapCache.size())
+		{
+			_directionalShadowMapCache.resize(lightId.index + 1);
+		}
+
+		CachedDirectionalShadowMap& cache = _directionalShadowMapCache[lightId.index];
+
+		// The entry belonged to a removed light or was allocated at another resolution
+		if (cache.info.image && (cache.light != lightId || cache.info.image->getSize(0).x != light.shadowMapResolution))
+		{
+			_shadowMapManager.freeDirectionalShadowMap(cache.info.image);
+			cache.info.image = nullptr;
+		}
+
+		glm::mat4 view = calcDirectionalShadowMapView(directionalLights.getLocalToWorldMatrices()[i]);
+		auto [sceneBoundingBoxMin, sceneBoundingBoxMax] = calcDirectionalShadowMapSceneBoundingBox(view, models);
+
+		std::array<glm::mat4, CASCADE_COUNT> viewProjections;
+		for (int j = 0; j < CASCADE_COUNT; j++)
+		{
+			auto [sphereCenter, sphereRadius] = cascadeBoundingSpheres[j];
+			auto [projection, worldSize] = calcDirectionalShadowCascadeProjection(view, sphereCenter, sphereRadius, light.shadowMapResolution, sceneBoundingBoxMax.z);
+
+			viewProjections[j] = projection * view;
+			cache.info.worldSizes[j] = worldSize;
+			cache.info.cascadeFarDepths[j] = cascadeSplits[j + 1];
+		}
+
+		bool outdated = castersChanged || !cache.info.image || cache.info.viewProjections != viewProjections;
+
+		if (!cache.info.image)
+		{
+			cache.info.image = _shadowMapManager.allocateDirectionalShadowMap(light.shadowMapResolution);
+		}
+
+		cache.light = lightId;
+		cache.info.viewProjections = viewProjections;
+		cache.used = true;
 
-		commandBuffer->bindVertexBuffer(0, vertexBuffer);
-		commandBuffer->bindIndexBuffer(indexBuffer);
+		if (outdated)
+		{
+			_outdatedShadowMaps.push_back(_directionalShadowMapInfos.size());
 
-		DirectionalLightPushConstantData pushConstantData{};
-		pushConstantData.mvp = viewProjection * model.transform.getLocalToWorldMatrix();
-		commandBuffer->pushConstants(pushConstantData);
+			for (int j = 0; j < CASCADE_COUNT; j++)
+			{
+				_views.push_back(
+					IndirectDrawGenerator::View{
+						.frustumPlanes = MathHelper::extractFrustumPlanes(viewProjections[j]),
+						.requiredFlags = ObjectTable::FLAG_CONTRIBUTE_SHADOWS
+					}
+				);
+			}
+		}
 
-		commandBuffer->drawIndexed(indexBuffer->getInfo().getSize(), 0, 0);
+		_directionalShadowMapInfos.push_back(cache.info);
 	}
 
-	commandBuffer->unbindPipeline();
+	// Lights removed or no longer casting shadows
+	for (CachedDirectionalShadowMap& cache : _directionalShadowMapCache)
+	{
+		if (!cache.used && cache.info.image)
+		{
+			_shadowMapManager.freeDirectionalShadowMap(cache.info.image);
+			cache.info.image = nullptr;
+		}
+	}
 
-	commandBuffer->endRendering();
+	if (_views.empty())
+	{
+		return;
+	}
+
+	// The views of the cascades of the shadow map at position n in _outdatedShadowMaps are at positions CASCADE_COUNT * n to CASCADE_COUNT * (n + 1) - 1
+	_directionalLightDrawGenerator.generate(commandBuffer, objectTable, _views);
+
+	for (int i = 0; i < _outdatedShadowMaps.size(); i++)
+	{
+		const DirectionalShadowMapInfo& info = _directionalShadowMapInfos[_outdatedShadowMaps[i]];
+		const std::shared_ptr<VKImage>& shadowMap = info.image;
+		glm::uvec2 resolution = shadowMap->getSize(0);
+
+		commandBuffer->pushDebugGroup(std::format("Directional light ({})", _outdatedShadowMaps[i]));
 
-	_directionalShadowMapInfos.push_back(
-		DirectionalShadowMapInfo{
-			.worldSize = worldSize,
-			.worldDepth = worldDepth,
-			.viewProjection = viewProjection,
-			.image = shadowMap,
+		commandBuffer->imageMemoryBarrier(
+			shadowMap,
+			vk::PipelineStageFlagBits2::eEarlyFragmentTests | vk::PipelineStageFlagBits2::eLateFragmentTests,
+			vk::AccessFlagBits2::eDepthStencilAttachmentRead | vk::AccessFlagBits2::eDepthStencilAttachmentWrite,
+			vk::ImageLayout::eDepthAttachmentOptimal
+		);
+
+		for (int j = 0; j < CASCADE_COUNT; j++)
+		{
+			VKRenderingInfo renderingInfo(resolution);
+
+			renderingInfo
+				.setDepthAttachment(
+					shadowMap,
+					vk::ImageViewType::e2D,
+					{j, j},
+					{0, 0},
+					shadowMap->getInfo().getFormat()
+				)
+				.setLoadOpClear(1.0f)
+				.setStoreOpStore();
+
+			commandBuffer->beginRendering(renderingInfo);
+
+			commandBuffer->bindPipeline(_directionalLightPipeline);
+
+			VKPipelineViewport viewport;
+			viewport.offset = {0, 0};
+			viewport.size = resolution;
+			viewport.depthRange = {0.0f, 1.0f};
+			commandBuffer->setViewport(viewport);
+
+			VKPipelineScissor scissor;
+			scissor.offset = {0, 0};
+			scissor.size = resolution;
+			commandBuffer->setScissor(scissor);
+
+			if (objectTable.getObjectCount() > 0)
+			{
+				commandBuffer->pushDescriptor(0, 0, objectTable.getBuffer(), 0, objectTable.getObjectCount());
+			}
+
+			DirectionalLightPushConstantData pushConstantData{};
+			pushConstantData.viewProjection = info.viewProjections[j];
+			commandBuffer->pushConstants(pushConstantData);
+
+			_directionalLightDrawGenerator.draw(commandBuffer, i * CASCADE_COUNT + j, false);
+
+			commandBuffer->unbindPipeline();
+
+			commandBuffer->endRendering();
 		}
-	);
+
+		commandBuffer->popDebugGroup();
+	}
+
+	_renderedShadowMapCount += _outdatedShadowMaps.size();
 }
 
-void c3d::ShadowMapPass::renderPointShadowMap(
-	const std::shared_ptr<VKCommandBuffer>& commandBuffer,
-	const PointLight::RenderData& light,
-	const std::vector<ModelRenderer::RenderData>& models,
-	int uniformIndex
-)
+void c3d::ShadowMapPass::updatePointShadowMaps(const std::shared_ptr<VKCommandBuffer>& commandBuffer, const RenderRegistry& registry, const ObjectTable& objectTable, const Camera& camera, bool sceneChanged)
 {
-	std::shared_ptr<VKImage> shadowMap = _shadowMapManager.allocatePointShadowMap(light.shadowMapResolution);
+	const RenderProxyList<PointLight::RenderData>& pointLights = registry.getPointLights();
+	const RenderProxyList<ModelRenderer::RenderData>& models = registry.getModels();
+
+	for (CachedPointShadowMap& cache : _pointShadowMapCache)
+	{
+		cache.used = false;
+	}
+
+	_pointShadowMapInfos.clear();
+	_outdatedShadowMaps.clear();
+	_views.clear();
+
+	// The importance of a light is its brightness relative to the brightest shadow casting point light
+	float maxBrightness = 0;
+	for (const PointLight::RenderData& light : pointLights.getData())
+	{
+		if (light.castShadows)
+		{
+			maxBrightness = std::max(maxBrightness, calcPointLightBrightness(light));
+		}
+	}
+
+	// Tiles whose light changed or whose size is no longer the requested one are freed before any allocation
+	for (int i = 0; i < pointLights.getSize(); i++)
+	{
+		const PointLight::RenderData& light = pointLights.getData()[i];
+		if (!light.castShadows)
+		{
+			continue;
+		}
+
+		EntityId lightId = pointLights.getOwners()[i]->getId();
+		if (lightId.index >= _pointShadowMapCache.size())
+		{
+			_pointShadowMapCache.resize(lightId.index + 1);
+		}
+
+		CachedPointShadowMap& cache = _pointShadowMapCache[lightId.index];
+
+		// The entry belonged to a removed light
+		if (cache.light != lightId)
+		{
+			freePointShadowMapTiles(cache.info);
+			cache.requestedFaceSize = 0;
+		}
+
+		glm::vec3 lightPosition = glm::vec3(pointLights.getLocalToWorldMatrices()[i][3]);
+		float influenceRadius = std::min(light.range, POINT_SHADOW_MAP_FAR);
+		float importance = maxBrightness > 0 ? calcPointLightBrightness(light) / maxBrightness : 1.0f;
+		uint32_t maxFaceSize = std::min(std::bit_floor(light.shadowMapResolution), POINT_SHADOW_ATLAS_SIZE / 4);
+
+		uint32_t requestedFaceSize = calcPointShadowMapFaceSize(lightPosition, influenceRadius, importance, camera, _size.y, maxFaceSize, cache.requestedFaceSize);
+		if (requestedFaceSize != cache.requestedFaceSize)
+		{
+			freePointShadowMapTiles(cache.info);
+		}
+
+		cache.light = lightId;
+		cache.requestedFaceSize = requestedFaceSize;
+		cache.used = true;
+	}
+
+	// Lights removed or no longer casting shadows
+	for (CachedPointShadowMap& cache : _pointShadowMapCache)
+	{
+		if (!cache.used)
+		{
+			freePointShadowMapTiles(cache.info);
+			cache.requestedFaceSize = 0;
+			cache.casters.clear();
+		}
+	}
+
+	// Lights without tiles are served before those that fell back to smaller tiles
+	std::vector<CachedPointShadowMap*> unallocatedCaches;
+	std::vector<CachedPointShadowMap*> downsizedCaches;
+	for (CachedPointShadowMap& cache : _pointShadowMapCache)
+	{
+		if (!cache.used)
+		{
+			continue;
+		}
+
+		if (cache.info.faceSize == 0)
+		{
+			unallocatedCaches.push_back(&cache);
+		}
+		else if (cache.info.faceSize < cache.requestedFaceSize)
+		{
+			downsizedCaches.push_back(&cache);
+		}
+	}
+
+	// Larger tiles first, they are the most likely not to fit once the atlas is fragmented
+	auto getRequestedFaceSize = [](const CachedPointShadowMap* cache)
+	{
+		return cache->requestedFaceSize;
+	};
+	std::ranges::sort(unallocatedCaches, std::greater(), getRequestedFaceSize);
+	std::ranges::sort(downsizedCaches, std::greater(), getRequestedFaceSize);
+
+	for (CachedPointShadowMap* cache : unallocatedCaches)
+	{
+		allocatePointShadowMapTiles(cache->info, cache->requestedFaceSize, ShadowAtlas::MIN_TILE_SIZE);
+		cache->rendered = false;
+	}
+
+	// Space may have been freed since these lights fell back, their current tiles are kept if no larger ones fit
+	for (CachedPointShadowMap* cache : downsizedCaches)
+	{
+		PointShadowMapInfo upsizedInfo = {};
+		allocatePointShadowMapTiles(upsizedInfo, cache->requestedFaceSize, cache->info.faceSize * 2);
+		if (upsizedInfo.faceSize != 0)
+		{
+			freePointShadowMapTiles(cache->info);
+			cache->info = upsizedInfo;
+			cache->rendered = false;
+		}
+	}
+
+	int shadowCastingPointLights = 0;
+	for (const PointLight::RenderData& light : pointLights.getData())
+	{
+		if (light.castShadows)
+		{
+			shadowCastingPointLights++;
+		}
+	}
+
+	_pointLightUniformBuffer->resizeSmart(shadowCastingPointLights);
+
+	std::vector<ShadowCaster> casters;
+
+	// The shadow map at position n in _outdatedShadowMaps has its uniforms at position n in the uniform buffer and its six views,
+	// one per cube face, at positions 6n to 6n+5 in _views
+	for (int i = 0; i < pointLights.getSize(); i++)
+	{
+		const PointLight::RenderData& light = pointLights.getData()[i];
+		if (!light.castShadows)
+		{
+			continue;
+		}
+
+		CachedPointShadowMap& cache = _pointShadowMapCache[pointLights.getOwners()[i]->getId().index];
+
+		_pointShadowMapInfos.push_back(cache.info);
+
+		// Only the tile sizes can have changed without a scene change
+		if (cache.info.faceSize == 0 || (cache.rendered && !sceneChanged))
+		{
+			continue;
+		}
+
+		glm::vec3 lightPosition = glm::vec3(pointLights.getLocalToWorldMatrices()[i][3]);
+
+		// A caster beyond the light's range can only shadow fragments the light does not reach
+		float influenceRadius = std::min(light.range, POINT_SHADOW_MAP_FAR);
+
+		casters.clear();
+		models.getBVH().querySphere(
+			lightPosition,
+			influenceRadius,
+			[&](uint32_t id)
+			{
+				uint32_t index = models.getIndex(id);
+
+				glm::vec3 closestPoint = glm::clamp(lightPosition, models.getWorldBoundingBoxMins()[index], models.getWorldBoundingBoxMaxs()[index]);
+				glm::vec3 offset = closestPoint - lightPosition;
+
+				if (models.getData()[index].contributeShadows && glm::dot(offset, offset) <= influenceRadius * influenceRadius)
+				{
+					casters.push_back(getShadowCaster(models, index));
+				}
+
+				return true;
+			}
+		);
+		std::ranges::sort(
+			casters,
+			std::less(),
+			[](const ShadowCaster& caster)
+			{
+				return caster.owner.index;
+			}
+		);
+
+		bool outdated = !cache.rendered || cache.position != lightPosition || cache.casters != casters;
+
+		cache.position = lightPosition;
+		cache.rendered = true;
+
+		if (outdated)
+		{
+			cache.casters = casters;
+
+			std::array<glm::mat4, 6> views = calcPointShadowMapView(lightPosition);
+
+			PointLightUniforms* pointLightUniformBufferPtr = _pointLightUniformBuffer->getHostPointer() + _outdatedShadowMaps.size();
+			pointLightUniformBufferPtr->lightPos = lightPosition;
+			pointLightUniformBufferPtr->maxDistance = POINT_SHADOW_MAP_FAR;
+
+			for (int j = 0; j < 6; j++)
+			{
+				pointLightUniformBufferPtr->viewProjections[j] = POINT_SHADOW_MAP_PROJECTION * views[j];
+
+				// The face's [-1, 1] range is mapped to its tile in the atlas' [-1, 1] range
+				glm::vec2 tileCenter = glm::vec2(cache.info.faceOffsets[j]) + cache.info.faceSize * 0.5f;
+				float scale = static_cast<float>(cache.info.faceSize) / POINT_SHADOW_ATLAS_SIZE;
+				pointLightUniformBufferPtr->faceAtlasTransforms[j] = glm::vec4(glm::vec2(scale), tileCenter / static_cast<float>(POINT_SHADOW_ATLAS_SIZE) * 2.0f - 1.0f);
+
+				_views.push_back(
+					IndirectDrawGenerator::View{
+						.frustumPlanes = MathHelper::extractFrustumPlanes(POINT_SHADOW_MAP_PROJECTION * views[j]),
+						.requiredFlags = ObjectTable::FLAG_CONTRIBUTE_SHADOWS
+					}
+				);
+			}
+
+			_outdatedShadowMaps.push_back(_pointShadowMapInfos.size() - 1);
+		}
+	}
+
+	if (_views.empty())
+	{
+		return;
+	}
+
+	// Each shadow caster is drawn once per light, with one instance per cube face its bounds touch
+	_pointLightDrawGenerator.generateLayered(commandBuffer, objectTable, _views, 6);
+
+	const std::shared_ptr<VKImage>& atlas = _pointShadowAtlas.getImage();
+	glm::uvec2 atlasSize = atlas->getSize(0);
+
+	commandBuffer->pushDebugGroup("Point lights");
 
 	commandBuffer->imageMemoryBarrier(
-		shadowMap,
+		atlas,
 		vk::PipelineStageFlagBits2::eEarlyFragmentTests | vk::PipelineStageFlagBits2::eLateFragmentTests,
 		vk::AccessFlagBits2::eDepthStencilAttachmentRead | vk::AccessFlagBits2::eDepthStencilAttachmentWrite,
 		vk::ImageLayout::eDepthAttachmentOptimal
 	);
 
-	std::array<glm::mat4, 6> views = calcPointShadowMapView(light);
+	// Tiles of the shadow maps kept from previous frames are left untouched
+	VKRenderingInfo renderingInfo(atlasSize);
 
-	for (int i = 0; i < 6; i++)
+	renderingInfo.setDepthAttachment(atlas)
+		.setLoadOpLoad()
+		.setStoreOpStore();
+
+	commandBuffer->beginRendering(renderingInfo);
+
+	commandBuffer->bindPipeline(_pointLightPipeline);
+
+	VKPipelineViewport viewport;
+	viewport.offset = {0, 0};
+	viewport.size = atlasSize;
+	viewport.depthRange = {0.0f, 1.0f};
+	commandBuffer->setViewport(viewport);
+
+	VKPipelineScissor scissor;
+	scissor.offset = {0, 0};
+	scissor.size = atlasSize;
+	commandBuffer->setScissor(scissor);
+
+	if (objectTable.getObjectCount() > 0)
 	{
-		VKRenderingInfo renderingInfo({light.shadowMapResolution, light.shadowMapResolution});
+		commandBuffer->pushDescriptor(0, 1, objectTable.getBuffer(), 0, objectTable.getObjectCount());
+		commandBuffer->pushDescriptor(0, 2, _pointLightDrawGenerator.getLayerInstanceBuffer(), 0, _pointLightDrawGenerator.getLayerInstanceCount());
+	}
 
-		renderingInfo
-			.setDepthAttachment(
-				shadowMap,
-				vk::ImageViewType::e2D,
-				{i, i},
-				{0, 0},
-				shadowMap->getInfo().getFormat()
-			)
-			.setLoadOpClear(std::numeric_limits<float>::max())
-			.setStoreOpStore();
+	for (int i = 0; i < _outdatedShadowMaps.size(); i++)
+	{
+		const PointShadowMapInfo& info = _pointShadowMapInfos[_outdatedShadowMaps[i]];
 
-		commandBuffer->beginRendering(renderingInfo);
+		for (int j = 0; j < 6; j++)
+		{
+			commandBuffer->clearDepthAttachment(info.faceOffsets[j], glm::uvec2(info.faceSize), 1.0f);
+		}
 
-		commandBuffer->bindPipeline(_pointLightPipeline);
+		// All faces are drawn at once, the vertex shader places each instance in the tile of its face
+		commandBuffer->pushDescriptor(0, 0, _pointLightUniformBuffer.getCurrent()->getBuffer(), i, 1);
 
-		VKPipelineViewport viewport;
-		viewport.offset = {0, 0};
-		viewport.size = {light.shadowMapResolution, light.shadowMapResolution};
-		viewport.depthRange = {0.0f, 1.0f};
-		commandBuffer->setViewport(viewport);
+		_pointLightDrawGenerator.draw(commandBuffer, i, false);
+	}
 
-		VKPipelineScissor scissor;
-		scissor.offset = {0, 0};
-		scissor.size = {light.shadowMapResolution, light.shadowMapResolution};
-		commandBuffer->setScissor(scissor);
+	commandBuffer->unbindPipeline();
 
-		int uniformOffset = uniformIndex * 6 + i;
+	commandBuffer->endRendering();
 
-		PointLightUniforms* pointLightUniformBufferPtr = _pointLightUniformBuffer->getHostPointer() + uniformOffset;
-		pointLightUniformBufferPtr->viewProjection = POINT_SHADOW_MAP_PROJECTION * views[i];
-		pointLightUniformBufferPtr->lightPos = light.transform.getWorldPosition();
-		pointLightUniformBufferPtr->maxDistance = POINT_SHADOW_MAP_FAR;
+	commandBuffer->popDebugGroup();
 
-		commandBuffer->pushDescriptor(0, 0, _pointLightUniformBuffer.getCurrent()->getBuffer(), uniformOffset, 1);
+	_renderedShadowMapCount += _outdatedShadowMaps.size();
+}
 
-		for (const ModelRenderer::RenderData& model : models)
+void c3d::ShadowMapPass::allocatePointShadowMapTiles(PointShadowMapInfo& info, uint32_t maxFaceSize, uint32_t minFaceSize)
+{
+	for (uint32_t size = maxFaceSize; size >= minFaceSize; size /= 2)
+	{
+		std::array<std::optional<ShadowAtlas::Tile>, 6> tiles;
+		for (int i = 0; i < 6; i++)
 		{
-			if (!model.contributeShadows)
+			tiles[i] = _pointShadowAtlas.allocate(size);
+		}
+
+		bool allocated = std::ranges::all_of(
+			tiles,
+			[](const std::optional<ShadowAtlas::Tile>& tile)
 			{
-				continue;
+				return tile.has_value();
 			}
+		);
 
-			const std::shared_ptr<VKBuffer<PositionVertexData>>& vertexBuffer = model.mesh.getPositionVertexBuffer();
-			const std::shared_ptr<VKBuffer<uint32_t>>& indexBuffer = model.mesh.getIndexBuffer();
-
-			commandBuffer->bindVertexBuffer(0, vertexBuffer);
-			commandBuffer->bindIndexBuffer(indexBuffer);
-
-			PointLightPushConstantData pushConstantData{};
-			pushConstantData.model = model.transform.getLocalToWorldMatrix();
-			commandBuffer->pushConstants(pushConstantData);
+		if (allocated)
+		{
+			for (int i = 0; i < 6; i++)
+			{
+				info.faceOffsets[i] = tiles[i]->offset;
+			}
+			info.faceSize = size;
+			return;
+		}
 
-			commandBuffer->drawIndexed(indexBuffer->getInfo().getSize(), 0, 0);
+		for (const std::optional<ShadowAtlas::Tile>& tile : tiles)
+		{
+			if (tile)
+			{
+				_pointShadowAtlas.free(*tile);
+			}
 		}
+	}
 
-		commandBuffer->unbindPipeline();
+	info.faceSize = 0;
+}
 
-		commandBuffer->endRendering();
+void c3d::ShadowMapPass::freePointShadowMapTiles(PointShadowMapInfo& info)
+{
+	if (info.faceSize == 0)
+	{
+		return;
 	}
 
-	_pointShadowMapInfos.push_back(
-		PointShadowMapInfo{
-			.image = shadowMap,
-		}
-	);
+	for (glm::uvec2 faceOffset : info.faceOffsets)
+	{
+		_pointShadowAtlas.free({faceOffset, info.faceSize});
+	}
+
+	info.faceSize = 0;
+}
+
+c3d::ShadowMapPass::ShadowCaster c3d::ShadowMapPass::getShadowCaster(const RenderProxyList<ModelRenderer::RenderData>& models, uint32_t index)
+{
+	return {
+		.owner = models.getOwners()[index]->getId(),
+		.localToWorld = models.getLocalToWorldMatrices()[index],
+		.worldBoundingBoxMin = models.getWorldBoundingBoxMins()[index],
+		.worldBoundingBoxMax = models.getWorldBoundingBoxMaxs()[index],
+		.mesh = models.getData()[index].mesh
+	};
 }
\ No newline at end of file
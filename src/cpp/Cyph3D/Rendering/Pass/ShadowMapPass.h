@@ -1,35 +1,50 @@
 #pragma once
 
+#include <Cyph3D/Rendering/IndirectDrawGenerator.h>
 #include <Cyph3D/Rendering/Pass/RenderPass.h>
 #include <Cyph3D/Rendering/RenderRegistry.h>
+#include <Cyph3D/Rendering/SceneRenderer/SceneRenderer.h>
+#include <Cyph3D/Rendering/ShadowAtlas.h>
 #include <Cyph3D/Rendering/ShadowMapManager.h>
+#include <Cyph3D/Scene/SceneChangeTracker.h>
 #include <Cyph3D/VKObject/VKDynamic.h>
 
+#include <array>
+#include <vector>
+
 namespace c3d
 {
+class Camera;
 class VKPipelineLayout;
 class VKGraphicsPipeline;
 class VKDescriptorSetLayout;
 template<typename T>
 class VKResizableBuffer;
 
+// The camera frustum is split by view depth into cascades, each rendered to a layer of the shadow map
 struct DirectionalShadowMapInfo
 {
-	float worldSize;
-	float worldDepth;
-	glm::mat4 viewProjection;
+	std::array<float, SceneRenderer::DIRECTIONAL_SHADOW_MAP_CASCADE_COUNT> worldSizes;
+	std::array<glm::mat4, SceneRenderer::DIRECTIONAL_SHADOW_MAP_CASCADE_COUNT> viewProjections;
+	// View depth up to which each cascade is used, fragments beyond the last one are not shadowed
+	std::array<float, SceneRenderer::DIRECTIONAL_SHADOW_MAP_CASCADE_COUNT> cascadeFarDepths;
 	std::shared_ptr<VKImage> image;
 };
 
+// The faces of the cube are rendered to tiles of the same size in the point shadow atlas
 struct PointShadowMapInfo
 {
-	std::shared_ptr<VKImage> image;
+	std::array<glm::uvec2, 6> faceOffsets;
+	// 0 if the light did not fit in the atlas, it then casts no shadow
+	uint32_t faceSize;
 };
 
 struct ShadowMapPassInput
 {
 	const RenderRegistry& registry;
-	bool sceneChanged;
+	const ObjectTable& objectTable;
+	const SceneChanges& sceneChanges;
+	const Camera& camera;
 	bool cameraChanged;
 };
 
@@ -37,9 +52,22 @@ struct ShadowMapPassOutput
 {
 	const std::vector<DirectionalShadowMapInfo>& directionalShadowMapInfos;
 	const std::vector<PointShadowMapInfo>& pointShadowMapInfos;
+	// nullptr until a point light first casts shadows
+	const std::shared_ptr<VKImage>& pointShadowAtlas;
 	float pointLightMaxDistance;
+	// Summed over all light views, read back from the GPU a few frames after shadow maps were rendered
+	uint32_t drawnModelCount;
+	uint32_t culledModelCount;
+	// Shadow maps rendered this frame, the others were kept from a previous frame
+	uint32_t renderedShadowMapCount;
 };
 
+// Shadow maps are kept from one frame to the next and only rendered again when their light changes or when a shadow caster in the light's influence volume
+// moves, appears or disappears. The influence volume of a point light is the sphere of its range, the one of a directional light is the whole scene
+// as its cascades take casters from all models. Cascades follow the camera, they are only rendered again once it moved by at least a texel.
+// Point light shadow maps share a fixed size atlas. The tile size of each light follows the screen coverage of its influence volume, weighted by
+// the light's brightness relative to the brightest one, up to the light's shadow map resolution. Lights are given tiles by decreasing size, those
+// not fitting at their size fall back to smaller tiles and get larger ones once space frees up.
 class ShadowMapPass : public RenderPass<ShadowMapPassInput, ShadowMapPassOutput>
 {
 public:
@@ -48,53 +76,95 @@ public:
 private:
 	struct DirectionalLightPushConstantData
 	{
-		glm::mat4 mvp;
+		glm::mat4 viewProjection;
 	};
 
 	//FIXME: properly align storage buffer offset
 	struct alignas(16) PointLightUniforms
 	{
-		glm::mat4 viewProjection;
+		// Indexed by cube face, in the order of faceOffsets in PointShadowMapInfo
+		std::array<glm::mat4, 6> viewProjections;
+		// Scale in xy and offset in zw from the normalized device coordinates of a face to those of its tile in the atlas
+		std::array<glm::vec4, 6> faceAtlasTransforms;
 		glm::vec3 lightPos;
 		float maxDistance;
 	};
 
-	struct PointLightPushConstantData
+	struct ShadowCaster
+	{
+		EntityId owner;
+		glm::mat4 localToWorld;
+		// Catches changes of the mesh's data, the mesh itself being unchanged
+		glm::vec3 worldBoundingBoxMin;
+		glm::vec3 worldBoundingBoxMax;
+		const MeshAsset* mesh;
+
+		bool operator==(const ShadowCaster& other) const = default;
+	};
+
+	// Entries are indexed by the EntityId::index of the light's entity, those without an image are unused
+	struct CachedDirectionalShadowMap
 	{
-		glm::mat4 model;
+		EntityId light;
+		DirectionalShadowMapInfo info;
+		bool used = false;
+	};
+
+	struct CachedPointShadowMap
+	{
+		EntityId light;
+		glm::vec3 position;
+		// Shadow casters in the light's influence volume when the shadow map was rendered, sorted by owner
+		std::vector<ShadowCaster> casters;
+		// Tiles are allocated if info.faceSize is not 0, they may be smaller than requested when the atlas is full
+		PointShadowMapInfo info = {};
+		uint32_t requestedFaceSize = 0;
+		// Whether the tiles hold the shadow map, it is rendered in the frame its tiles are allocated
+		bool rendered = false;
+		bool used = false;
 	};
 
 	ShadowMapManager _shadowMapManager;
 
+	std::vector<CachedDirectionalShadowMap> _directionalShadowMapCache;
+	// Shadow casters of the whole scene when directional shadow maps were last checked, sorted by owner
+	std::vector<ShadowCaster> _directionalShadowCasters;
+	std::vector<CachedPointShadowMap> _pointShadowMapCache;
+	ShadowAtlas _pointShadowAtlas;
+
+	std::shared_ptr<VKDescriptorSetLayout> _directionalLightDescriptorSetLayout;
+	IndirectDrawGenerator _directionalLightDrawGenerator;
 	std::shared_ptr<VKPipelineLayout> _directionalLightPipelineLayout;
 	std::shared_ptr<VKGraphicsPipeline> _directionalLightPipeline;
 	std::vector<DirectionalShadowMapInfo> _directionalShadowMapInfos;
 
 	std::shared_ptr<VKDescriptorSetLayout> _pointLightDescriptorSetLayout;
 	VKDynamic<VKResizableBuffer<PointLightUniforms>> _pointLightUniformBuffer;
+	IndirectDrawGenerator _pointLightDrawGenerator;
 	std::shared_ptr<VKPipelineLayout> _pointLightPipelineLayout;
 	std::shared_ptr<VKGraphicsPipeline> _pointLightPipeline;
 	std::vector<PointShadowMapInfo> _pointShadowMapInfos;
 
+	std::vector<IndirectDrawGenerator::View> _views;
+	// Positions of the shadow maps to render in _directionalShadowMapInfos or _pointShadowMapInfos
+	std::vector<uint32_t> _outdatedShadowMaps;
+	uint32_t _renderedShadowMapCount = 0;
+
 	ShadowMapPassOutput onRender(const std::shared_ptr<VKCommandBuffer>& commandBuffer, ShadowMapPassInput& input) override;
 	void onResize() override;
 
-	void createDescriptorSetLayout();
-	void createBuffer();
+	void createDescriptorSetLayouts();
+	void createBuffers();
 	void createPipelineLayouts();
 	void createPipelines();
 
-	void renderDirectionalShadowMap(
-		const std::shared_ptr<VKCommandBuffer>& commandBuffer,
-		const DirectionalLight::RenderData& light,
-		const std::vector<ModelRenderer::RenderData>& models
-	);
-
-	void renderPointShadowMap(
-		const std::shared_ptr<VKCommandBuffer>& commandBuffer,
-		const PointLight::RenderData& light,
-		const std::vector<ModelRenderer::RenderData>& models,
-		int uniformIndex
-	);
+	void updateDirectionalShadowMaps(const std::shared_ptr<VKCommandBuffer>& commandBuffer, const RenderRegistry& registry, const ObjectTable& objectTable, const Camera& camera);
+	void updatePointShadowMaps(const std::shared_ptr<VKCommandBuffer>& commandBuffer, const RenderRegistry& registry, const ObjectTable& objectTable, const Camera& camera, bool sceneChanged);
+
+	// Tries each size from maxFaceSize down to minFaceSize, leaves info.faceSize to 0 if none fits
+	void allocatePointShadowMapTiles(PointShadowMapInfo& info, uint32_t maxFaceSize, uint32_t minFaceSize);
+	void freePointShadowMapTiles(PointShadowMapInfo& info);
+
+	static ShadowCaster getShadowCaster(const RenderProxyList<ModelRenderer::RenderData>& models, uint32_t index);
 };
 }
\ No newline at end of file
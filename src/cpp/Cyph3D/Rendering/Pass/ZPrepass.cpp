@@ -1,15 +1,15 @@
 #include "ZPrepass.h"
 
-#include <Cyph3D/Asset/RuntimeAsset/MeshAsset.h>
 #include <Cyph3D/Engine.h>
 #include <Cyph3D/Helper/FileHelper.h>
-#include <Cyph3D/Rendering/RenderRegistry.h>
+#include <Cyph3D/Rendering/IndirectDrawGenerator.h>
+#include <Cyph3D/Rendering/ObjectTable.h>
 #include <Cyph3D/Rendering/SceneRenderer/SceneRenderer.h>
 #include <Cyph3D/Rendering/VertexData.h>
 #include <Cyph3D/Scene/Camera.h>
-#include <Cyph3D/Scene/Transform.h>
 #include <Cyph3D/VKObject/Buffer/VKBuffer.h>
 #include <Cyph3D/VKObject/CommandBuffer/VKCommandBuffer.h>
+#include <Cyph3D/VKObject/DescriptorSet/VKDescriptorSetLayout.h>
 #include <Cyph3D/VKObject/Image/VKImage.h>
 #include <Cyph3D/VKObject/Pipeline/VKGraphicsPipeline.h>
 #include <Cyph3D/VKObject/Pipeline/VKPipelineLayout.h>
@@ -17,6 +17,7 @@
 c3d::ZPrepass::ZPrepass(glm::uvec2 size):
 	RenderPass(size, "Z prepass")
 {
+	createDescriptorSetLayout();
 	createPipelineLayout();
 	createPipeline();
 	createImage();
@@ -33,9 +34,16 @@ c3d::ZPrepassOutput c3d::ZPrepass::onRender(const std::shared_ptr<VKCommandBuffe
 
 	VKRenderingInfo renderingInfo(_size);
 
-	renderingInfo.setDepthAttachment(_depthImage)
-		.setLoadOpClear(1.0f)
-		.setStoreOpStore();
+	VKRenderingDepthAttachmentInfo& depthAttachmentInfo = renderingInfo.setDepthAttachment(_depthImage);
+	if (input.clearDepth)
+	{
+		depthAttachmentInfo.setLoadOpClear(1.0f);
+	}
+	else
+	{
+		depthAttachmentInfo.setLoadOpLoad();
+	}
+	depthAttachmentInfo.setStoreOpStore();
 
 	commandBuffer->beginRendering(renderingInfo);
 
@@ -52,22 +60,16 @@ c3d::ZPrepassOutput c3d::ZPrepass::onRender(const std::shared_ptr<VKCommandBuffe
 	scissor.size = _size;
 	commandBuffer->setScissor(scissor);
 
-	glm::mat4 vp = input.camera.getProjection() * input.camera.getView();
-
-	for (const ModelRenderer::RenderData& model : input.registry.getModelRenderRequests())
+	if (input.objectTable.getObjectCount() > 0)
 	{
-		const std::shared_ptr<VKBuffer<PositionVertexData>>& vertexBuffer = model.mesh.getPositionVertexBuffer();
-		const std::shared_ptr<VKBuffer<uint32_t>>& indexBuffer = model.mesh.getIndexBuffer();
-
-		commandBuffer->bindVertexBuffer(0, vertexBuffer);
-		commandBuffer->bindIndexBuffer(indexBuffer);
+		commandBuffer->pushDescriptor(0, 0, input.objectTable.getBuffer(), 0, input.objectTable.getObjectCount());
+	}
 
-		PushConstantData pushConstantData{};
-		pushConstantData.mvp = vp * model.transform.getLocalToWorldMatrix();
-		commandBuffer->pushConstants(pushConstantData);
+	PushConstantData pushConstantData{};
+	pushConstantData.viewProjection = input.camera.getProjection() * input.camera.getView();
+	commandBuffer->pushConstants(pushConstantData);
 
-		commandBuffer->drawIndexed(indexBuffer->getInfo().getSize(), 0, 0);
-	}
+	input.drawGenerator.draw(commandBuffer, input.viewIndex, false);
 
 	commandBuffer->unbindPipeline();
 
@@ -83,9 +85,18 @@ void c3d::ZPrepass::onResize()
 	createImage();
 }
 
+void c3d::ZPrepass::createDescriptorSetLayout()
+{
+	VKDescriptorSetLayoutInfo info(true);
+	info.addBinding(vk::DescriptorType::eStorageBuffer, 1);
+
+	_descriptorSetLayout = VKDescriptorSetLayout::create(Engine::getVKContext(), info);
+}
+
 void c3d::ZPrepass::createPipelineLayout()
 {
 	VKPipelineLayoutInfo info;
+	info.addDescriptorSetLayout(_descriptorSetLayout);
 	info.setPushConstantLayout<PushConstantData>();
 
 	_pipelineLayout = VKPipelineLayout::create(Engine::getVKContext(), info);
@@ -118,7 +129,7 @@ void c3d::ZPrepass::createImage()
 		_size,
 		1,
 		1,
-		vk::ImageUsageFlagBits::eDepthStencilAttachment
+		vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eSampled
 	);
 	imageInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eDeviceLocal);
 	imageInfo.setSampleCount(vk::SampleCountFlagBits::e4);
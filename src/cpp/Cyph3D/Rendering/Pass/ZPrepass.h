@@ -4,15 +4,22 @@
 
 namespace c3d
 {
-struct RenderRegistry;
 class Camera;
+class IndirectDrawGenerator;
+class ObjectTable;
+class VKDescriptorSetLayout;
 class VKPipelineLayout;
 class VKGraphicsPipeline;
 class VKImage;
 
 struct ZPrepassInput
 {
-	const RenderRegistry& registry;
+	const ObjectTable& objectTable;
+	// Draws of the camera view, rendered in one pass per occlusion culling phase
+	const IndirectDrawGenerator& drawGenerator;
+	uint32_t viewIndex;
+	// Otherwise, the depth of the previous phases is kept
+	bool clearDepth;
 	Camera& camera;
 };
 
@@ -29,9 +36,10 @@ public:
 private:
 	struct PushConstantData
 	{
-		glm::mat4 mvp;
+		glm::mat4 viewProjection;
 	};
 
+	std::shared_ptr<VKDescriptorSetLayout> _descriptorSetLayout;
 	std::shared_ptr<VKPipelineLayout> _pipelineLayout;
 	std::shared_ptr<VKGraphicsPipeline> _pipeline;
 
@@ -40,6 +48,7 @@ private:
 	ZPrepassOutput onRender(const std::shared_ptr<VKCommandBuffer>& commandBuffer, ZPrepassInput& input) override;
 	void onResize() override;
 
+	void createDescriptorSetLayout();
 	void createPipelineLayout();
 	void createPipeline();
 	void createImage();
@@ -1,38 +1,275 @@
 #include "RenderRegistry.h"
 
-void c3d::RenderRegistry::clear()
+#include <Cyph3D/Asset/RuntimeAsset/MeshAsset.h>
+#include <Cyph3D/Entity/Entity.h>
+#include <Cyph3D/Helper/AffineMathHelper.h>
+#include <Cyph3D/Scene/Transform.h>
+#include <Cyph3D/Scene/TransformStore.h>
+
+#include <algorithm>
+#include <chrono>
+#include <tuple>
+
+namespace
+{
+std::pair<glm::vec3, glm::vec3> getLocalBoundingBox(const c3d::ModelRenderer::RenderData& data)
+{
+	return {data.mesh->getBoundingBoxMin(), data.mesh->getBoundingBoxMax()};
+}
+
+// Lights are bounded by their position
+std::pair<glm::vec3, glm::vec3> getLocalBoundingBox(const c3d::DirectionalLight::RenderData&)
+{
+	return {glm::vec3(0), glm::vec3(0)};
+}
+
+std::pair<glm::vec3, glm::vec3> getLocalBoundingBox(const c3d::PointLight::RenderData&)
+{
+	return {glm::vec3(0), glm::vec3(0)};
+}
+}
+
+uint32_t c3d::RenderRegistry::addModel(Entity& owner, const ModelRenderer::RenderData& data)
+{
+	uint32_t id = _models.add(owner, data);
+	addEntityProxy(owner, ProxyType::Model, id);
+	updateWorldData(_models, id);
+	return id;
+}
+
+void c3d::RenderRegistry::updateModel(uint32_t proxy, const ModelRenderer::RenderData& data)
+{
+	_models._data[_models._denseIndices[proxy]] = data;
+	// The bounds depend on the mesh
+	updateWorldData(_models, proxy);
+}
+
+void c3d::RenderRegistry::removeModel(uint32_t proxy)
 {
-	_models.clear();
-	_directionalLights.clear();
-	_pointLights.clear();
+	removeEntityProxy(*_models._owners[_models._denseIndices[proxy]], ProxyType::Model, proxy);
+	_models.remove(proxy);
 }
 
-void c3d::RenderRegistry::addRenderRequest(const ModelRenderer::RenderData& renderData)
+uint32_t c3d::RenderRegistry::addDirectionalLight(Entity& owner, const DirectionalLight::RenderData& data)
 {
-	_models.emplace_back(renderData);
+	uint32_t id = _directionalLights.add(owner, data);
+	addEntityProxy(owner, ProxyType::DirectionalLight, id);
+	updateWorldData(_directionalLights, id);
+	return id;
 }
 
-void c3d::RenderRegistry::addRenderRequest(const DirectionalLight::RenderData& renderData)
+void c3d::RenderRegistry::updateDirectionalLight(uint32_t proxy, const DirectionalLight::RenderData& data)
 {
-	_directionalLights.emplace_back(renderData);
+	_directionalLights._data[_directionalLights._denseIndices[proxy]] = data;
 }
 
-void c3d::RenderRegistry::addRenderRequest(const PointLight::RenderData& renderData)
+void c3d::RenderRegistry::removeDirectionalLight(uint32_t proxy)
 {
-	_pointLights.emplace_back(renderData);
+	removeEntityProxy(*_directionalLights._owners[_directionalLights._denseIndices[proxy]], ProxyType::DirectionalLight, proxy);
+	_directionalLights.remove(proxy);
 }
 
-const std::vector<c3d::ModelRenderer::RenderData>& c3d::RenderRegistry::getModelRenderRequests() const
+uint32_t c3d::RenderRegistry::addPointLight(Entity& owner, const PointLight::RenderData& data)
+{
+	uint32_t id = _pointLights.add(owner, data);
+	addEntityProxy(owner, ProxyType::PointLight, id);
+	updateWorldData(_pointLights, id);
+	return id;
+}
+
+void c3d::RenderRegistry::updatePointLight(uint32_t proxy, const PointLight::RenderData& data)
+{
+	_pointLights._data[_pointLights._denseIndices[proxy]] = data;
+}
+
+void c3d::RenderRegistry::removePointLight(uint32_t proxy)
+{
+	removeEntityProxy(*_pointLights._owners[_pointLights._denseIndices[proxy]], ProxyType::PointLight, proxy);
+	_pointLights.remove(proxy);
+}
+
+void c3d::RenderRegistry::updateTransforms(const TransformStore& transformStore)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	_bvhReinsertionCount = 0;
+
+	for (const TransformStore::Range& range : transformStore.getLastUpdatedRanges())
+	{
+		for (uint32_t i = range.begin; i < range.end; i++)
+		{
+			Transform* transform = transformStore.getHandle(i);
+			// Dead nodes and the scene root have no proxies
+			if (!transform || !transform->getOwner())
+			{
+				continue;
+			}
+
+			uint32_t entityIndex = transform->getOwner()->getId().index;
+			if (entityIndex >= _entityProxies.size())
+			{
+				continue;
+			}
+
+			for (ProxyReference reference : _entityProxies[entityIndex])
+			{
+				switch (reference.type)
+				{
+				case ProxyType::Model:
+					_changedModels.push_back(reference.id);
+					break;
+				case ProxyType::DirectionalLight:
+					_changedDirectionalLights.push_back(reference.id);
+					break;
+				case ProxyType::PointLight:
+					_changedPointLights.push_back(reference.id);
+					break;
+				}
+			}
+		}
+	}
+
+	updateWorldData(_models, _changedModels);
+	updateWorldData(_directionalLights, _changedDirectionalLights);
+	updateWorldData(_pointLights, _changedPointLights);
+
+	_changedModels.clear();
+	_changedDirectionalLights.clear();
+	_changedPointLights.clear();
+
+	_lastBVHReinsertionCount = _bvhReinsertionCount;
+	_lastTransformSyncDuration = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+const c3d::RenderProxyList<c3d::ModelRenderer::RenderData>& c3d::RenderRegistry::getModels() const
 {
 	return _models;
 }
 
-const std::vector<c3d::DirectionalLight::RenderData>& c3d::RenderRegistry::getDirectionalLightRenderRequests() const
+const c3d::RenderProxyList<c3d::DirectionalLight::RenderData>& c3d::RenderRegistry::getDirectionalLights() const
 {
 	return _directionalLights;
 }
 
-const std::vector<c3d::PointLight::RenderData>& c3d::RenderRegistry::getPointLightRenderRequests() const
+const c3d::RenderProxyList<c3d::PointLight::RenderData>& c3d::RenderRegistry::getPointLights() const
 {
 	return _pointLights;
+}
+
+void c3d::RenderRegistry::sortModelsForInstancing(std::span<uint32_t> models) const
+{
+	std::ranges::stable_sort(
+		models,
+		[&](uint32_t a, uint32_t b)
+		{
+			const ModelRenderer::RenderData& dataA = _models._data[a];
+			const ModelRenderer::RenderData& dataB = _models._data[b];
+
+			if (dataA.mesh != dataB.mesh)
+			{
+				return std::less()(dataA.mesh, dataB.mesh);
+			}
+
+			return std::less()(dataA.material, dataB.material);
+		}
+	);
+}
+
+uint32_t c3d::RenderRegistry::getLastBVHReinsertionCount() const
+{
+	return _lastBVHReinsertionCount;
+}
+
+double c3d::RenderRegistry::getLastTransformSyncDuration() const
+{
+	return _lastTransformSyncDuration;
+}
+
+std::unique_ptr<c3d::RenderRegistry> c3d::RenderRegistry::createSnapshot() const
+{
+	return std::unique_ptr<RenderRegistry>(new RenderRegistry(*this));
+}
+
+void c3d::RenderRegistry::addEntityProxy(const Entity& owner, ProxyType type, uint32_t id)
+{
+	uint32_t entityIndex = owner.getId().index;
+	if (entityIndex >= _entityProxies.size())
+	{
+		_entityProxies.resize(entityIndex + 1);
+	}
+
+	_entityProxies[entityIndex].push_back({type, id});
+}
+
+void c3d::RenderRegistry::removeEntityProxy(const Entity& owner, ProxyType type, uint32_t id)
+{
+	std::vector<ProxyReference>& proxies = _entityProxies[owner.getId().index];
+	proxies.erase(std::find_if(
+		proxies.begin(), proxies.end(),
+		[&](const ProxyReference& reference)
+		{
+			return reference.type == type && reference.id == id;
+		}
+	));
+}
+
+template<typename T>
+void c3d::RenderRegistry::updateWorldData(RenderProxyList<T>& list, uint32_t id)
+{
+	updateWorldData(list, std::span(&id, 1));
+}
+
+template<typename T>
+void c3d::RenderRegistry::updateWorldData(RenderProxyList<T>& list, std::span<const uint32_t> ids)
+{
+	if (ids.empty())
+	{
+		return;
+	}
+
+	_batchLocalToWorldMatrices.resize(ids.size());
+	_batchLocalBoundingBoxMins.resize(ids.size());
+	_batchLocalBoundingBoxMaxs.resize(ids.size());
+	_batchWorldBoundingBoxMins.resize(ids.size());
+	_batchWorldBoundingBoxMaxs.resize(ids.size());
+
+	for (size_t i = 0; i < ids.size(); i++)
+	{
+		uint32_t denseIndex = list._denseIndices[ids[i]];
+
+		glm::mat4 localToWorld = list._owners[denseIndex]->getTransform().getLocalToWorldMatrix();
+		list._localToWorldMatrices[denseIndex] = localToWorld;
+
+		_batchLocalToWorldMatrices[i] = localToWorld;
+		std::tie(_batchLocalBoundingBoxMins[i], _batchLocalBoundingBoxMaxs[i]) = getLocalBoundingBox(list._data[denseIndex]);
+	}
+
+	AffineMathHelper::transformBoundingBox(
+		_batchLocalToWorldMatrices,
+		_batchLocalBoundingBoxMins,
+		_batchLocalBoundingBoxMaxs,
+		_batchWorldBoundingBoxMins,
+		_batchWorldBoundingBoxMaxs
+	);
+
+	for (size_t i = 0; i < ids.size(); i++)
+	{
+		uint32_t id = ids[i];
+		uint32_t denseIndex = list._denseIndices[id];
+
+		glm::vec3 worldMin = _batchWorldBoundingBoxMins[i];
+		glm::vec3 worldMax = _batchWorldBoundingBoxMaxs[i];
+		list._worldBoundingBoxMins[denseIndex] = worldMin;
+		list._worldBoundingBoxMaxs[denseIndex] = worldMax;
+
+		uint32_t& leaf = list._bvhLeaves[id];
+		if (leaf == DynamicBVH::NULL_NODE)
+		{
+			leaf = list._bvh.insert(worldMin, worldMax, id);
+		}
+		else if (list._bvh.move(leaf, worldMin, worldMax))
+		{
+			_bvhReinsertionCount++;
+		}
+	}
 }
\ No newline at end of file
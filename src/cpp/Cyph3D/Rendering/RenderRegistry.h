@@ -3,27 +3,257 @@
 #include <Cyph3D/Entity/Component/DirectionalLight.h>
 #include <Cyph3D/Entity/Component/ModelRenderer.h>
 #include <Cyph3D/Entity/Component/PointLight.h>
+#include <Cyph3D/Rendering/DynamicBVH.h>
 
+#include <glm/glm.hpp>
+#include <memory>
+#include <span>
 #include <vector>
 
 namespace c3d
 {
+class Entity;
+class TransformStore;
+
+// Render proxies of one kind.
+// Proxies are referenced through stable IDs, their data is kept densely packed in parallel arrays that passes iterate linearly.
+// Their world bounding boxes are also indexed by a BVH for spatial queries, which return proxy IDs.
+template<typename T>
+class RenderProxyList
+{
+public:
+	size_t getSize() const
+	{
+		return _data.size();
+	}
+
+	bool isEmpty() const
+	{
+		return _data.empty();
+	}
+
+	const std::vector<T>& getData() const
+	{
+		return _data;
+	}
+
+	const std::vector<glm::mat4>& getLocalToWorldMatrices() const
+	{
+		return _localToWorldMatrices;
+	}
+
+	const std::vector<glm::vec3>& getWorldBoundingBoxMins() const
+	{
+		return _worldBoundingBoxMins;
+	}
+
+	const std::vector<glm::vec3>& getWorldBoundingBoxMaxs() const
+	{
+		return _worldBoundingBoxMaxs;
+	}
+
+	const std::vector<Entity*>& getOwners() const
+	{
+		return _owners;
+	}
+
+	const DynamicBVH& getBVH() const
+	{
+		return _bvh;
+	}
+
+	// Position of a proxy in the packed arrays
+	uint32_t getIndex(uint32_t id) const
+	{
+		return _denseIndices[id];
+	}
+
+private:
+	std::vector<T> _data;
+	std::vector<glm::mat4> _localToWorldMatrices;
+	std::vector<glm::vec3> _worldBoundingBoxMins;
+	std::vector<glm::vec3> _worldBoundingBoxMaxs;
+	std::vector<Entity*> _owners;
+
+	std::vector<uint32_t> _ids;
+	std::vector<uint32_t> _denseIndices;
+	std::vector<uint32_t> _freeIds;
+
+	DynamicBVH _bvh;
+	// BVH leaf of each proxy, indexed by ID
+	std::vector<uint32_t> _bvhLeaves;
+
+	uint32_t add(Entity& owner, const T& data)
+	{
+		uint32_t id;
+		if (!_freeIds.empty())
+		{
+			id = _freeIds.back();
+			_freeIds.pop_back();
+		}
+		else
+		{
+			id = _denseIndices.size();
+			_denseIndices.emplace_back();
+			_bvhLeaves.emplace_back();
+		}
+
+		_denseIndices[id] = _data.size();
+		// Inserted once its world bounding box is known
+		_bvhLeaves[id] = DynamicBVH::NULL_NODE;
+
+		_data.push_back(data);
+		_localToWorldMatrices.emplace_back(1.0f);
+		_worldBoundingBoxMins.emplace_back(0.0f);
+		_worldBoundingBoxMaxs.emplace_back(0.0f);
+		_owners.push_back(&owner);
+		_ids.push_back(id);
+
+		return id;
+	}
+
+	void remove(uint32_t id)
+	{
+		if (_bvhLeaves[id] != DynamicBVH::NULL_NODE)
+		{
+			_bvh.remove(_bvhLeaves[id]);
+		}
+
+		uint32_t denseIndex = _denseIndices[id];
+		uint32_t lastIndex = _data.size() - 1;
+
+		if (denseIndex != lastIndex)
+		{
+			_data[denseIndex] = _data[lastIndex];
+			_localToWorldMatrices[denseIndex] = _localToWorldMatrices[lastIndex];
+			_worldBoundingBoxMins[denseIndex] = _worldBoundingBoxMins[lastIndex];
+			_worldBoundingBoxMaxs[denseIndex] = _worldBoundingBoxMaxs[lastIndex];
+			_owners[denseIndex] = _owners[lastIndex];
+			_ids[denseIndex] = _ids[lastIndex];
+
+			_denseIndices[_ids[denseIndex]] = denseIndex;
+		}
+
+		_data.pop_back();
+		_localToWorldMatrices.pop_back();
+		_worldBoundingBoxMins.pop_back();
+		_worldBoundingBoxMaxs.pop_back();
+		_owners.pop_back();
+		_ids.pop_back();
+
+		_freeIds.push_back(id);
+	}
+
+	friend class RenderRegistry;
+};
+
+// Everything the renderers draw, kept up to date incrementally by the components instead of being rebuilt when the scene changes.
+// Components add a proxy once, update it when their parameters change and remove it when they are destroyed.
+// World matrices and bounds are refreshed after each transform update for the transforms that were recomputed only.
 class RenderRegistry
 {
 public:
-	void clear();
+	RenderRegistry() = default;
+	RenderRegistry& operator=(const RenderRegistry& other) = delete;
+
+	uint32_t addModel(Entity& owner, const ModelRenderer::RenderData& data);
+	void updateModel(uint32_t proxy, const ModelRenderer::RenderData& data);
+	void removeModel(uint32_t proxy);
+
+	uint32_t addDirectionalLight(Entity& owner, const DirectionalLight::RenderData& data);
+	void updateDirectionalLight(uint32_t proxy, const DirectionalLight::RenderData& data);
+	void removeDirectionalLight(uint32_t proxy);
+
+	uint32_t addPointLight(Entity& owner, const PointLight::RenderData& data);
+	void updatePointLight(uint32_t proxy, const PointLight::RenderData& data);
+	void removePointLight(uint32_t proxy);
+
+	// Must be called after every TransformStore::update()
+	void updateTransforms(const TransformStore& transformStore);
+
+	const RenderProxyList<ModelRenderer::RenderData>& getModels() const;
+	const RenderProxyList<DirectionalLight::RenderData>& getDirectionalLights() const;
+	const RenderProxyList<PointLight::RenderData>& getPointLights() const;
+
+	// Groups models sharing a mesh and a material, keeping their relative order within each group
+	void sortModelsForInstancing(std::span<uint32_t> models) const;
 
-	void addRenderRequest(const ModelRenderer::RenderData& renderData);
-	void addRenderRequest(const DirectionalLight::RenderData& renderData);
-	void addRenderRequest(const PointLight::RenderData& renderData);
+	// Calls callback(uint32_t first, uint32_t count) for each run of consecutive models in the list that can be drawn as instances of one draw,
+	// which are the ones sharing their mesh, and their material too if compareMaterials is true.
+	template<typename F>
+	void forEachModelInstanceGroup(std::span<const uint32_t> models, bool compareMaterials, F&& callback) const
+	{
+		uint32_t first = 0;
+		for (uint32_t i = 1; i <= models.size(); i++)
+		{
+			if (i < models.size())
+			{
+				const ModelRenderer::RenderData& a = _models._data[models[first]];
+				const ModelRenderer::RenderData& b = _models._data[models[i]];
+				if (a.mesh == b.mesh && (!compareMaterials || a.material == b.material))
+				{
+					continue;
+				}
+			}
 
-	const std::vector<ModelRenderer::RenderData>& getModelRenderRequests() const;
-	const std::vector<DirectionalLight::RenderData>& getDirectionalLightRenderRequests() const;
-	const std::vector<PointLight::RenderData>& getPointLightRenderRequests() const;
+			callback(first, i - first);
+			first = i;
+		}
+	}
+
+	// Statistics of the last updateTransforms() call
+	uint32_t getLastBVHReinsertionCount() const;
+	double getLastTransformSyncDuration() const;
+
+	// Copy of the current proxies for renders spanning several frames while the scene keeps changing.
+	// Owners are not tracked by the copy and may be destroyed while it is alive.
+	std::unique_ptr<RenderRegistry> createSnapshot() const;
 
 private:
-	std::vector<ModelRenderer::RenderData> _models;
-	std::vector<DirectionalLight::RenderData> _directionalLights;
-	std::vector<PointLight::RenderData> _pointLights;
+	enum class ProxyType
+	{
+		Model,
+		DirectionalLight,
+		PointLight
+	};
+
+	struct ProxyReference
+	{
+		ProxyType type;
+		uint32_t id;
+	};
+
+	RenderProxyList<ModelRenderer::RenderData> _models;
+	RenderProxyList<DirectionalLight::RenderData> _directionalLights;
+	RenderProxyList<PointLight::RenderData> _pointLights;
+
+	// Proxies of each entity, indexed by EntityId::index
+	std::vector<std::vector<ProxyReference>> _entityProxies;
+
+	// Proxies refreshed by updateTransforms(), gathered per list so that their bounds are transformed in one batch
+	std::vector<uint32_t> _changedModels;
+	std::vector<uint32_t> _changedDirectionalLights;
+	std::vector<uint32_t> _changedPointLights;
+
+	std::vector<glm::mat4> _batchLocalToWorldMatrices;
+	std::vector<glm::vec3> _batchLocalBoundingBoxMins;
+	std::vector<glm::vec3> _batchLocalBoundingBoxMaxs;
+	std::vector<glm::vec3> _batchWorldBoundingBoxMins;
+	std::vector<glm::vec3> _batchWorldBoundingBoxMaxs;
+
+	uint32_t _bvhReinsertionCount = 0;
+	uint32_t _lastBVHReinsertionCount = 0;
+	double _lastTransformSyncDuration = 0;
+
+	// Only used by createSnapshot()
+	RenderRegistry(const RenderRegistry& other) = default;
+
+	void addEntityProxy(const Entity& owner, ProxyType type, uint32_t id);
+	void removeEntityProxy(const Entity& owner, ProxyType type, uint32_t id);
+
+	template<typename T>
+	void updateWorldData(RenderProxyList<T>& list, uint32_t id);
+	template<typename T>
+	void updateWorldData(RenderProxyList<T>& list, std::span<const uint32_t> ids);
 };
 }
\ No newline at end of file
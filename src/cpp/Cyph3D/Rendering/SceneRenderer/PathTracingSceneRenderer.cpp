@@ -25,7 +25,7 @@ void c3d::PathTracingSceneRenderer::setAccumulationOnlyMode(bool enabled)
 	_accumulationOnlyMode = enabled;
 }
 
-std::shared_ptr<c3d::VKImage> c3d::PathTracingSceneRenderer::onRender(const std::shared_ptr<VKCommandBuffer>& commandBuffer, Camera& camera, const RenderRegistry& registry, bool sceneChanged, bool cameraChanged)
+std::shared_ptr<c3d::VKImage> c3d::PathTracingSceneRenderer::onRender(const std::shared_ptr<VKCommandBuffer>& commandBuffer, Camera& camera, const RenderRegistry& registry, const SceneChanges& sceneChanges, bool cameraChanged)
 {
 	// Path trace pass
 
@@ -33,7 +33,7 @@ std::shared_ptr<c3d::VKImage> c3d::PathTracingSceneRenderer::onRender(const std:
 		.registry = registry,
 		.camera = camera,
 		.sampleCount = _sampleCount,
-		.sceneChanged = sceneChanged,
+		.sceneChanges = sceneChanges,
 		.cameraChanged = cameraChanged
 	};
 
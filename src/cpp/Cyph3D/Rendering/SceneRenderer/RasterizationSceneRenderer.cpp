@@ -1,11 +1,15 @@
 #include "RasterizationSceneRenderer.h"
 
 #include <Cyph3D/Asset/RuntimeAsset/CubemapAsset.h>
+#include <Cyph3D/Helper/MathHelper.h>
+#include <Cyph3D/Rendering/RenderRegistry.h>
 #include <Cyph3D/VKObject/Image/VKImage.h>
 
 c3d::RasterizationSceneRenderer::RasterizationSceneRenderer(glm::uvec2 size):
 	SceneRenderer("Rasterization SceneRenderer", size),
+	_cameraDrawGenerator("Camera culling"),
 	_zPrepass(size),
+	_depthPyramidPass(size),
 	_shadowMapPass(size),
 	_lightingPass(size),
 	_skyboxPass(size),
@@ -15,35 +19,92 @@ c3d::RasterizationSceneRenderer::RasterizationSceneRenderer(glm::uvec2 size):
 {
 }
 
-std::shared_ptr<c3d::VKImage> c3d::RasterizationSceneRenderer::onRender(const std::shared_ptr<VKCommandBuffer>& commandBuffer, Camera& camera, const RenderRegistry& registry, bool sceneChanged, bool cameraChanged)
+const c3d::RasterizationSceneRenderer::CullingStatistics& c3d::RasterizationSceneRenderer::getCullingStatistics() const
 {
-	// Z prepass
+	return _cullingStatistics;
+}
 
-	ZPrepassInput zPrepassInput{
-		.registry = registry,
+std::shared_ptr<c3d::VKImage> c3d::RasterizationSceneRenderer::onRender(const std::shared_ptr<VKCommandBuffer>& commandBuffer, Camera& camera, const RenderRegistry& registry, const SceneChanges& sceneChanges, bool cameraChanged)
+{
+	// Culling, first phase
+
+	_objectTable.update(registry);
+
+	glm::mat4 viewProjection = camera.getProjection() * camera.getView();
+
+	IndirectDrawGenerator::View cameraView{
+		.frustumPlanes = MathHelper::extractFrustumPlanes(viewProjection),
+		.requiredFlags = 0
+	};
+
+	_cameraDrawGenerator.generateFirstPhase(commandBuffer, _objectTable, cameraView, viewProjection);
+
+	// Z prepass, first phase
+
+	ZPrepassInput zPrepassFirstPhaseInput{
+		.objectTable = _objectTable,
+		.drawGenerator = _cameraDrawGenerator,
+		.viewIndex = 0,
+		.clearDepth = true,
 		.camera = camera
 	};
 
-	ZPrepassOutput zPrepassOutput = _zPrepass.render(commandBuffer, zPrepassInput);
+	ZPrepassOutput zPrepassOutput = _zPrepass.render(commandBuffer, zPrepassFirstPhaseInput);
+
+	// Depth pyramid pass
+
+	DepthPyramidPassInput depthPyramidPassInput{
+		.multisampledDepthImage = zPrepassOutput.multisampledDepthImage
+	};
+
+	DepthPyramidPassOutput depthPyramidPassOutput = _depthPyramidPass.render(commandBuffer, depthPyramidPassInput);
+
+	// Culling, second phase
+
+	_cameraDrawGenerator.generateSecondPhase(commandBuffer, _objectTable, depthPyramidPassOutput.depthPyramidImage);
+
+	_cullingStatistics.drawnModelCount = _cameraDrawGenerator.getDrawnObjectCount();
+	_cullingStatistics.culledModelCount = _cameraDrawGenerator.getCulledObjectCount();
+
+	// Z prepass, second phase
+
+	ZPrepassInput zPrepassSecondPhaseInput{
+		.objectTable = _objectTable,
+		.drawGenerator = _cameraDrawGenerator,
+		.viewIndex = 1,
+		.clearDepth = false,
+		.camera = camera
+	};
+
+	_zPrepass.render(commandBuffer, zPrepassSecondPhaseInput);
 
 	// Shadow map pass
 
 	ShadowMapPassInput shadowMapPassInput{
 		.registry = registry,
-		.sceneChanged = sceneChanged,
+		.objectTable = _objectTable,
+		.sceneChanges = sceneChanges,
+		.camera = camera,
 		.cameraChanged = cameraChanged
 	};
 
 	ShadowMapPassOutput shadowMapPassOutput = _shadowMapPass.render(commandBuffer, shadowMapPassInput);
 
+	_cullingStatistics.shadowDrawnModelCount = shadowMapPassOutput.drawnModelCount;
+	_cullingStatistics.shadowCulledModelCount = shadowMapPassOutput.culledModelCount;
+	_cullingStatistics.renderedShadowMapCount = shadowMapPassOutput.renderedShadowMapCount;
+
 	// Lighting pass
 
 	LightingPassInput lightingPassInput{
 		.multisampledDepthImage = zPrepassOutput.multisampledDepthImage,
 		.registry = registry,
+		.objectTable = _objectTable,
+		.drawGenerator = _cameraDrawGenerator,
 		.camera = camera,
 		.directionalShadowMapInfos = shadowMapPassOutput.directionalShadowMapInfos,
 		.pointShadowMapInfos = shadowMapPassOutput.pointShadowMapInfos,
+		.pointShadowAtlas = shadowMapPassOutput.pointShadowAtlas,
 		.pointLightMaxDistance = shadowMapPassOutput.pointLightMaxDistance
 	};
 
@@ -90,6 +151,7 @@ std::shared_ptr<c3d::VKImage> c3d::RasterizationSceneRenderer::onRender(const st
 void c3d::RasterizationSceneRenderer::onResize()
 {
 	_zPrepass.resize(_size);
+	_depthPyramidPass.resize(_size);
 	_shadowMapPass.resize(_size);
 	_lightingPass.resize(_size);
 	_skyboxPass.resize(_size);
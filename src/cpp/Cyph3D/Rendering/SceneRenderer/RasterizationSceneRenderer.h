@@ -1,6 +1,9 @@
 #pragma once
 
+#include <Cyph3D/Rendering/IndirectDrawGenerator.h>
+#include <Cyph3D/Rendering/ObjectTable.h>
 #include <Cyph3D/Rendering/Pass/BloomPass.h>
+#include <Cyph3D/Rendering/Pass/DepthPyramidPass.h>
 #include <Cyph3D/Rendering/Pass/ExposurePass.h>
 #include <Cyph3D/Rendering/Pass/LightingPass.h>
 #include <Cyph3D/Rendering/Pass/ShadowMapPass.h>
@@ -14,10 +17,27 @@ namespace c3d
 class RasterizationSceneRenderer : public SceneRenderer
 {
 public:
+	// Read back from the GPU a few frames late, camera culled counts include occluded models, shadow counts are summed over all light views the last time shadow maps were rendered
+	struct CullingStatistics
+	{
+		uint32_t drawnModelCount = 0;
+		uint32_t culledModelCount = 0;
+		uint32_t shadowDrawnModelCount = 0;
+		uint32_t shadowCulledModelCount = 0;
+		// Shadow maps rendered by the last frame, not read back
+		uint32_t renderedShadowMapCount = 0;
+	};
+
 	explicit RasterizationSceneRenderer(glm::uvec2 size);
 
+	const CullingStatistics& getCullingStatistics() const;
+
 private:
+	ObjectTable _objectTable;
+	IndirectDrawGenerator _cameraDrawGenerator;
+
 	ZPrepass _zPrepass;
+	DepthPyramidPass _depthPyramidPass;
 	ShadowMapPass _shadowMapPass;
 	LightingPass _lightingPass;
 	SkyboxPass _skyboxPass;
@@ -25,7 +45,9 @@ private:
 	BloomPass _bloomPass;
 	ToneMappingPass _toneMappingPass;
 
-	std::shared_ptr<VKImage> onRender(const std::shared_ptr<VKCommandBuffer>& commandBuffer, Camera& camera, const RenderRegistry& registry, bool sceneChanged, bool cameraChanged) override;
+	CullingStatistics _cullingStatistics;
+
+	std::shared_ptr<VKImage> onRender(const std::shared_ptr<VKCommandBuffer>& commandBuffer, Camera& camera, const RenderRegistry& registry, const SceneChanges& sceneChanges, bool cameraChanged) override;
 	void onResize() override;
 };
 }
\ No newline at end of file
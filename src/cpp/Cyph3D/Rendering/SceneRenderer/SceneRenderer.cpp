@@ -1,6 +1,7 @@
 #include "SceneRenderer.h"
 
 #include <Cyph3D/Rendering/Pass/RenderPass.h>
+#include <Cyph3D/Scene/SceneChangeTracker.h>
 
 const vk::Format c3d::SceneRenderer::DEPTH_FORMAT = vk::Format::eD32Sfloat;
 const vk::Format c3d::SceneRenderer::HDR_COLOR_FORMAT = vk::Format::eR16G16B16A16Sfloat;
@@ -20,10 +21,10 @@ glm::uvec2 c3d::SceneRenderer::getSize() const
 	return _size;
 }
 
-std::shared_ptr<c3d::VKImage> c3d::SceneRenderer::render(const std::shared_ptr<VKCommandBuffer>& commandBuffer, Camera& camera, const RenderRegistry& registry, bool sceneChanged, bool cameraChanged)
+std::shared_ptr<c3d::VKImage> c3d::SceneRenderer::render(const std::shared_ptr<VKCommandBuffer>& commandBuffer, Camera& camera, const RenderRegistry& registry, const SceneChanges& sceneChanges, bool cameraChanged)
 {
 	commandBuffer->pushDebugGroup(_name);
-	std::shared_ptr<VKImage> result = onRender(commandBuffer, camera, registry, _firstRender || sceneChanged, _firstRender || cameraChanged);
+	std::shared_ptr<VKImage> result = onRender(commandBuffer, camera, registry, _firstRender ? SceneChanges::all() : sceneChanges, _firstRender || cameraChanged);
 	commandBuffer->popDebugGroup();
 
 	_firstRender = false;
@@ -9,6 +9,7 @@ class VKCommandBuffer;
 class Camera;
 class VKImage;
 class RenderRegistry;
+class SceneChanges;
 
 class SceneRenderer
 {
@@ -16,7 +17,7 @@ public:
 	SceneRenderer(std::string_view name, glm::uvec2 size);
 	virtual ~SceneRenderer() = default;
 
-	std::shared_ptr<VKImage> render(const std::shared_ptr<VKCommandBuffer>& commandBuffer, Camera& camera, const RenderRegistry& registry, bool sceneChanged, bool cameraChanged);
+	std::shared_ptr<VKImage> render(const std::shared_ptr<VKCommandBuffer>& commandBuffer, Camera& camera, const RenderRegistry& registry, const SceneChanges& sceneChanges, bool cameraChanged);
 	void resize(glm::uvec2 size);
 
 	glm::uvec2 getSize() const;
@@ -28,13 +29,16 @@ public:
 	static const vk::Format POINT_SHADOW_MAP_DEPTH_FORMAT;
 	static const vk::Format FINAL_COLOR_FORMAT;
 
+	// Layers of a directional shadow map, must match lighting.frag
+	static constexpr uint32_t DIRECTIONAL_SHADOW_MAP_CASCADE_COUNT = 4;
+
 protected:
 	std::string _name;
 	glm::uvec2 _size;
 
 	bool _firstRender = true;
 
-	virtual std::shared_ptr<VKImage> onRender(const std::shared_ptr<VKCommandBuffer>& commandBuffer, Camera& camera, const RenderRegistry& registry, bool sceneChanged, bool cameraChanged) = 0;
+	virtual std::shared_ptr<VKImage> onRender(const std::shared_ptr<VKCommandBuffer>& commandBuffer, Camera& camera, const RenderRegistry& registry, const SceneChanges& sceneChanges, bool cameraChanged) = 0;
 	virtual void onResize() = 0;
 };
 }
\ No newline at end of file
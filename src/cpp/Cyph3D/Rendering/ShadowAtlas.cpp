@@ -0,0 +1,129 @@
+#include "ShadowAtlas.h"
+
+#include <Cyph3D/Engine.h>
+#include <Cyph3D/Rendering/SceneRenderer/SceneRenderer.h>
+#include <Cyph3D/VKObject/Image/VKImage.h>
+
+#include <algorithm>
+#include <bit>
+
+c3d::ShadowAtlas::ShadowAtlas(uint32_t size):
+	_size(size),
+	_freeTiles(getLevel(MIN_TILE_SIZE) + 1)
+{
+	_freeTiles[0].push_back({0, 0});
+}
+
+std::optional<c3d::ShadowAtlas::Tile> c3d::ShadowAtlas::allocate(uint32_t size)
+{
+	uint32_t level = getLevel(size);
+
+	// Smallest free tile large enough
+	int freeLevel = level;
+	while (freeLevel >= 0 && _freeTiles[freeLevel].empty())
+	{
+		freeLevel--;
+	}
+
+	if (freeLevel < 0)
+	{
+		return std::nullopt;
+	}
+
+	if (!_image)
+	{
+		createImage();
+	}
+
+	glm::uvec2 offset = _freeTiles[freeLevel].back();
+	_freeTiles[freeLevel].pop_back();
+
+	// Keep the first child of each split, the three others are left free
+	for (uint32_t splitLevel = freeLevel + 1; splitLevel <= level; splitLevel++)
+	{
+		uint32_t childSize = _size >> splitLevel;
+
+		_freeTiles[splitLevel].push_back(offset + glm::uvec2(childSize, 0));
+		_freeTiles[splitLevel].push_back(offset + glm::uvec2(0, childSize));
+		_freeTiles[splitLevel].push_back(offset + glm::uvec2(childSize, childSize));
+	}
+
+	return Tile{
+		.offset = offset,
+		.size = size
+	};
+}
+
+void c3d::ShadowAtlas::free(const Tile& tile)
+{
+	uint32_t level = getLevel(tile.size);
+	glm::uvec2 offset = tile.offset;
+
+	while (level > 0)
+	{
+		uint32_t size = _size >> level;
+		glm::uvec2 parentOffset = offset / (size * 2) * (size * 2);
+
+		std::vector<glm::uvec2>& freeTiles = _freeTiles[level];
+
+		// The tile is merged with its siblings if they are all free
+		bool siblingsFree = true;
+		for (int i = 0; i < 4; i++)
+		{
+			glm::uvec2 siblingOffset = parentOffset + glm::uvec2(i & 1, i >> 1) * size;
+			if (siblingOffset != offset && std::ranges::find(freeTiles, siblingOffset) == freeTiles.end())
+			{
+				siblingsFree = false;
+				break;
+			}
+		}
+
+		if (!siblingsFree)
+		{
+			break;
+		}
+
+		std::erase_if(
+			freeTiles,
+			[&](glm::uvec2 freeTileOffset)
+			{
+				return freeTileOffset / (size * 2) * (size * 2) == parentOffset;
+			}
+		);
+
+		offset = parentOffset;
+		level--;
+	}
+
+	_freeTiles[level].push_back(offset);
+}
+
+uint32_t c3d::ShadowAtlas::getSize() const
+{
+	return _size;
+}
+
+const std::shared_ptr<c3d::VKImage>& c3d::ShadowAtlas::getImage() const
+{
+	return _image;
+}
+
+uint32_t c3d::ShadowAtlas::getLevel(uint32_t size) const
+{
+	return std::countr_zero(_size / size);
+}
+
+void c3d::ShadowAtlas::createImage()
+{
+	VKImageInfo imageInfo(
+		SceneRenderer::POINT_SHADOW_MAP_DEPTH_FORMAT,
+		glm::uvec2(_size),
+		1,
+		1,
+		vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eSampled
+	);
+	imageInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eDeviceLocal);
+	imageInfo.setName("Point light shadow atlas");
+
+	_image = VKImage::create(Engine::getVKContext(), imageInfo);
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace c3d
+{
+class VKImage;
+
+// Depth image of a fixed size shared by several shadow maps, split into square tiles of power of two sizes by a quadtree.
+// A tile is taken from the smallest free tile large enough, split in four as many times as needed. Freed tiles are merged back with their siblings.
+// The image is only created when the first tile is allocated, an atlas that was never used takes no memory.
+class ShadowAtlas
+{
+public:
+	struct Tile
+	{
+		glm::uvec2 offset;
+		uint32_t size;
+	};
+
+	static constexpr uint32_t MIN_TILE_SIZE = 32;
+
+	// The size must be a power of two of at least MIN_TILE_SIZE
+	explicit ShadowAtlas(uint32_t size);
+
+	// The size must be a power of two between MIN_TILE_SIZE and the size of the atlas
+	std::optional<Tile> allocate(uint32_t size);
+	void free(const Tile& tile);
+
+	uint32_t getSize() const;
+	// nullptr until the first tile is allocated
+	const std::shared_ptr<VKImage>& getImage() const;
+
+private:
+	uint32_t _size;
+	std::shared_ptr<VKImage> _image;
+
+	// Offsets of the free tiles by level, the tiles of level n having a size of _size >> n
+	std::vector<std::vector<glm::uvec2>> _freeTiles;
+
+	uint32_t getLevel(uint32_t size) const;
+	void createImage();
+};
+}
\ No newline at end of file
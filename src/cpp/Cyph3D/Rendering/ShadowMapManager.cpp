@@ -3,67 +3,32 @@
 #include <Cyph3D/Engine.h>
 #include <Cyph3D/Rendering/SceneRenderer/SceneRenderer.h>
 
-#include <ranges>
-
 std::shared_ptr<c3d::VKImage> c3d::ShadowMapManager::allocateDirectionalShadowMap(uint32_t resolution)
 {
-	ShadowMapContainer& container = _directionalShadowMaps[resolution];
+	std::vector<std::shared_ptr<VKImage>>& freeShadowMaps = _freeDirectionalShadowMaps[resolution];
 
-	// all shadow maps for this resolution are already in use, create a new one
-	if (container.allocatedShadowMaps == container.shadowMaps.size())
+	if (!freeShadowMaps.empty())
 	{
-		VKImageInfo imageInfo(
-			SceneRenderer::DIRECTIONAL_SHADOW_MAP_DEPTH_FORMAT,
-			glm::uvec2(resolution),
-			1,
-			1,
-			vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eSampled
-		);
-		imageInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eDeviceLocal);
-		imageInfo.setName("Directional light shadow map");
-
-		container.shadowMaps.push_back(VKImage::create(Engine::getVKContext(), imageInfo));
+		std::shared_ptr<VKImage> shadowMap = std::move(freeShadowMaps.back());
+		freeShadowMaps.pop_back();
+		return shadowMap;
 	}
 
-	return container.shadowMaps[container.allocatedShadowMaps++];
-}
-
-std::shared_ptr<c3d::VKImage> c3d::ShadowMapManager::allocatePointShadowMap(uint32_t resolution)
-{
-	ShadowMapContainer& container = _pointShadowMaps[resolution];
-
 	// all shadow maps for this resolution are already in use, create a new one
-	if (container.allocatedShadowMaps == container.shadowMaps.size())
-	{
-		VKImageInfo imageInfo(
-			SceneRenderer::POINT_SHADOW_MAP_DEPTH_FORMAT,
-			glm::uvec2(resolution),
-			6,
-			1,
-			vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eSampled
-		);
-		imageInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eDeviceLocal);
-		imageInfo.enableCubeCompatibility();
-		imageInfo.setName("Point light shadow map");
-
-		container.shadowMaps.push_back(VKImage::create(Engine::getVKContext(), imageInfo));
-	}
-
-	return container.shadowMaps[container.allocatedShadowMaps++];
+	VKImageInfo imageInfo(
+		SceneRenderer::DIRECTIONAL_SHADOW_MAP_DEPTH_FORMAT,
+		glm::uvec2(resolution),
+		SceneRenderer::DIRECTIONAL_SHADOW_MAP_CASCADE_COUNT,
+		1,
+		vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eSampled
+	);
+	imageInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eDeviceLocal);
+	imageInfo.setName("Directional light shadow map");
+
+	return VKImage::create(Engine::getVKContext(), imageInfo);
 }
 
-void c3d::ShadowMapManager::resetDirectionalShadowMapAllocations()
+void c3d::ShadowMapManager::freeDirectionalShadowMap(const std::shared_ptr<VKImage>& shadowMap)
 {
-	for (ShadowMapContainer& container : _directionalShadowMaps | std::views::values)
-	{
-		container.allocatedShadowMaps = 0;
-	}
-}
-
-void c3d::ShadowMapManager::resetPointShadowMapAllocations()
-{
-	for (ShadowMapContainer& container : _pointShadowMaps | std::views::values)
-	{
-		container.allocatedShadowMaps = 0;
-	}
+	_freeDirectionalShadowMaps[shadowMap->getSize(0).x].push_back(shadowMap);
 }
\ No newline at end of file
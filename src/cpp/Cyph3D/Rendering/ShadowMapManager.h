@@ -7,23 +7,17 @@
 
 namespace c3d
 {
+// Pools directional light shadow maps by resolution, a shadow map stays allocated to a light for as long as its content is kept
 class ShadowMapManager
 {
 public:
 	std::shared_ptr<VKImage> allocateDirectionalShadowMap(uint32_t resolution);
-	std::shared_ptr<VKImage> allocatePointShadowMap(uint32_t resolution);
 
-	void resetDirectionalShadowMapAllocations();
-	void resetPointShadowMapAllocations();
+	// Makes the shadow map available to the next allocation of the same resolution
+	void freeDirectionalShadowMap(const std::shared_ptr<VKImage>& shadowMap);
 
 private:
-	struct ShadowMapContainer
-	{
-		std::vector<std::shared_ptr<VKImage>> shadowMaps;
-		size_t allocatedShadowMaps = 0;
-	};
-
-	std::unordered_map<uint32_t, ShadowMapContainer> _directionalShadowMaps;
-	std::unordered_map<uint32_t, ShadowMapContainer> _pointShadowMaps;
+	// Shadow maps not allocated, by resolution
+	std::unordered_map<uint32_t, std::vector<std::shared_ptr<VKImage>>> _freeDirectionalShadowMaps;
 };
 }
\ No newline at end of file
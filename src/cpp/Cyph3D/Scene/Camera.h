@@ -8,6 +8,9 @@ namespace c3d
 class Camera
 {
 public:
+	static constexpr float NEAR_DISTANCE = 0.02f;
+	static constexpr float FAR_DISTANCE = 1000.0f;
+
 	explicit Camera(glm::vec3 position = glm::vec3(0), glm::vec2 sphericalCoords = glm::vec2(0));
 
 	bool update(glm::vec2 mousePosDelta);
@@ -74,8 +77,5 @@ private:
 	void recalculateView() const;
 	void recalculateProjection() const;
 	void recalculateCornerRays() const;
-
-	static constexpr float NEAR_DISTANCE = 0.02f;
-	static constexpr float FAR_DISTANCE = 1000.0f;
 };
 }
\ No newline at end of file
@@ -3,95 +3,141 @@
 #include <Cyph3D/Asset/AssetManager.h>
 #include <Cyph3D/Asset/RuntimeAsset/SkyboxAsset.h>
 #include <Cyph3D/Engine.h>
-#include <Cyph3D/Entity/Component/Component.h>
+#include <Cyph3D/Entity/Component/Animator.h>
+#include <Cyph3D/Entity/Component/DirectionalLight.h>
+#include <Cyph3D/Entity/Component/ModelRenderer.h>
+#include <Cyph3D/Entity/Component/PointLight.h>
 #include <Cyph3D/Entity/Entity.h>
-#include <Cyph3D/Helper/FileHelper.h>
-#include <Cyph3D/Helper/JsonHelper.h>
 #include <Cyph3D/Iterator/EntityConstIterator.h>
 #include <Cyph3D/Iterator/EntityIterator.h>
-#include <Cyph3D/ObjectSerialization.h>
 #include <Cyph3D/Scene/Camera.h>
+#include <Cyph3D/Scene/SceneBinarySerializer.h>
+#include <Cyph3D/Scene/SceneJsonSerializer.h>
+#include <Cyph3D/Scene/SceneLoader.h>
+#include <Cyph3D/Scene/Transform.h>
+#include <Cyph3D/UI/Window/UIMisc.h>
 #include <Cyph3D/UI/Window/UIViewport.h>
 
-#include <glm/gtc/type_ptr.hpp>
-#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
 
-std::atomic_uint64_t c3d::Scene::_changeVersion = 0;
+c3d::Scene::ChangeBatch::ChangeBatch(Scene& scene):
+	_scene(scene),
+	_notificationsDeferred(scene._transformStore.areNotificationsDeferred())
+{
+	_scene._transformStore.setNotificationsDeferred(true);
+}
+
+c3d::Scene::ChangeBatch::~ChangeBatch()
+{
+	// Delivered while the batch is still open so that they are coalesced as well
+	_scene._transformStore.flushNotifications();
+	_scene._transformStore.setNotificationsDeferred(_notificationsDeferred);
+}
 
 c3d::Scene::Scene():
-	_root(Transform::createSceneRoot())
+	_root(Transform::createSceneRoot(_transformStore))
 {
-	_changeVersion++;
 }
 
 c3d::Scene::~Scene()
 {
-	_entities.clear();
+	std::vector<uint32_t> denseIndices;
+	denseIndices.reserve(_entities.size());
+	const std::vector<Transform*>& children = _root->getChildren();
+	for (auto it = children.rbegin(); it != children.rend(); it++)
+	{
+		collectEntitySubtree(*(*it)->getOwner(), denseIndices);
+	}
+	destroyEntities(denseIndices);
 
 	_root.reset();
 }
 
 void c3d::Scene::onUpdate()
 {
-	for (Entity& entity : *this)
+	auto start = std::chrono::high_resolution_clock::now();
+
+	_transformStore.setNotificationsDeferred(UIMisc::isDeferredNotificationsEnabled());
+
+	for (Animator* animator : _animators)
 	{
-		entity.onUpdate();
+		animator->onUpdate();
 	}
+
+	_lastUpdateDuration = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
 }
 
-void c3d::Scene::onPreRender(RenderRegistry& renderRegistry, Camera& camera)
+void c3d::Scene::updateTransforms()
 {
-	for (Entity& entity : *this)
-	{
-		entity.onPreRender(renderRegistry, camera);
-	}
+	_transformStore.update(Engine::getThreadPool());
+	_renderRegistry.updateTransforms(_transformStore);
+	_transformStore.flushNotifications();
+}
+
+double c3d::Scene::getLastUpdateDuration() const
+{
+	return _lastUpdateDuration;
 }
 
 c3d::Entity& c3d::Scene::createEntity(Transform& parent)
 {
+	uint32_t slotIndex;
+	if (!_freeEntitySlots.empty())
+	{
+		slotIndex = _freeEntitySlots.back();
+		_freeEntitySlots.pop_back();
+	}
+	else
+	{
+		slotIndex = _entitySlots.size();
+		_entitySlots.push_back({0, 0});
+	}
+
+	EntitySlot& slot = _entitySlots[slotIndex];
+	slot.denseIndex = _entities.size();
+
 	EntityContainer& container = _entities.emplace_back();
-	container.entity = std::make_unique<Entity>(parent, *this);
-	container.entityChangedConnection = container.entity->getChangedSignal().connect(
-		[]
-		{
-			_changeVersion++;
-		}
-	);
+	container.entity = std::make_unique<Entity>(parent, *this, EntityId{slotIndex, slot.generation});
 
-	_changeVersion++;
+	_changeTracker.markChanged(SceneChangeFlags::eHierarchy);
 
 	return *container.entity;
 }
 
-c3d::EntityIterator c3d::Scene::findEntity(const Entity& entity)
+void c3d::Scene::reserveEntities(size_t count)
 {
-	return std::find_if(
-		begin(), end(),
-		[&](const Entity& e)
-		{
-			return &e == &entity;
-		}
-	);
+	_entities.reserve(_entities.size() + count);
+	_entitySlots.reserve(_entitySlots.size() + count);
+	_transformStore.reserve(count);
 }
 
-c3d::EntityIterator c3d::Scene::removeEntity(EntityIterator where)
+c3d::Entity* c3d::Scene::findEntity(EntityId id)
 {
-	std::vector<Transform*> children = where->getTransform().getChildren();
-	for (Transform* child : children)
-	{
-		auto it = findEntity(*child->getOwner());
-		if (it == end())
-		{
-			throw;
-		}
-		removeEntity(it);
-	}
+	if (id.index >= _entitySlots.size())
+		return nullptr;
+
+	const EntitySlot& slot = _entitySlots[id.index];
+	if (slot.generation != id.generation)
+		return nullptr;
+
+	return _entities[slot.denseIndex].entity.get();
+}
 
-	EntityIterator newIt = EntityIterator(_entities.erase(where.getUnderlyingIterator()));
+c3d::EntityIterator c3d::Scene::findEntity(const Entity& entity)
+{
+	if (&entity.getScene() != this || findEntity(entity.getId()) != &entity)
+		return end();
 
-	_changeVersion++;
+	return EntityIterator(_entities.begin() + _entitySlots[entity.getId().index].denseIndex);
+}
 
-	return newIt;
+void c3d::Scene::removeEntity(EntityIterator where)
+{
+	std::vector<uint32_t> denseIndices;
+	collectEntitySubtree(*where, denseIndices);
+	destroyEntities(denseIndices);
 }
 
 c3d::EntityIterator c3d::Scene::begin()
@@ -114,20 +160,59 @@ c3d::EntityConstIterator c3d::Scene::end() const
 	return EntityConstIterator(_entities.cend());
 }
 
+template<>
+c3d::ComponentPool<c3d::ModelRenderer>& c3d::Scene::getComponentPool<c3d::ModelRenderer>()
+{
+	return _modelRenderers;
+}
+
+template<>
+c3d::ComponentPool<c3d::PointLight>& c3d::Scene::getComponentPool<c3d::PointLight>()
+{
+	return _pointLights;
+}
+
+template<>
+c3d::ComponentPool<c3d::DirectionalLight>& c3d::Scene::getComponentPool<c3d::DirectionalLight>()
+{
+	return _directionalLights;
+}
+
+template<>
+c3d::ComponentPool<c3d::Animator>& c3d::Scene::getComponentPool<c3d::Animator>()
+{
+	return _animators;
+}
+
 c3d::Transform& c3d::Scene::getRoot()
 {
 	return *_root;
 }
 
+c3d::TransformStore& c3d::Scene::getTransformStore()
+{
+	return _transformStore;
+}
+
+c3d::SceneChangeTracker& c3d::Scene::getChangeTracker()
+{
+	return _changeTracker;
+}
+
+c3d::RenderRegistry& c3d::Scene::getRenderRegistry()
+{
+	return _renderRegistry;
+}
+
 void c3d::Scene::setSkybox(std::optional<std::string_view> path)
 {
 	if (path)
 	{
 		_skybox = Engine::getAssetManager().loadSkybox(*path);
 		_skyboxChangedConnection = _skybox->getChangedSignal().connect(
-			[]
+			[this]
 			{
-				_changeVersion++;
+				_changeTracker.markChanged(SceneChangeFlags::eSkybox);
 			}
 		);
 	}
@@ -137,7 +222,7 @@ void c3d::Scene::setSkybox(std::optional<std::string_view> path)
 		_skyboxChangedConnection = {};
 	}
 
-	_changeVersion++;
+	_changeTracker.markChanged(SceneChangeFlags::eSkybox);
 }
 
 c3d::SkyboxAsset* c3d::Scene::getSkybox()
@@ -154,178 +239,79 @@ void c3d::Scene::setSkyboxRotation(float rotation)
 {
 	_skyboxRotation = rotation;
 
-	_changeVersion++;
+	_changeTracker.markChanged(SceneChangeFlags::eSkybox);
 }
 
 void c3d::Scene::load(const std::filesystem::path& path)
 {
-	nlohmann::ordered_json jsonRoot = JsonHelper::loadJsonFromFile(FileHelper::getAssetDirectoryPath() / path);
-
-	int version = jsonRoot["version"].get<int>();
-
-	std::unique_ptr<Scene> scene = std::make_unique<Scene>();
-
-	scene->setName(path.filename().replace_extension().generic_string());
-
-	Camera camera;
-	const nlohmann::ordered_json& jsonCamera = jsonRoot["camera"];
-
-	const nlohmann::ordered_json& jsonCameraPosition = jsonCamera["position"];
-	glm::vec3 cameraPosition = {
-		jsonCameraPosition.at(0).get<float>(),
-		jsonCameraPosition.at(1).get<float>(),
-		jsonCameraPosition.at(2).get<float>()
-	};
-	camera.setPosition(cameraPosition);
-
-	const nlohmann::ordered_json& jsonCameraSphericalCoords = jsonCamera["spherical_coords"];
-	glm::vec2 cameraSphericalCoords = {
-		jsonCameraSphericalCoords.at(0).get<float>(),
-		jsonCameraSphericalCoords.at(1).get<float>()
-	};
-	if (version <= 2)
-	{
-		cameraSphericalCoords.x = 180.0f - cameraSphericalCoords.x;
-	}
-	camera.setSphericalCoords(cameraSphericalCoords);
-
-	camera.setExposure(jsonCamera["exposure"].get<float>());
-
-	UIViewport::setCamera(camera);
-
-	if (version <= 1)
-	{
-		nlohmann::ordered_json& jsonSkybox = jsonRoot["skybox"];
-		if (!jsonSkybox.is_null())
-		{
-			spdlog::info("Scene deseralization: converting skybox identifier from version 1.");
-			std::string oldName = jsonSkybox["name"].get<std::string>();
-			std::string newFileName = std::filesystem::path(oldName).filename().generic_string();
-			std::string convertedPath = std::format("skyboxes/{}/{}.c3dskybox", oldName, newFileName);
-			if (std::filesystem::exists(FileHelper::getAssetDirectoryPath() / convertedPath))
-			{
-				scene->setSkybox(convertedPath);
-			}
-			else
-			{
-				spdlog::warn("Scene deseralization: unable to convert skybox identifier from version 1.");
-			}
-
-			scene->setSkyboxRotation(jsonSkybox["rotation"].get<float>());
-		}
-	}
-	else if (version <= 3)
-	{
-		nlohmann::ordered_json& jsonSkybox = jsonRoot["skybox"];
-		if (!jsonSkybox.is_null())
-		{
-			scene->setSkybox(jsonSkybox["name"].get<std::string>());
-
-			scene->setSkyboxRotation(jsonSkybox["rotation"].get<float>());
-		}
-	}
-	else
-	{
-		nlohmann::ordered_json& jsonSkyboxPath = jsonRoot["skybox"];
-		if (!jsonSkyboxPath.is_null())
-		{
-			scene->setSkybox(jsonSkyboxPath.get<std::string>());
-		}
-
-		scene->setSkyboxRotation(jsonRoot["skybox_rotation"].get<float>());
-	}
-
-	for (nlohmann::ordered_json& value : jsonRoot["entities"])
-	{
-		deserializeEntity(value, scene->getRoot(), version, *scene);
-	}
-
-	Engine::setScene(std::move(scene));
-}
-
-void c3d::Scene::deserializeEntity(const nlohmann::ordered_json& json, Transform& parent, int version, Scene& scene)
-{
-	ObjectSerialization serialization = ObjectSerialization::fromJson(json);
-
-	Entity& entity = scene.createEntity(parent);
-	entity.deserialize(serialization);
-
-	for (const nlohmann::ordered_json& child : json["children"])
-	{
-		deserializeEntity(child, entity.getTransform(), version, scene);
-	}
+	Engine::setSceneLoader(std::make_unique<SceneLoader>(path, UIMisc::isProgressiveSceneLoadingEnabled()));
 }
 
 void c3d::Scene::save(const std::filesystem::path& path)
 {
 	_name = path.filename().replace_extension().generic_string();
 
-	nlohmann::ordered_json jsonRoot;
-
-	jsonRoot["version"] = 4;
-
-	const Camera& camera = UIViewport::getCamera();
-	nlohmann::ordered_json jsonCamera;
-	glm::vec3 cameraPosition = camera.getPosition();
-	jsonCamera["position"] = {cameraPosition.x, cameraPosition.y, cameraPosition.z};
-	glm::vec2 cameraRotation = camera.getSphericalCoords();
-	jsonCamera["spherical_coords"] = {cameraRotation.x, cameraRotation.y};
-	jsonCamera["exposure"] = camera.getExposure();
-
-	jsonRoot["camera"] = jsonCamera;
-
-	if (_skybox)
+	if (path.extension() == SceneBinarySerializer::EXTENSION)
 	{
-		jsonRoot["skybox"] = _skybox->getSignature().path;
+		SceneBinarySerializer::save(*this, UIViewport::getCamera(), path);
 	}
 	else
 	{
-		jsonRoot["skybox"] = nullptr;
+		SceneJsonSerializer::save(*this, UIViewport::getCamera(), path);
 	}
+}
 
-	jsonRoot["skybox_rotation"] = getSkyboxRotation();
-
-	std::vector<nlohmann::ordered_json> entities;
-	entities.reserve(_root->getChildren().size());
-	for (Transform* child : _root->getChildren())
-	{
-		entities.push_back(serializeEntity(*child->getOwner()));
-	}
+const std::string& c3d::Scene::getName() const
+{
+	return _name;
+}
 
-	jsonRoot["entities"] = entities;
+void c3d::Scene::setName(const std::string& name)
+{
+	_name = name;
 
-	JsonHelper::saveJsonToFile(jsonRoot, path.generic_string());
+	_changeTracker.markChanged(SceneChangeFlags::eOther);
 }
 
-nlohmann::ordered_json c3d::Scene::serializeEntity(const Entity& entity)
+void c3d::Scene::collectEntitySubtree(const Entity& entity, std::vector<uint32_t>& denseIndices) const
 {
-	nlohmann::ordered_json jsonData = entity.serialize().toJson();
-
-	const Transform& transform = entity.getTransform();
-	std::vector<nlohmann::ordered_json> children;
-	children.reserve(transform.getChildren().size());
-	for (Transform* child : transform.getChildren())
+	// Children are collected before their parent so that they are destroyed first,
+	// and in reverse order so that each one is the last element of its parent's children list when removed
+	const std::vector<Transform*>& children = entity.getTransform().getChildren();
+	for (auto it = children.rbegin(); it != children.rend(); it++)
 	{
-		children.push_back(serializeEntity(*child->getOwner()));
+		collectEntitySubtree(*(*it)->getOwner(), denseIndices);
 	}
-	jsonData["children"] = children;
 
-	return jsonData;
+	denseIndices.push_back(_entitySlots[entity.getId().index].denseIndex);
 }
 
-const std::string& c3d::Scene::getName() const
+void c3d::Scene::destroyEntities(std::vector<uint32_t>& denseIndices)
 {
-	return _name;
-}
+	// Destroying leaves first means no transform ever has to move its children to a new parent
+	for (uint32_t denseIndex : denseIndices)
+	{
+		EntityContainer& container = _entities[denseIndex];
 
-void c3d::Scene::setName(const std::string& name)
-{
-	_name = name;
+		EntityId id = container.entity->getId();
+		_changeTracker.markChanged(SceneChangeFlags::eHierarchy);
 
-	_changeVersion++;
-}
+		_entitySlots[id.index].generation++;
+		_freeEntitySlots.push_back(id.index);
 
-uint64_t c3d::Scene::getChangeVersion()
-{
-	return _changeVersion;
+		container.entity.reset();
+	}
+
+	// Swap-remove from the back so that the entity moved into a hole is never one that is being removed
+	std::sort(denseIndices.begin(), denseIndices.end(), std::greater<>());
+	for (uint32_t denseIndex : denseIndices)
+	{
+		uint32_t lastIndex = _entities.size() - 1;
+		if (denseIndex != lastIndex)
+		{
+			_entities[denseIndex] = std::move(_entities[lastIndex]);
+			_entitySlots[_entities[denseIndex].entity->getId().index].denseIndex = denseIndex;
+		}
+		_entities.pop_back();
+	}
 }
\ No newline at end of file
@@ -1,5 +1,12 @@
 #pragma once
 
+#include <Cyph3D/Entity/Component/ComponentPool.h>
+#include <Cyph3D/Entity/Entity.h>
+#include <Cyph3D/Entity/EntityId.h>
+#include <Cyph3D/Rendering/RenderRegistry.h>
+#include <Cyph3D/Scene/SceneChangeTracker.h>
+#include <Cyph3D/Scene/TransformStore.h>
+
 #include <filesystem>
 #include <nlohmann/json.hpp>
 #include <optional>
@@ -9,31 +16,59 @@ namespace c3d
 {
 class SkyboxAsset;
 class Transform;
-class Entity;
 class EntityIterator;
 class EntityConstIterator;
-class RenderRegistry;
-class Camera;
+class ModelRenderer;
+class PointLight;
+class DirectionalLight;
+class Animator;
 
 class Scene
 {
 public:
+	// While alive, transform notifications are deferred and delivered once when it is destroyed.
+	// Meant for creating or modifying many entities at once. Storage can be allocated beforehand with reserveEntities() and getComponentPool<T>().reserve().
+	class ChangeBatch
+	{
+	public:
+		explicit ChangeBatch(Scene& scene);
+		~ChangeBatch();
+
+		ChangeBatch(const ChangeBatch& other) = delete;
+		ChangeBatch& operator=(const ChangeBatch& other) = delete;
+
+	private:
+		Scene& _scene;
+		bool _notificationsDeferred;
+	};
+
 	Scene();
 	~Scene();
 
 	void onUpdate();
-	void onPreRender(RenderRegistry& renderRegistry, Camera& camera);
+	// Also delivers the change notifications deferred since the previous call
+	void updateTransforms();
+	double getLastUpdateDuration() const;
 
 	Entity& createEntity(Transform& parent);
+	void reserveEntities(size_t count);
+	Entity* findEntity(EntityId id);
 	EntityIterator findEntity(const Entity& entity);
-	EntityIterator removeEntity(EntityIterator where);
+	// Removes the entity and all its descendants. Entities from the end of the list fill their places, iterators are invalidated
+	void removeEntity(EntityIterator where);
 
 	EntityIterator begin();
 	EntityIterator end();
 	EntityConstIterator begin() const;
 	EntityConstIterator end() const;
 
+	template<typename T>
+	ComponentPool<T>& getComponentPool();
+
 	Transform& getRoot();
+	TransformStore& getTransformStore();
+	SceneChangeTracker& getChangeTracker();
+	RenderRegistry& getRenderRegistry();
 
 	void setSkybox(std::optional<std::string_view> path);
 	SkyboxAsset* getSkybox();
@@ -47,29 +82,76 @@ public:
 	const std::string& getName() const;
 	void setName(const std::string& name);
 
-	static uint64_t getChangeVersion();
-
 private:
 	struct EntityContainer
 	{
 		std::unique_ptr<Entity> entity;
-		sigslot::scoped_connection entityChangedConnection;
 	};
 
+	struct EntitySlot
+	{
+		uint32_t denseIndex;
+		uint32_t generation;
+	};
+
+	// Declared before the entities so that they can report changes until they are destroyed
+	SceneChangeTracker _changeTracker;
+
+	// Declared before the components so that they can remove their render proxies when destroyed
+	RenderRegistry _renderRegistry;
+
+	// Declared before the entities so that components are always returned to a live pool
+	ComponentPool<ModelRenderer> _modelRenderers;
+	ComponentPool<PointLight> _pointLights;
+	ComponentPool<DirectionalLight> _directionalLights;
+	ComponentPool<Animator> _animators;
+
+	TransformStore _transformStore;
 	std::unique_ptr<Transform> _root;
+	// Entities are densely packed for iteration, slots map stable EntityIds to their current position
 	std::vector<EntityContainer> _entities;
+	std::vector<EntitySlot> _entitySlots;
+	std::vector<uint32_t> _freeEntitySlots;
 	std::string _name = "Untitled Scene";
 
 	SkyboxAsset* _skybox = nullptr;
 	sigslot::scoped_connection _skyboxChangedConnection;
 	float _skyboxRotation = 0;
 
-	static std::atomic_uint64_t _changeVersion;
+	double _lastUpdateDuration = 0;
 
-	static void deserializeEntity(const nlohmann::ordered_json& json, Transform& parent, int version, Scene& scene);
-	static nlohmann::ordered_json serializeEntity(const Entity& entity);
+	void collectEntitySubtree(const Entity& entity, std::vector<uint32_t>& denseIndices) const;
+	void destroyEntities(std::vector<uint32_t>& denseIndices);
 
 	friend class EntityIterator;
 	friend class EntityConstIterator;
 };
+
+template<>
+ComponentPool<ModelRenderer>& Scene::getComponentPool<ModelRenderer>();
+template<>
+ComponentPool<PointLight>& Scene::getComponentPool<PointLight>();
+template<>
+ComponentPool<DirectionalLight>& Scene::getComponentPool<DirectionalLight>();
+template<>
+ComponentPool<Animator>& Scene::getComponentPool<Animator>();
+
+template<typename T>
+T& Entity::addComponent()
+{
+	ComponentPool<T>& pool = _scene.getComponentPool<T>();
+
+	ComponentContainer& container = _components.emplace_back();
+	container.component = std::unique_ptr<Component, ComponentDeleter>(&pool.create(*this), ComponentDeleter{&pool});
+	container.componentChangedConnection = container.component->getChangedSignal().connect(
+		[this]()
+		{
+			notifyChanged(T::changeCategory);
+		}
+	);
+
+	notifyChanged(SceneChangeFlags::eHierarchy);
+
+	return *static_cast<T*>(container.component.get());
+}
 }
\ No newline at end of file
@@ -0,0 +1,422 @@
+#include "SceneBinarySerializer.h"
+
+#include <Cyph3D/Asset/RuntimeAsset/SkyboxAsset.h>
+#include <Cyph3D/Entity/Component/Component.h>
+#include <Cyph3D/Entity/Entity.h>
+#include <Cyph3D/Helper/FileHelper.h>
+#include <Cyph3D/Iterator/ComponentConstIterator.h>
+#include <Cyph3D/MappedFile.h>
+#include <Cyph3D/ObjectSerialization.h>
+#include <Cyph3D/Scene/Camera.h>
+#include <Cyph3D/Scene/Scene.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <nlohmann/json.hpp>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+// File layout (little endian):
+// - FileHeader
+// - EntityRecord[entityCount], in depth-first order so that every parent precedes its children (EntityRecordV1 in version 1 files)
+// - ComponentRecord[componentCount], each entity owning a contiguous range
+// - string table (entity names, component identifiers, skybox path), not null-terminated
+// - component blobs, CBOR encoding of ObjectSerialization::data
+// Every section starts on an 8 bytes boundary.
+
+namespace
+{
+constexpr std::array<char, 8> MAGIC = {'C', '3', 'D', 'S', 'C', 'E', 'N', 'E'};
+constexpr uint32_t FORMAT_VERSION = 2;
+constexpr uint32_t ENTITY_VERSION = 1;
+constexpr uint32_t NO_PARENT = std::numeric_limits<uint32_t>::max();
+constexpr uint64_t SECTION_ALIGNMENT = 8;
+// Entities built by a single task, each task creates its entities straight from the mapped records
+constexpr uint32_t ENTITY_BATCH_SIZE = 256;
+
+struct StringRef
+{
+	uint32_t offset;
+	uint32_t size;
+};
+
+struct FileHeader
+{
+	std::array<char, 8> magic;
+	uint32_t version;
+	uint32_t entityCount;
+	uint32_t componentCount;
+	uint32_t hasSkybox;
+	uint64_t entitiesOffset;
+	uint64_t componentsOffset;
+	uint64_t stringsOffset;
+	uint64_t stringsSize;
+	uint64_t blobsOffset;
+	uint64_t blobsSize;
+	std::array<float, 3> cameraPosition;
+	std::array<float, 2> cameraSphericalCoords;
+	float cameraExposure;
+	StringRef skyboxPath;
+	float skyboxRotation;
+	uint32_t padding;
+};
+
+struct EntityRecord
+{
+	uint32_t parent;
+	// Version of the name and transform data, like the version of the entities in the JSON format. Components have their own.
+	uint32_t version;
+	StringRef name;
+	std::array<float, 3> position;
+	std::array<float, 4> rotation; // w, x, y, z
+	std::array<float, 3> scale;
+	uint32_t firstComponent;
+	uint32_t componentCount;
+};
+
+struct EntityRecordV1
+{
+	uint32_t parent;
+	StringRef name;
+	std::array<float, 3> position;
+	std::array<float, 4> rotation; // w, x, y, z
+	std::array<float, 3> scale;
+	uint32_t firstComponent;
+	uint32_t componentCount;
+};
+
+struct ComponentRecord
+{
+	StringRef identifier;
+	int32_t version;
+	uint32_t padding;
+	uint64_t blobOffset;
+	uint64_t blobSize;
+};
+
+static_assert(std::is_trivially_copyable_v<FileHeader>);
+static_assert(std::is_trivially_copyable_v<EntityRecord>);
+static_assert(std::is_trivially_copyable_v<EntityRecordV1>);
+static_assert(std::is_trivially_copyable_v<ComponentRecord>);
+
+uint64_t alignOffset(uint64_t offset)
+{
+	return (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+}
+
+std::span<const std::byte> getSection(std::span<const std::byte> data, uint64_t offset, uint64_t size)
+{
+	if (offset > data.size() || data.size() - offset < size)
+	{
+		throw std::runtime_error("Binary scene file is truncated or corrupted.");
+	}
+
+	return data.subspan(offset, size);
+}
+
+template<typename T>
+T readRecord(std::span<const std::byte> section, uint64_t index)
+{
+	T record;
+	std::memcpy(&record, section.data() + index * sizeof(T), sizeof(T));
+	return record;
+}
+
+std::string_view readString(std::span<const std::byte> strings, StringRef ref)
+{
+	std::span<const std::byte> string = getSection(strings, ref.offset, ref.size);
+	return {reinterpret_cast<const char*>(string.data()), string.size()};
+}
+
+// Kept alive by the tasks of a load until the last entity is built
+struct MappedScene
+{
+	explicit MappedScene(const std::filesystem::path& path):
+		file(path)
+	{
+	}
+
+	c3d::MappedFile file;
+	uint32_t formatVersion = 0;
+	std::span<const std::byte> entities;
+	std::span<const std::byte> components;
+	std::span<const std::byte> strings;
+	std::span<const std::byte> blobs;
+	// Entities in creation order, only accessed by the tasks
+	std::vector<c3d::Entity*> createdEntities;
+
+	EntityRecord getEntity(uint32_t index) const
+	{
+		if (formatVersion > 1)
+		{
+			return readRecord<EntityRecord>(entities, index);
+		}
+
+		EntityRecordV1 recordV1 = readRecord<EntityRecordV1>(entities, index);
+
+		EntityRecord record;
+		record.parent = recordV1.parent;
+		record.version = 1;
+		record.name = recordV1.name;
+		record.position = recordV1.position;
+		record.rotation = recordV1.rotation;
+		record.scale = recordV1.scale;
+		record.firstComponent = recordV1.firstComponent;
+		record.componentCount = recordV1.componentCount;
+		return record;
+	}
+
+	// Called on the loading thread so that the tasks can read the records without checking them
+	void validateEntity(uint32_t index) const
+	{
+		EntityRecord record = getEntity(index);
+
+		if (record.parent != NO_PARENT && record.parent >= index)
+		{
+			throw std::runtime_error("Binary scene file has an entity stored before its parent.");
+		}
+
+		if (record.version == 0 || record.version > ENTITY_VERSION)
+		{
+			throw std::runtime_error(std::format("Binary scene file has an entity with unsupported version {}.", record.version));
+		}
+
+		if (static_cast<uint64_t>(record.firstComponent) + record.componentCount > components.size() / sizeof(ComponentRecord))
+		{
+			throw std::runtime_error("Binary scene file is truncated or corrupted.");
+		}
+
+		readString(strings, record.name);
+		for (uint32_t i = record.firstComponent; i < record.firstComponent + record.componentCount; i++)
+		{
+			ComponentRecord componentRecord = readRecord<ComponentRecord>(components, i);
+			readString(strings, componentRecord.identifier);
+			getSection(blobs, componentRecord.blobOffset, componentRecord.blobSize);
+		}
+	}
+
+	void createEntity(c3d::Scene& scene, uint32_t index)
+	{
+		EntityRecord record = getEntity(index);
+
+		c3d::Transform& parent = record.parent == NO_PARENT ? scene.getRoot() : createdEntities[record.parent]->getTransform();
+
+		c3d::Entity& entity = scene.createEntity(parent);
+		entity.setName(std::string(readString(strings, record.name)));
+
+		c3d::Transform& transform = entity.getTransform();
+		transform.setLocalPosition(glm::vec3(record.position[0], record.position[1], record.position[2]));
+		transform.setLocalRotation(glm::quat(record.rotation[0], record.rotation[1], record.rotation[2], record.rotation[3]));
+		transform.setLocalScale(glm::vec3(record.scale[0], record.scale[1], record.scale[2]));
+
+		c3d::ObjectSerialization componentSerialization;
+		for (uint32_t i = record.firstComponent; i < record.firstComponent + record.componentCount; i++)
+		{
+			ComponentRecord componentRecord = readRecord<ComponentRecord>(components, i);
+			std::span<const std::byte> blob = blobs.subspan(componentRecord.blobOffset, componentRecord.blobSize);
+
+			componentSerialization.data = nlohmann::ordered_json::from_cbor(
+				reinterpret_cast<const uint8_t*>(blob.data()),
+				reinterpret_cast<const uint8_t*>(blob.data() + blob.size())
+			);
+			componentSerialization.version = componentRecord.version;
+			componentSerialization.identifier = readString(strings, componentRecord.identifier);
+
+			entity.deserializeComponent(componentSerialization);
+		}
+
+		createdEntities.push_back(&entity);
+	}
+};
+
+void writeSection(std::ofstream& file, uint64_t& position, uint64_t offset, const void* data, uint64_t size)
+{
+	static constexpr std::array<char, SECTION_ALIGNMENT> zeros = {};
+	file.write(zeros.data(), static_cast<std::streamsize>(offset - position));
+
+	file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+	position = offset + size;
+}
+}
+
+void c3d::SceneBinarySerializer::load(const std::filesystem::path& path, const std::function<void(SceneLoadTask&& task)>& taskCallback)
+{
+	std::shared_ptr<MappedScene> mappedScene = std::make_shared<MappedScene>(path);
+	std::span<const std::byte> data = mappedScene->file.getData();
+
+	FileHeader header = readRecord<FileHeader>(getSection(data, 0, sizeof(FileHeader)), 0);
+
+	if (header.magic != MAGIC)
+	{
+		throw std::runtime_error(std::format("\"{}\" is not a binary scene file.", path.generic_string()));
+	}
+
+	if (header.version == 0 || header.version > FORMAT_VERSION)
+	{
+		throw std::runtime_error(std::format("Binary scene file \"{}\" has unsupported version {}.", path.generic_string(), header.version));
+	}
+
+	uint64_t entityRecordSize = header.version > 1 ? sizeof(EntityRecord) : sizeof(EntityRecordV1);
+
+	mappedScene->formatVersion = header.version;
+	mappedScene->entities = getSection(data, header.entitiesOffset, header.entityCount * entityRecordSize);
+	mappedScene->components = getSection(data, header.componentsOffset, header.componentCount * sizeof(ComponentRecord));
+	mappedScene->strings = getSection(data, header.stringsOffset, header.stringsSize);
+	mappedScene->blobs = getSection(data, header.blobsOffset, header.blobsSize);
+	mappedScene->createdEntities.reserve(header.entityCount);
+
+	{
+		std::optional<std::string> skyboxPath;
+		if (header.hasSkybox)
+		{
+			skyboxPath = readString(mappedScene->strings, header.skyboxPath);
+		}
+
+		SceneLoadTask task;
+		task.apply = [header, skyboxPath](Scene& scene, Camera& camera)
+		{
+			camera.setPosition(glm::vec3(header.cameraPosition[0], header.cameraPosition[1], header.cameraPosition[2]));
+			camera.setSphericalCoords(glm::vec2(header.cameraSphericalCoords[0], header.cameraSphericalCoords[1]));
+			camera.setExposure(header.cameraExposure);
+
+			if (skyboxPath)
+			{
+				scene.setSkybox(*skyboxPath);
+			}
+			scene.setSkyboxRotation(header.skyboxRotation);
+
+			scene.reserveEntities(header.entityCount);
+		};
+		taskCallback(std::move(task));
+	}
+
+	for (uint32_t begin = 0; begin < header.entityCount; begin += ENTITY_BATCH_SIZE)
+	{
+		uint32_t end = std::min(begin + ENTITY_BATCH_SIZE, header.entityCount);
+
+		for (uint32_t i = begin; i < end; i++)
+		{
+			mappedScene->validateEntity(i);
+		}
+
+		SceneLoadTask task;
+		task.apply = [mappedScene, begin, end](Scene& scene, Camera&)
+		{
+			for (uint32_t i = begin; i < end; i++)
+			{
+				mappedScene->createEntity(scene, i);
+			}
+		};
+		task.loadedEntityCount = end - begin;
+		taskCallback(std::move(task));
+	}
+}
+
+void c3d::SceneBinarySerializer::save(Scene& scene, const Camera& camera, const std::filesystem::path& path)
+{
+	std::vector<EntityRecord> entityRecords;
+	std::vector<ComponentRecord> componentRecords;
+	std::string strings;
+	std::vector<uint8_t> blobs;
+
+	auto addString = [&](std::string_view string)
+	{
+		StringRef ref;
+		ref.offset = static_cast<uint32_t>(strings.size());
+		ref.size = static_cast<uint32_t>(string.size());
+		strings.append(string);
+		return ref;
+	};
+
+	// depth-first traversal, children are pushed in reverse to keep their order
+	std::vector<std::pair<Transform*, uint32_t>> stack;
+	const std::vector<Transform*>& rootChildren = scene.getRoot().getChildren();
+	for (auto it = rootChildren.rbegin(); it != rootChildren.rend(); it++)
+	{
+		stack.emplace_back(*it, NO_PARENT);
+	}
+
+	while (!stack.empty())
+	{
+		auto [transform, parentIndex] = stack.back();
+		stack.pop_back();
+
+		const Entity& entity = *transform->getOwner();
+		uint32_t index = static_cast<uint32_t>(entityRecords.size());
+
+		EntityRecord& record = entityRecords.emplace_back();
+		record.parent = parentIndex;
+		record.version = ENTITY_VERSION;
+		record.name = addString(entity.getName());
+
+		glm::vec3 position = transform->getLocalPosition();
+		record.position = {position.x, position.y, position.z};
+		glm::quat rotation = transform->getLocalRotation();
+		record.rotation = {rotation.w, rotation.x, rotation.y, rotation.z};
+		glm::vec3 scale = transform->getLocalScale();
+		record.scale = {scale.x, scale.y, scale.z};
+
+		record.firstComponent = static_cast<uint32_t>(componentRecords.size());
+		for (const Component& component : entity)
+		{
+			ObjectSerialization componentSerialization = component.serialize();
+
+			ComponentRecord& componentRecord = componentRecords.emplace_back();
+			componentRecord.identifier = addString(componentSerialization.identifier);
+			componentRecord.version = componentSerialization.version;
+			componentRecord.padding = 0;
+			componentRecord.blobOffset = blobs.size();
+			nlohmann::ordered_json::to_cbor(componentSerialization.data, blobs);
+			componentRecord.blobSize = blobs.size() - componentRecord.blobOffset;
+		}
+		record.componentCount = static_cast<uint32_t>(componentRecords.size()) - record.firstComponent;
+
+		const std::vector<Transform*>& children = transform->getChildren();
+		for (auto it = children.rbegin(); it != children.rend(); it++)
+		{
+			stack.emplace_back(*it, index);
+		}
+	}
+
+	FileHeader header{};
+	header.magic = MAGIC;
+	header.version = FORMAT_VERSION;
+	header.entityCount = static_cast<uint32_t>(entityRecords.size());
+	header.componentCount = static_cast<uint32_t>(componentRecords.size());
+
+	glm::vec3 cameraPosition = camera.getPosition();
+	header.cameraPosition = {cameraPosition.x, cameraPosition.y, cameraPosition.z};
+	glm::vec2 cameraSphericalCoords = camera.getSphericalCoords();
+	header.cameraSphericalCoords = {cameraSphericalCoords.x, cameraSphericalCoords.y};
+	header.cameraExposure = camera.getExposure();
+
+	if (SkyboxAsset* skybox = scene.getSkybox())
+	{
+		header.hasSkybox = 1;
+		header.skyboxPath = addString(skybox->getSignature().path);
+	}
+	header.skyboxRotation = scene.getSkyboxRotation();
+
+	header.entitiesOffset = alignOffset(sizeof(FileHeader));
+	header.componentsOffset = alignOffset(header.entitiesOffset + entityRecords.size() * sizeof(EntityRecord));
+	header.stringsOffset = alignOffset(header.componentsOffset + componentRecords.size() * sizeof(ComponentRecord));
+	header.stringsSize = strings.size();
+	header.blobsOffset = alignOffset(header.stringsOffset + header.stringsSize);
+	header.blobsSize = blobs.size();
+
+	std::ofstream file = FileHelper::openFileForWriting(path);
+
+	uint64_t position = 0;
+	writeSection(file, position, 0, &header, sizeof(FileHeader));
+	writeSection(file, position, header.entitiesOffset, entityRecords.data(), entityRecords.size() * sizeof(EntityRecord));
+	writeSection(file, position, header.componentsOffset, componentRecords.data(), componentRecords.size() * sizeof(ComponentRecord));
+	writeSection(file, position, header.stringsOffset, strings.data(), strings.size());
+	writeSection(file, position, header.blobsOffset, blobs.data(), blobs.size());
+}
\ No newline at end of file
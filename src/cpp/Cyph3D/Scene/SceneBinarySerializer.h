@@ -0,0 +1,24 @@
+#pragma once
+
+#include <Cyph3D/Scene/SceneLoadTask.h>
+
+#include <filesystem>
+#include <functional>
+
+namespace c3d
+{
+class Scene;
+class Camera;
+
+// Compact binary scene representation. The JSON .c3dscene format stays the editable source, scenes can be converted
+// between both formats by opening one and saving as the other.
+class SceneBinarySerializer
+{
+public:
+	static constexpr const char* EXTENSION = ".c3dscenebin";
+
+	// Only reads the file, the scene is built by the tasks passed to taskCallback, see SceneLoadTask
+	static void load(const std::filesystem::path& path, const std::function<void(SceneLoadTask&& task)>& taskCallback);
+	static void save(Scene& scene, const Camera& camera, const std::filesystem::path& path);
+};
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#include "SceneChangeTracker.h"
+
+#include <bit>
+
+std::atomic_uint64_t c3d::SceneChangeTracker::_idCounter = 0;
+
+c3d::SceneChanges::SceneChanges(SceneChangeFlags flags):
+	_flags(flags)
+{
+}
+
+c3d::SceneChanges c3d::SceneChanges::all()
+{
+	return SceneChanges(SceneChangeFlags::eAll);
+}
+
+bool c3d::SceneChanges::contains(SceneChangeFlags categories) const
+{
+	return (_flags & categories) != SceneChangeFlags::eNone;
+}
+
+c3d::SceneChangeFlags c3d::SceneChanges::getFlags() const
+{
+	return _flags;
+}
+
+c3d::SceneChangeTracker::SceneChangeTracker():
+	_id(++_idCounter),
+	_currentVersion(1)
+{
+	_categoryVersions.fill(_currentVersion);
+}
+
+void c3d::SceneChangeTracker::markChanged(SceneChangeFlags category)
+{
+	_categoryVersions[getCategoryIndex(category)] = _currentVersion;
+}
+
+c3d::SceneChanges c3d::SceneChangeTracker::collectChanges(SceneChangeCursor& cursor)
+{
+	uint64_t sinceVersion = cursor.trackerId == _id ? cursor.version : 0;
+
+	SceneChangeFlags flags = SceneChangeFlags::eNone;
+	for (size_t i = 0; i < CATEGORY_COUNT; i++)
+	{
+		if (_categoryVersions[i] > sinceVersion)
+		{
+			flags |= static_cast<SceneChangeFlags>(1 << i);
+		}
+	}
+
+	cursor.trackerId = _id;
+	cursor.version = _currentVersion;
+	_currentVersion++;
+
+	return SceneChanges(flags);
+}
+
+size_t c3d::SceneChangeTracker::getCategoryIndex(SceneChangeFlags category)
+{
+	return std::countr_zero(static_cast<uint32_t>(category));
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace c3d
+{
+enum class SceneChangeFlags : uint32_t
+{
+	eNone = 0,
+	eTransform = 1 << 0,
+	// Mesh, material or shadow contribution of a ModelRenderer, including changes of the assets themselves
+	eModel = 1 << 1,
+	eLight = 1 << 2,
+	eSkybox = 1 << 3,
+	// Entities or components added or removed
+	eHierarchy = 1 << 4,
+	// Parameters of a material used by a ModelRenderer, the material assigned to it being unchanged
+	eMaterial = 1 << 5,
+	// Anything that does not affect rendering (names, animator parameters...)
+	eOther = 1 << 6,
+	eAll = (1 << 7) - 1
+};
+
+inline SceneChangeFlags operator|(SceneChangeFlags a, SceneChangeFlags b)
+{
+	return static_cast<SceneChangeFlags>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
+}
+
+inline SceneChangeFlags operator&(SceneChangeFlags a, SceneChangeFlags b)
+{
+	return static_cast<SceneChangeFlags>(static_cast<uint32_t>(a) & static_cast<uint32_t>(b));
+}
+
+inline SceneChangeFlags& operator|=(SceneChangeFlags& a, SceneChangeFlags b)
+{
+	return a = a | b;
+}
+
+class SceneChangeTracker;
+
+// Position of a consumer in the change history of a scene
+struct SceneChangeCursor
+{
+	uint64_t trackerId = 0;
+	uint64_t version = 0;
+};
+
+// What changed in a scene since a consumer last looked at it
+class SceneChanges
+{
+public:
+	// No change at all
+	SceneChanges() = default;
+	explicit SceneChanges(SceneChangeFlags flags);
+
+	// Everything changed
+	static SceneChanges all();
+
+	// Returns true if any of the given categories changed
+	bool contains(SceneChangeFlags categories) const;
+	SceneChangeFlags getFlags() const;
+
+private:
+	SceneChangeFlags _flags = SceneChangeFlags::eNone;
+};
+
+// Records which categories changed so that renderers can update only what changed since their last frame.
+// Changes are grouped into versions, a new version starts every time a consumer collects changes.
+class SceneChangeTracker
+{
+public:
+	SceneChangeTracker();
+	SceneChangeTracker(const SceneChangeTracker& other) = delete;
+	SceneChangeTracker& operator=(const SceneChangeTracker& other) = delete;
+
+	void markChanged(SceneChangeFlags category);
+
+	// Returns the changes made since the cursor was last passed to this tracker, moves the cursor to the current version and starts a new one.
+	// A cursor coming from another scene (or a new one) gets everything reported as changed.
+	SceneChanges collectChanges(SceneChangeCursor& cursor);
+
+private:
+	static constexpr size_t CATEGORY_COUNT = 7;
+
+	uint64_t _id;
+	// Last version each category changed in
+	std::array<uint64_t, CATEGORY_COUNT> _categoryVersions;
+	uint64_t _currentVersion;
+
+	static std::atomic_uint64_t _idCounter;
+
+	static size_t getCategoryIndex(SceneChangeFlags category);
+};
+}
\ No newline at end of file
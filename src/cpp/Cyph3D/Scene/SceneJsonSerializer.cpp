@@ -0,0 +1,502 @@
+#include "SceneJsonSerializer.h"
+
+#include <Cyph3D/Asset/RuntimeAsset/SkyboxAsset.h>
+#include <Cyph3D/Entity/Entity.h>
+#include <Cyph3D/Helper/FileHelper.h>
+#include <Cyph3D/ObjectSerialization.h>
+#include <Cyph3D/Scene/Camera.h>
+#include <Cyph3D/Scene/Scene.h>
+
+#include <format>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+
+namespace
+{
+constexpr int SCENE_VERSION = 4;
+constexpr size_t STREAM_BUFFER_SIZE = 1024 * 1024;
+constexpr uint32_t NO_PARENT = std::numeric_limits<uint32_t>::max();
+
+bool canApplySceneMembers(const nlohmann::ordered_json& jsonRoot)
+{
+	if (!jsonRoot.contains("version") || !jsonRoot.contains("camera") || !jsonRoot.contains("skybox"))
+	{
+		return false;
+	}
+
+	return jsonRoot["version"].get<int>() <= 3 || jsonRoot.contains("skybox_rotation");
+}
+
+void applyJsonSceneMembers(nlohmann::ordered_json& jsonRoot, c3d::Scene& scene, c3d::Camera& camera)
+{
+	int version = jsonRoot["version"].get<int>();
+
+	const nlohmann::ordered_json& jsonCamera = jsonRoot["camera"];
+
+	const nlohmann::ordered_json& jsonCameraPosition = jsonCamera["position"];
+	glm::vec3 cameraPosition = {
+		jsonCameraPosition.at(0).get<float>(),
+		jsonCameraPosition.at(1).get<float>(),
+		jsonCameraPosition.at(2).get<float>()
+	};
+	camera.setPosition(cameraPosition);
+
+	const nlohmann::ordered_json& jsonCameraSphericalCoords = jsonCamera["spherical_coords"];
+	glm::vec2 cameraSphericalCoords = {
+		jsonCameraSphericalCoords.at(0).get<float>(),
+		jsonCameraSphericalCoords.at(1).get<float>()
+	};
+	if (version <= 2)
+	{
+		cameraSphericalCoords.x = 180.0f - cameraSphericalCoords.x;
+	}
+	camera.setSphericalCoords(cameraSphericalCoords);
+
+	camera.setExposure(jsonCamera["exposure"].get<float>());
+
+	if (version <= 1)
+	{
+		nlohmann::ordered_json& jsonSkybox = jsonRoot["skybox"];
+		if (!jsonSkybox.is_null())
+		{
+			spdlog::info("Scene deseralization: converting skybox identifier from version 1.");
+			std::string oldName = jsonSkybox["name"].get<std::string>();
+			std::string newFileName = std::filesystem::path(oldName).filename().generic_string();
+			std::string convertedPath = std::format("skyboxes/{}/{}.c3dskybox", oldName, newFileName);
+			if (std::filesystem::exists(c3d::FileHelper::getAssetDirectoryPath() / convertedPath))
+			{
+				scene.setSkybox(convertedPath);
+			}
+			else
+			{
+				spdlog::warn("Scene deseralization: unable to convert skybox identifier from version 1.");
+			}
+
+			scene.setSkyboxRotation(jsonSkybox["rotation"].get<float>());
+		}
+	}
+	else if (version <= 3)
+	{
+		nlohmann::ordered_json& jsonSkybox = jsonRoot["skybox"];
+		if (!jsonSkybox.is_null())
+		{
+			scene.setSkybox(jsonSkybox["name"].get<std::string>());
+
+			scene.setSkyboxRotation(jsonSkybox["rotation"].get<float>());
+		}
+	}
+	else
+	{
+		nlohmann::ordered_json& jsonSkyboxPath = jsonRoot["skybox"];
+		if (!jsonSkyboxPath.is_null())
+		{
+			scene.setSkybox(jsonSkyboxPath.get<std::string>());
+		}
+
+		scene.setSkyboxRotation(jsonRoot["skybox_rotation"].get<float>());
+	}
+}
+
+// Emits the tasks building entities as soon as their serialized data is complete, only the top-level scene members
+// (camera, skybox, ...) and the entity currently being read are kept as json values.
+class SceneSaxHandler : public nlohmann::json_sax<nlohmann::ordered_json>
+{
+public:
+	explicit SceneSaxHandler(const std::function<void(c3d::SceneLoadTask&& task)>& taskCallback):
+		_taskCallback(taskCallback)
+	{
+		_frames.emplace_back().type = FrameType::Document;
+	}
+
+	void applySceneMembers()
+	{
+		if (_sceneMembersApplied)
+		{
+			return;
+		}
+
+		c3d::SceneLoadTask task;
+		task.apply = [sceneMembers = std::move(_sceneMembers)](c3d::Scene& scene, c3d::Camera& camera) mutable
+		{
+			applyJsonSceneMembers(sceneMembers, scene, camera);
+		};
+		_taskCallback(std::move(task));
+
+		_sceneMembers = nlohmann::ordered_json();
+		_sceneMembersApplied = true;
+	}
+
+	bool null() override
+	{
+		return value(nullptr);
+	}
+
+	bool boolean(bool val) override
+	{
+		return value(val);
+	}
+
+	bool number_integer(number_integer_t val) override
+	{
+		return value(val);
+	}
+
+	bool number_unsigned(number_unsigned_t val) override
+	{
+		return value(val);
+	}
+
+	bool number_float(number_float_t val, const string_t&) override
+	{
+		return value(val);
+	}
+
+	bool string(string_t& val) override
+	{
+		return value(std::move(val));
+	}
+
+	bool binary(binary_t& val) override
+	{
+		return value(std::move(val));
+	}
+
+	bool start_object(std::size_t) override
+	{
+		if (!_captureStack.empty())
+		{
+			_captureStack.push_back(&insertCaptured(nlohmann::ordered_json::object()));
+			return true;
+		}
+
+		Frame& frame = _frames.back();
+		switch (frame.type)
+		{
+		case FrameType::Document:
+			_frames.emplace_back().type = FrameType::Scene;
+			break;
+		case FrameType::EntityArray:
+		{
+			uint32_t entityIndex = _entityCount++;
+
+			c3d::SceneLoadTask task;
+			task.apply = [entities = _entities, parentIndex = frame.parentIndex](c3d::Scene& scene, c3d::Camera&)
+			{
+				c3d::Transform& parent = parentIndex == NO_PARENT ? scene.getRoot() : (*entities)[parentIndex]->getTransform();
+				entities->push_back(&scene.createEntity(parent));
+			};
+			_taskCallback(std::move(task));
+
+			Frame& entityFrame = _frames.emplace_back();
+			entityFrame.type = FrameType::Entity;
+			entityFrame.entityIndex = entityIndex;
+			break;
+		}
+		case FrameType::Scene:
+		case FrameType::Entity:
+		{
+			nlohmann::ordered_json& target = getMemberTarget();
+			target = nlohmann::ordered_json::object();
+			_captureStack.push_back(&target);
+			break;
+		}
+		}
+
+		return true;
+	}
+
+	bool key(string_t& val) override
+	{
+		_key = std::move(val);
+		return true;
+	}
+
+	bool end_object() override
+	{
+		if (!_captureStack.empty())
+		{
+			_captureStack.pop_back();
+			if (_captureStack.empty())
+			{
+				onMemberComplete();
+			}
+			return true;
+		}
+
+		Frame& frame = _frames.back();
+		if (frame.type == FrameType::Entity && !frame.deserialized)
+		{
+			throw std::runtime_error("Scene file contains an entity without data, version or identifier.");
+		}
+
+		_frames.pop_back();
+		return true;
+	}
+
+	bool start_array(std::size_t) override
+	{
+		if (!_captureStack.empty())
+		{
+			_captureStack.push_back(&insertCaptured(nlohmann::ordered_json::array()));
+			return true;
+		}
+
+		Frame& frame = _frames.back();
+		if (frame.type == FrameType::Scene && _key == "entities")
+		{
+			// members are normally all written before the entities, applying them now makes the camera and skybox
+			// available while entities are still being read
+			if (canApplySceneMembers(_sceneMembers))
+			{
+				applySceneMembers();
+			}
+
+			Frame& arrayFrame = _frames.emplace_back();
+			arrayFrame.type = FrameType::EntityArray;
+			arrayFrame.parentIndex = NO_PARENT;
+		}
+		else if (frame.type == FrameType::Entity && _key == "children")
+		{
+			uint32_t parentIndex = frame.entityIndex;
+			Frame& arrayFrame = _frames.emplace_back();
+			arrayFrame.type = FrameType::EntityArray;
+			arrayFrame.parentIndex = parentIndex;
+		}
+		else
+		{
+			nlohmann::ordered_json& target = getMemberTarget();
+			target = nlohmann::ordered_json::array();
+			_captureStack.push_back(&target);
+		}
+
+		return true;
+	}
+
+	bool end_array() override
+	{
+		if (!_captureStack.empty())
+		{
+			_captureStack.pop_back();
+			if (_captureStack.empty())
+			{
+				onMemberComplete();
+			}
+			return true;
+		}
+
+		_frames.pop_back();
+		return true;
+	}
+
+	bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) override
+	{
+		throw std::runtime_error(ex.what());
+	}
+
+private:
+	enum class FrameType
+	{
+		Document,
+		Scene,
+		EntityArray,
+		Entity
+	};
+
+	struct Frame
+	{
+		FrameType type;
+
+		// EntityArray
+		uint32_t parentIndex = NO_PARENT;
+
+		// Entity
+		uint32_t entityIndex = 0;
+		nlohmann::ordered_json members;
+		bool deserialized = false;
+	};
+
+	const std::function<void(c3d::SceneLoadTask&& task)>& _taskCallback;
+
+	// Entities in creation order, only accessed by the tasks
+	std::shared_ptr<std::vector<c3d::Entity*>> _entities = std::make_shared<std::vector<c3d::Entity*>>();
+	uint32_t _entityCount = 0;
+
+	std::vector<Frame> _frames;
+	nlohmann::ordered_json _sceneMembers;
+	bool _sceneMembersApplied = false;
+
+	std::string _key;
+	std::vector<nlohmann::ordered_json*> _captureStack;
+
+	template<typename T>
+	bool value(T&& val)
+	{
+		if (!_captureStack.empty())
+		{
+			insertCaptured(std::forward<T>(val));
+			return true;
+		}
+
+		getMemberTarget() = std::forward<T>(val);
+		onMemberComplete();
+		return true;
+	}
+
+	nlohmann::ordered_json& getMemberTarget()
+	{
+		Frame& frame = _frames.back();
+		switch (frame.type)
+		{
+		case FrameType::Scene:
+			return _sceneMembers[_key];
+		case FrameType::Entity:
+			return frame.members[_key];
+		default:
+			throw std::runtime_error("Scene file has an invalid structure.");
+		}
+	}
+
+	nlohmann::ordered_json& insertCaptured(nlohmann::ordered_json&& val)
+	{
+		nlohmann::ordered_json& parent = *_captureStack.back();
+		if (parent.is_array())
+		{
+			parent.push_back(std::move(val));
+			return parent.back();
+		}
+		else
+		{
+			nlohmann::ordered_json& target = parent[_key];
+			target = std::move(val);
+			return target;
+		}
+	}
+
+	void onMemberComplete()
+	{
+		Frame& frame = _frames.back();
+		if (frame.type != FrameType::Entity || frame.deserialized)
+		{
+			return;
+		}
+
+		if (!frame.members.contains("data") || !frame.members.contains("version") || !frame.members.contains("identifier"))
+		{
+			return;
+		}
+
+		c3d::SceneLoadTask task;
+		task.apply = [entities = _entities, entityIndex = frame.entityIndex, entitySerialization = c3d::ObjectSerialization::fromJson(std::move(frame.members))](c3d::Scene&, c3d::Camera&)
+		{
+			(*entities)[entityIndex]->deserialize(entitySerialization);
+		};
+		task.loadedEntityCount = 1;
+		_taskCallback(std::move(task));
+
+		frame.members = nlohmann::ordered_json();
+		frame.deserialized = true;
+	}
+};
+}
+
+void c3d::SceneJsonSerializer::load(const std::filesystem::path& path, const std::function<void(SceneLoadTask&& task)>& taskCallback)
+{
+	std::vector<char> streamBuffer(STREAM_BUFFER_SIZE);
+	std::ifstream file;
+	file.rdbuf()->pubsetbuf(streamBuffer.data(), static_cast<std::streamsize>(streamBuffer.size()));
+	file.open(path, std::ios::in | std::ios::binary);
+
+	if (file.fail())
+	{
+		throw std::system_error(errno, std::iostream_category(), std::format("Cannot open \"{}\" for reading", path.generic_string()));
+	}
+
+	SceneSaxHandler handler(taskCallback);
+	nlohmann::ordered_json::sax_parse(file, &handler);
+
+	handler.applySceneMembers();
+}
+
+namespace
+{
+void writeEntity(std::ostream& stream, c3d::Entity& entity)
+{
+	c3d::ObjectSerialization entitySerialization = entity.serialize();
+
+	stream << R"({"data":)" << entitySerialization.data;
+	stream << R"(,"version":)" << entitySerialization.version;
+	stream << R"(,"identifier":)" << nlohmann::ordered_json(entitySerialization.identifier);
+	stream << R"(,"children":[)";
+
+	bool first = true;
+	for (c3d::Transform* child : entity.getTransform().getChildren())
+	{
+		if (!first)
+		{
+			stream << ',';
+		}
+		first = false;
+
+		writeEntity(stream, *child->getOwner());
+	}
+
+	stream << "]}";
+}
+}
+
+void c3d::SceneJsonSerializer::save(Scene& scene, const Camera& camera, const std::filesystem::path& path)
+{
+	std::vector<char> streamBuffer(STREAM_BUFFER_SIZE);
+	std::ofstream file;
+	file.rdbuf()->pubsetbuf(streamBuffer.data(), static_cast<std::streamsize>(streamBuffer.size()));
+	file.open(path, std::ios::out | std::ios::binary);
+
+	if (file.fail())
+	{
+		throw std::system_error(errno, std::iostream_category(), std::format("Cannot open \"{}\" for writing", path.generic_string()));
+	}
+
+	nlohmann::ordered_json jsonCamera;
+	glm::vec3 cameraPosition = camera.getPosition();
+	jsonCamera["position"] = {cameraPosition.x, cameraPosition.y, cameraPosition.z};
+	glm::vec2 cameraRotation = camera.getSphericalCoords();
+	jsonCamera["spherical_coords"] = {cameraRotation.x, cameraRotation.y};
+	jsonCamera["exposure"] = camera.getExposure();
+
+	nlohmann::ordered_json jsonSkybox = nullptr;
+	if (SkyboxAsset* skybox = scene.getSkybox())
+	{
+		jsonSkybox = skybox->getSignature().path;
+	}
+
+	file << R"({"version":)" << SCENE_VERSION;
+	file << R"(,"camera":)" << jsonCamera;
+	file << R"(,"skybox":)" << jsonSkybox;
+	file << R"(,"skybox_rotation":)" << nlohmann::ordered_json(scene.getSkyboxRotation());
+	file << R"(,"entities":[)";
+
+	bool first = true;
+	for (Transform* child : scene.getRoot().getChildren())
+	{
+		if (!first)
+		{
+			file << ',';
+		}
+		first = false;
+
+		writeEntity(file, *child->getOwner());
+	}
+
+	file << "]}";
+
+	file.close();
+
+	if (file.fail())
+	{
+		throw std::system_error(errno, std::iostream_category(), std::format("Cannot write \"{}\"", path.generic_string()));
+	}
+}
\ No newline at end of file
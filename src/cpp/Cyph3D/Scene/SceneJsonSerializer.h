@@ -0,0 +1,24 @@
+#pragma once
+
+#include <Cyph3D/Scene/SceneLoadTask.h>
+
+#include <filesystem>
+#include <functional>
+
+namespace c3d
+{
+class Scene;
+class Camera;
+
+// Streaming reader/writer for the .c3dscene JSON format. Entities are written to and read from a buffered file stream
+// one at a time, the whole document is never held in memory.
+class SceneJsonSerializer
+{
+public:
+	static constexpr const char* EXTENSION = ".c3dscene";
+
+	// Only reads the file, the scene is built by the tasks passed to taskCallback, see SceneLoadTask
+	static void load(const std::filesystem::path& path, const std::function<void(SceneLoadTask&& task)>& taskCallback);
+	static void save(Scene& scene, const Camera& camera, const std::filesystem::path& path);
+};
+}
\ No newline at end of file
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace c3d
+{
+class Scene;
+class Camera;
+
+// Part of a scene read from a file. Serializers read on the loading thread and wrap every change to the scene and camera
+// in a task, tasks are run in order on the main thread as this is the only thread allowed to create entities and assets.
+struct SceneLoadTask
+{
+	std::function<void(Scene& scene, Camera& camera)> apply;
+	// number of entities complete once the task has run
+	size_t loadedEntityCount = 0;
+};
+}
\ No newline at end of file
@@ -0,0 +1,187 @@
+#include "SceneLoader.h"
+
+#include <Cyph3D/Helper/FileHelper.h>
+#include <Cyph3D/Scene/Scene.h>
+#include <Cyph3D/Scene/SceneBinarySerializer.h>
+#include <Cyph3D/Scene/SceneJsonSerializer.h>
+
+namespace
+{
+struct SceneLoadCancelled
+{
+};
+}
+
+c3d::SceneLoader::SceneLoader(const std::filesystem::path& path, bool progressive):
+	_path(path),
+	_progressive(progressive),
+	_scene(std::make_unique<Scene>())
+{
+	_loadingScene = _scene.get();
+	_loadingScene->setName(path.filename().replace_extension().generic_string());
+
+	_thread = std::thread(&SceneLoader::read, this);
+}
+
+c3d::SceneLoader::~SceneLoader()
+{
+	{
+		std::scoped_lock lock(_mutex);
+		_cancelled = true;
+	}
+	_condition.notify_one();
+
+	_thread.join();
+}
+
+void c3d::SceneLoader::update()
+{
+	if (_finished)
+	{
+		return;
+	}
+
+	std::chrono::steady_clock::time_point batchStart = std::chrono::steady_clock::now();
+
+	// Released after the lock, the coalesced notifications are delivered outside of it
+	Scene::ChangeBatch changeBatch(*_loadingScene);
+
+	std::unique_lock lock(_mutex);
+
+	while (!_pendingTasks.empty() && !_exception)
+	{
+		if (std::chrono::steady_clock::now() - batchStart >= BATCH_DURATION)
+		{
+			break;
+		}
+
+		SceneLoadTask task = std::move(_pendingTasks.front());
+		_pendingTasks.pop_front();
+
+		lock.unlock();
+		_condition.notify_one();
+
+		std::exception_ptr exception;
+		try
+		{
+			task.apply(*_loadingScene, _camera);
+		}
+		catch (...)
+		{
+			exception = std::current_exception();
+		}
+
+		lock.lock();
+
+		if (exception)
+		{
+			// the tasks depend on each other, none can run after a failed one
+			_exception = exception;
+			_cancelled = true;
+			_condition.notify_one();
+		}
+		else
+		{
+			_loadedEntityCount += task.loadedEntityCount;
+		}
+	}
+
+	_published = _progressive && _loadedEntityCount > 0;
+	_finished = _readFinished && (_pendingTasks.empty() || _exception);
+}
+
+std::unique_ptr<c3d::Scene> c3d::SceneLoader::takeScene(Camera& camera)
+{
+	if (!_scene)
+	{
+		return nullptr;
+	}
+
+	bool ready = _finished ? _exception == nullptr : _published;
+	if (!ready)
+	{
+		return nullptr;
+	}
+
+	camera = _camera;
+	return std::move(_scene);
+}
+
+bool c3d::SceneLoader::isFinished() const
+{
+	return _finished && (!_scene || _exception);
+}
+
+std::exception_ptr c3d::SceneLoader::getException() const
+{
+	return _finished ? _exception : nullptr;
+}
+
+bool c3d::SceneLoader::isProgressive() const
+{
+	return _progressive;
+}
+
+const std::filesystem::path& c3d::SceneLoader::getPath() const
+{
+	return _path;
+}
+
+size_t c3d::SceneLoader::getLoadedEntityCount() const
+{
+	return _loadedEntityCount;
+}
+
+void c3d::SceneLoader::read()
+{
+	std::filesystem::path fullPath = FileHelper::getAssetDirectoryPath() / _path;
+
+	std::function<void(SceneLoadTask&& task)> taskCallback = [this](SceneLoadTask&& task)
+	{
+		std::unique_lock lock(_mutex);
+
+		_condition.wait(
+			lock,
+			[&]()
+			{
+				return _pendingTasks.size() < MAX_PENDING_TASK_COUNT || _cancelled;
+			}
+		);
+
+		if (_cancelled)
+		{
+			throw SceneLoadCancelled();
+		}
+
+		_pendingTasks.push_back(std::move(task));
+	};
+
+	std::exception_ptr exception;
+	try
+	{
+		if (_path.extension() == SceneBinarySerializer::EXTENSION)
+		{
+			SceneBinarySerializer::load(fullPath, taskCallback);
+		}
+		else
+		{
+			SceneJsonSerializer::load(fullPath, taskCallback);
+		}
+	}
+	catch (const SceneLoadCancelled&)
+	{
+	}
+	catch (...)
+	{
+		exception = std::current_exception();
+	}
+
+	std::scoped_lock lock(_mutex);
+
+	// the tasks not run yet are dropped, as after an error raised by a task
+	if (exception && !_exception)
+	{
+		_exception = exception;
+	}
+	_readFinished = true;
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <Cyph3D/Scene/Camera.h>
+#include <Cyph3D/Scene/SceneLoadTask.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace c3d
+{
+class Scene;
+
+// Loads a scene into a detached Scene. The file is read on a worker thread, which only produces SceneLoadTasks. The
+// engine updates the loader every frame on the main thread, which runs the tasks for a few milliseconds and therefore
+// is the only thread creating entities and assets. The scene is swapped in once it is fully loaded or, in progressive
+// mode, as soon as a first batch of entities has been created.
+class SceneLoader
+{
+public:
+	SceneLoader(const std::filesystem::path& path, bool progressive);
+	~SceneLoader();
+
+	SceneLoader(const SceneLoader& other) = delete;
+	SceneLoader& operator=(const SceneLoader& other) = delete;
+
+	SceneLoader(SceneLoader&& other) = delete;
+	SceneLoader& operator=(SceneLoader&& other) = delete;
+
+	// Main thread only. Runs the tasks read so far on the scene being loaded.
+	void update();
+
+	// Main thread only. Returns the scene once it can be displayed, then nullptr.
+	std::unique_ptr<Scene> takeScene(Camera& camera);
+
+	bool isFinished() const;
+	std::exception_ptr getException() const;
+
+	bool isProgressive() const;
+	const std::filesystem::path& getPath() const;
+	size_t getLoadedEntityCount() const;
+
+private:
+	// Time spent running tasks every frame, the previous scene keeps being displayed meanwhile unless the load is progressive
+	static constexpr std::chrono::milliseconds BATCH_DURATION = std::chrono::milliseconds(8);
+	// Bounds the amount of the file read ahead of the main thread
+	static constexpr size_t MAX_PENDING_TASK_COUNT = 4096;
+
+	std::filesystem::path _path;
+	bool _progressive;
+
+	// Main thread only
+	std::unique_ptr<Scene> _scene;
+	Scene* _loadingScene;
+	Camera _camera;
+	bool _published = false;
+	bool _finished = false;
+	size_t _loadedEntityCount = 0;
+
+	// Shared with the worker, guarded by _mutex. _exception is only read without the lock once _finished is set.
+	std::mutex _mutex;
+	std::condition_variable _condition;
+	std::deque<SceneLoadTask> _pendingTasks;
+	bool _readFinished = false;
+	bool _cancelled = false;
+	std::exception_ptr _exception;
+
+	std::thread _thread;
+
+	void read();
+};
+}
\ No newline at end of file
@@ -1,7 +1,9 @@
 #include "Transform.h"
 
 #include <Cyph3D/Helper/VectorHelper.h>
+#include <Cyph3D/Scene/TransformStore.h>
 
+#include <algorithm>
 #include <glm/gtc/matrix_inverse.hpp>
 #include <glm/gtx/quaternion.hpp>
 #include <glm/gtx/transform.hpp>
@@ -21,25 +23,7 @@ void c3d::Transform::setParent(Transform* parent)
 	if (parent == nullptr)
 		throw std::runtime_error("Cannot remove Transform's parent, only changing it is allowed");
 
-	glm::vec3 worldPos = getWorldPosition();
-	glm::quat worldRot = getWorldRotation();
-	glm::vec3 worldScale = getWorldScale();
-
-	glm::vec3 parentPos = parent->getWorldPosition();
-	glm::quat parentRot = parent->getWorldRotation();
-	glm::vec3 parentScale = parent->getWorldScale();
-
-	glm::quat parentRotConjugate = glm::conjugate(parentRot);
-
-	glm::vec3 localPos = (parentRotConjugate *
-	                      (worldPos - parentPos)) /
-	                     parentScale;
-	glm::quat localRot = parentRotConjugate * worldRot;
-	glm::vec3 localScale = glm::conjugate(localRot) * ((localRot * worldScale) / parentScale);
-
-	setLocalPosition(localPos);
-	setLocalRotation(localRot);
-	setLocalScale(localScale);
+	setLocalFromWorld(*parent, getWorldPosition(), getWorldRotation(), getWorldScale());
 
 	if (_parent != nullptr)
 	{
@@ -48,9 +32,9 @@ void c3d::Transform::setParent(Transform* parent)
 	_parent = parent;
 	_parent->_children.push_back(this);
 
-	invalidateWorldCache();
+	_store->setParent(_index, _parent->_index);
 
-	_changed();
+	notifyChanged();
 }
 
 std::vector<c3d::Transform*>& c3d::Transform::getChildren()
@@ -63,104 +47,69 @@ const std::vector<c3d::Transform*>& c3d::Transform::getChildren() const
 	return _children;
 }
 
-void c3d::Transform::invalidateLocalCache() const
-{
-	if (_invalidLocalCache)
-		return;
-	_invalidLocalCache = true;
-	invalidateWorldCache();
-}
-
-void c3d::Transform::invalidateWorldCache() const
-{
-	if (_invalidWorldCache)
-		return;
-	_invalidWorldCache = true;
-
-	for (Transform* child : _children)
-	{
-		child->invalidateWorldCache();
-	}
-}
-
 glm::vec3 c3d::Transform::getLocalPosition() const
 {
-	return _localPosition;
+	return _store->getLocalPosition(_index);
 }
 
 glm::vec3 c3d::Transform::getWorldPosition() const
 {
-	if (_invalidWorldCache)
-	{
-		recalculateWorldCache();
-	}
-	return _cachedWorldPosition;
+	return _store->getWorldPosition(_index);
 }
 
 void c3d::Transform::setLocalPosition(glm::vec3 position)
 {
-	if (position == _localPosition)
+	if (position == getLocalPosition())
 		return;
 
-	_localPosition = position;
-	invalidateLocalCache();
+	_store->setLocalPosition(_index, position);
 
-	_changed();
+	notifyChanged();
 }
 
 glm::quat c3d::Transform::getLocalRotation() const
 {
-	return _localRotation;
+	return _store->getLocalRotation(_index);
 }
 
 glm::quat c3d::Transform::getWorldRotation() const
 {
-	if (_invalidWorldCache)
-	{
-		recalculateWorldCache();
-	}
-	return _cachedWorldRotation;
+	return _store->getWorldRotation(_index);
 }
 
 void c3d::Transform::setLocalRotation(glm::quat rotation)
 {
-	if (rotation == _localRotation)
+	if (rotation == getLocalRotation())
 		return;
 
-	_localRotation = rotation;
-	invalidateLocalCache();
+	_store->setLocalRotation(_index, rotation);
 
-	_changed();
+	notifyChanged();
 }
 
 glm::vec3 c3d::Transform::getLocalScale() const
 {
-	return _localScale;
+	return _store->getLocalScale(_index);
 }
 
 glm::vec3 c3d::Transform::getWorldScale() const
 {
-	if (_invalidWorldCache)
-	{
-		recalculateWorldCache();
-	}
-	return _cachedWorldScale;
+	return _store->getWorldScale(_index);
 }
 
 void c3d::Transform::setLocalScale(glm::vec3 scale)
 {
-	if (scale == _localScale)
+	if (scale == getLocalScale())
 		return;
 
-	_localScale = scale;
-	invalidateLocalCache();
+	_store->setLocalScale(_index, scale);
 
-	_changed();
+	notifyChanged();
 }
 
 glm::vec3 c3d::Transform::getEulerLocalRotation() const
 {
-	return glm::degrees(glm::eulerAngles(_localRotation));
+	return glm::degrees(glm::eulerAngles(getLocalRotation()));
 }
 
 glm::vec3 c3d::Transform::getEulerWorldRotation() const
@@ -173,24 +122,14 @@ void c3d::Transform::setEulerLocalRotation(glm::vec3 eulerRotation)
 	setLocalRotation(glm::quat(glm::radians(eulerRotation)));
 }
 
-const glm::mat4& c3d::Transform::getLocalToParentMatrix() const
+glm::mat4 c3d::Transform::getLocalToParentMatrix() const
 {
-	if (_invalidLocalCache)
-	{
-		recalculateLocalCache();
-	}
-
-	return _cachedLocalToParentMatrix;
+	return _store->getLocalToParentMatrix(_index);
 }
 
-const glm::mat4& c3d::Transform::getParentToLocalMatrix() const
+glm::mat4 c3d::Transform::getParentToLocalMatrix() const
 {
-	if (_invalidLocalCache)
-	{
-		recalculateLocalCache();
-	}
-
-	return _cachedParentToLocalMatrix;
+	return _store->getParentToLocalMatrix(_index);
 }
 
 glm::mat4 c3d::Transform::calcCustomLocalToWorldMatrix(bool translate, bool rotate, bool scale) const
@@ -247,28 +186,19 @@ glm::mat4 c3d::Transform::calcCustomParentToLocalMatrix(bool translate, bool rot
 	return glm::affineInverse(calcCustomLocalToParentMatrix(translate, rotate, scale));
 }
 
-const glm::mat4& c3d::Transform::getLocalToWorldMatrix() const
+glm::mat4 c3d::Transform::getLocalToWorldMatrix() const
 {
-	if (_invalidWorldCache)
-	{
-		recalculateWorldCache();
-	}
-	return _cachedLocalToWorldMatrix;
+	return _store->getLocalToWorldMatrix(_index);
 }
 
-const glm::mat4& c3d::Transform::getWorldToLocalMatrix() const
+glm::mat4 c3d::Transform::getWorldToLocalMatrix() const
 {
-	if (_invalidWorldCache)
-	{
-		recalculateWorldCache();
-	}
-	return _cachedWorldToLocalMatrix;
+	return _store->getWorldToLocalMatrix(_index);
 }
 
-c3d::Transform::Transform():
-	_localPosition(0),
-	_localRotation(glm::identity<glm::quat>()),
-	_localScale(1),
+c3d::Transform::Transform(TransformStore& store):
+	_store(&store),
+	_index(store.create(this, TransformStore::NO_PARENT)),
 	_owner(nullptr)
 {
 }
@@ -276,7 +206,15 @@ c3d::Transform::Transform():
 c3d::Transform::~Transform()
 {
 	if (_parent != nullptr)
-		VectorHelper::removeAll(_parent->_children, this);
+	{
+		// Searching from the back makes removing children in reverse order cheap, which is how scenes destroy hierarchies
+		std::vector<Transform*>& siblings = _parent->_children;
+		auto it = std::find(siblings.rbegin(), siblings.rend(), this);
+		if (it != siblings.rend())
+		{
+			siblings.erase(std::next(it).base());
+		}
+	}
 
 	// We iterate over a copy of _children as child->setParent modify _children, which would cause a vector modification while we iterate over it
 	std::vector<Transform*> children = _children;
@@ -285,6 +223,8 @@ c3d::Transform::~Transform()
 	{
 		child->setParent(_parent);
 	}
+
+	_store->destroy(_index);
 }
 
 c3d::Entity* c3d::Transform::getOwner()
@@ -292,15 +232,23 @@ c3d::Entity* c3d::Transform::getOwner()
 	return _owner;
 }
 
-std::unique_ptr<c3d::Transform> c3d::Transform::createSceneRoot()
+std::unique_ptr<c3d::Transform> c3d::Transform::createSceneRoot(TransformStore& store)
 {
-	return std::unique_ptr<Transform>(new Transform());
+	return std::unique_ptr<Transform>(new Transform(store));
 }
 
 c3d::Transform::Transform(Entity* owner, Transform* parent):
+	_store(parent->_store),
+	_index(parent->_store->create(this, parent->_index)),
+	_parent(parent),
 	_owner(owner)
 {
-	setParent(parent);
+	_parent->_children.push_back(this);
+
+	// New transforms start at the world origin, whatever their parent is
+	setLocalFromWorld(*_parent, glm::vec3(0), glm::quat(1, 0, 0, 0), glm::vec3(1));
+
+	notifyChanged();
 }
 
 glm::vec3 c3d::Transform::getRight() const
@@ -333,56 +281,6 @@ glm::vec3 c3d::Transform::getForward() const
 	return localToWorldDirection(glm::vec3(0, 0, -1));
 }
 
-void c3d::Transform::recalculateWorldCache() const
-{
-	glm::vec3 localPos = getLocalPosition();
-	glm::quat localRot = getLocalRotation();
-	glm::vec3 localScale = getLocalScale();
-
-	glm::mat4 parentLTW;
-
-	glm::vec3 parentPos;
-	glm::quat parentRot;
-	glm::vec3 parentScale;
-
-	if (_parent != nullptr)
-	{
-		parentLTW = _parent->getLocalToWorldMatrix();
-
-		parentPos = _parent->getWorldPosition();
-		parentRot = _parent->getWorldRotation();
-		parentScale = _parent->getWorldScale();
-	}
-	else
-	{
-		parentLTW = glm::mat4(1);
-
-		parentPos = glm::vec3(0);
-		parentRot = glm::quat(1, 0, 0, 0);
-		parentScale = glm::vec3(1);
-	}
-
-	_cachedLocalToWorldMatrix = parentLTW * getLocalToParentMatrix();
-	_cachedWorldToLocalMatrix = glm::affineInverse(_cachedLocalToWorldMatrix);
-
-	_cachedWorldPosition = parentPos +
-	                       parentRot * (localPos * parentScale);
-	_cachedWorldRotation = parentRot * localRot;
-	_cachedWorldScale = glm::conjugate(localRot) * (parentScale * (localRot * localScale));
-
-	_invalidWorldCache = false;
-}
-
-void c3d::Transform::recalculateLocalCache() const
-{
-	_cachedLocalToParentMatrix = glm::translate(_localPosition) *
-	                             glm::toMat4(_localRotation) *
-	                             glm::scale(_localScale);
-	_cachedParentToLocalMatrix = glm::affineInverse(_cachedLocalToParentMatrix);
-
-	_invalidLocalCache = false;
-}
-
 glm::vec3 c3d::Transform::localToWorldDirection(glm::vec3 localDir) const
 {
 	return glm::normalize(glm::vec3(getLocalToWorldMatrix() * glm::vec4(localDir, 0)));
@@ -426,4 +324,31 @@ glm::vec3 c3d::Transform::parentToLocalPosition(glm::vec3 worldDir) const
 sigslot::signal<>& c3d::Transform::getChangedSignal()
 {
 	return _changed;
+}
+
+void c3d::Transform::notifyChanged()
+{
+	if (!_store->deferNotification(_index))
+	{
+		_changed();
+	}
+}
+
+void c3d::Transform::setLocalFromWorld(const Transform& parent, glm::vec3 worldPos, glm::quat worldRot, glm::vec3 worldScale)
+{
+	glm::vec3 parentPos = parent.getWorldPosition();
+	glm::quat parentRot = parent.getWorldRotation();
+	glm::vec3 parentScale = parent.getWorldScale();
+
+	glm::quat parentRotConjugate = glm::conjugate(parentRot);
+
+	glm::vec3 localPos = (parentRotConjugate *
+	                      (worldPos - parentPos)) /
+	                     parentScale;
+	glm::quat localRot = parentRotConjugate * worldRot;
+	glm::vec3 localScale = glm::conjugate(localRot) * ((localRot * worldScale) / parentScale);
+
+	setLocalPosition(localPos);
+	setLocalRotation(localRot);
+	setLocalScale(localScale);
 }
\ No newline at end of file
@@ -9,6 +9,7 @@
 namespace c3d
 {
 class Entity;
+class TransformStore;
 
 class Transform
 {
@@ -48,11 +49,11 @@ public:
 	glm::vec3 getBackward() const;
 	glm::vec3 getForward() const;
 
-	const glm::mat4& getLocalToWorldMatrix() const;
-	const glm::mat4& getWorldToLocalMatrix() const;
+	glm::mat4 getLocalToWorldMatrix() const;
+	glm::mat4 getWorldToLocalMatrix() const;
 
-	const glm::mat4& getLocalToParentMatrix() const;
-	const glm::mat4& getParentToLocalMatrix() const;
+	glm::mat4 getLocalToParentMatrix() const;
+	glm::mat4 getParentToLocalMatrix() const;
 
 	glm::mat4 calcCustomLocalToWorldMatrix(bool translate, bool rotate, bool scale) const;
 	glm::mat4 calcCustomWorldToLocalMatrix(bool translate, bool rotate, bool scale) const;
@@ -76,29 +77,11 @@ public:
 
 	sigslot::signal<>& getChangedSignal();
 
-	static std::unique_ptr<Transform> createSceneRoot();
+	static std::unique_ptr<Transform> createSceneRoot(TransformStore& store);
 
 private:
-	// mandatory, base data. also used for getLocal[Position/Rotation/Scale]()
-	glm::vec3 _localPosition = glm::vec3(0);
-	glm::quat _localRotation = glm::quat(1, 0, 0, 0);
-	glm::vec3 _localScale = glm::vec3(1);
-
-	// used for getWorld[Position/Rotation/Scale]()
-	mutable glm::vec3 _cachedWorldPosition;
-	mutable glm::quat _cachedWorldRotation;
-	mutable glm::vec3 _cachedWorldScale;
-
-	// used for localToWorldMatrix() and worldToLocalMatrix()
-	mutable glm::mat4 _cachedLocalToWorldMatrix;
-	mutable glm::mat4 _cachedWorldToLocalMatrix;
-
-	// used to cache parent<=>local matrices
-	mutable glm::mat4 _cachedLocalToParentMatrix;
-	mutable glm::mat4 _cachedParentToLocalMatrix;
-
-	mutable bool _invalidLocalCache = true;
-	mutable bool _invalidWorldCache = true;
+	TransformStore* _store;
+	uint32_t _index;
 
 	Transform* _parent = nullptr;
 	std::vector<Transform*> _children;
@@ -108,12 +91,12 @@ private:
 	sigslot::signal<> _changed;
 
 	// Scene root constructor
-	Transform();
+	explicit Transform(TransformStore& store);
+
+	void notifyChanged();
 
-	void invalidateLocalCache() const;
-	void invalidateWorldCache() const;
+	void setLocalFromWorld(const Transform& parent, glm::vec3 worldPos, glm::quat worldRot, glm::vec3 worldScale);
 
-	void recalculateWorldCache() const;
-	void recalculateLocalCache() const;
+	friend class TransformStore;
 };
 }
\ No newline at end of file
@@ -0,0 +1,821 @@
+#include "TransformStore.h"
+
+#include <Cyph3D/Helper/AffineMathHelper.h>
+#include <Cyph3D/Scene/Transform.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <span>
+
+uint32_t c3d::TransformStore::create(Transform* handle, uint32_t parent)
+{
+	// Appending stays depth-first only if the parent's subtree is the last one of the array, which is always the case
+	// when a hierarchy is built in depth-first order (scene loading, duplication). Otherwise it is moved there first.
+	if (parent != NO_PARENT)
+	{
+		parent = moveSubtreeEndToBack(parent);
+	}
+
+	uint32_t index = _handles.size();
+	resize(index + 1);
+
+	_handles[index] = handle;
+	_parents[index] = parent;
+	_subtreeSizes[index] = 1;
+	_flags[index] = DIRTY_LOCAL | DIRTY_WORLD | DIRTY_PARENT_TO_LOCAL | DIRTY_WORLD_TO_LOCAL;
+
+	_localPositions[index] = glm::vec3(0);
+	_localRotations[index] = glm::quat(1, 0, 0, 0);
+	_localScales[index] = glm::vec3(1);
+
+	for (uint32_t ancestor = parent; ancestor != NO_PARENT; ancestor = _parents[ancestor])
+	{
+		_subtreeSizes[ancestor]++;
+	}
+
+	_dirtyRanges.push_back({index, index + 1});
+	_chunksValid = false;
+
+	return index;
+}
+
+void c3d::TransformStore::destroy(uint32_t index)
+{
+	if (_flags[index] & NOTIFICATION_PENDING)
+	{
+		_pendingNotifications[_notificationSlots[index]] = nullptr;
+	}
+
+	// Children have already been moved to another parent, the slot stays a hole in its parent's range until the next compaction
+	_handles[index] = nullptr;
+	_flags[index] = DEAD;
+	_holeCount++;
+}
+
+void c3d::TransformStore::reserve(size_t count)
+{
+	size_t capacity = _handles.size() + count;
+
+	_handles.reserve(capacity);
+	_parents.reserve(capacity);
+	_subtreeSizes.reserve(capacity);
+	_flags.reserve(capacity);
+	_notificationSlots.reserve(capacity);
+
+	_localPositions.reserve(capacity);
+	_localRotations.reserve(capacity);
+	_localScales.reserve(capacity);
+
+	_worldPositions.reserve(capacity);
+	_worldRotations.reserve(capacity);
+	_worldScales.reserve(capacity);
+
+	_localToParentMatrices.reserve(capacity);
+	_parentToLocalMatrices.reserve(capacity);
+	_localToWorldMatrices.reserve(capacity);
+	_worldToLocalMatrices.reserve(capacity);
+}
+
+void c3d::TransformStore::setParent(uint32_t index, uint32_t parent)
+{
+	Transform* handle = _handles[index];
+
+	// Making room at the end of the new parent's subtree may move the node as well
+	parent = moveSubtreeEndToBack(parent);
+	index = handle->_index;
+
+	index = moveSubtreeToBack(index);
+	_parents[index] = parent;
+
+	uint32_t subtreeSize = _subtreeSizes[index];
+
+	// The old ancestors keep counting the slots left behind, which are now holes
+	for (uint32_t ancestor = parent; ancestor != NO_PARENT; ancestor = _parents[ancestor])
+	{
+		_subtreeSizes[ancestor] += subtreeSize;
+	}
+
+	markWorldDirty(index);
+}
+
+void c3d::TransformStore::setLocalPosition(uint32_t index, glm::vec3 position)
+{
+	_localPositions[index] = position;
+	markLocalDirty(index);
+}
+
+void c3d::TransformStore::setLocalRotation(uint32_t index, glm::quat rotation)
+{
+	_localRotations[index] = rotation;
+	markLocalDirty(index);
+}
+
+void c3d::TransformStore::setLocalScale(uint32_t index, glm::vec3 scale)
+{
+	_localScales[index] = scale;
+	markLocalDirty(index);
+}
+
+glm::vec3 c3d::TransformStore::getLocalPosition(uint32_t index) const
+{
+	return _localPositions[index];
+}
+
+glm::quat c3d::TransformStore::getLocalRotation(uint32_t index) const
+{
+	return _localRotations[index];
+}
+
+glm::vec3 c3d::TransformStore::getLocalScale(uint32_t index) const
+{
+	return _localScales[index];
+}
+
+glm::vec3 c3d::TransformStore::getWorldPosition(uint32_t index)
+{
+	ensureWorldUpToDate(index);
+	return _worldPositions[index];
+}
+
+glm::quat c3d::TransformStore::getWorldRotation(uint32_t index)
+{
+	ensureWorldUpToDate(index);
+	return _worldRotations[index];
+}
+
+glm::vec3 c3d::TransformStore::getWorldScale(uint32_t index)
+{
+	ensureWorldUpToDate(index);
+	return _worldScales[index];
+}
+
+glm::mat4 c3d::TransformStore::getLocalToParentMatrix(uint32_t index)
+{
+	ensureLocalUpToDate(index);
+	return _localToParentMatrices[index];
+}
+
+glm::mat4 c3d::TransformStore::getParentToLocalMatrix(uint32_t index)
+{
+	if (_flags[index] & DIRTY_PARENT_TO_LOCAL)
+	{
+		ensureLocalUpToDate(index);
+		_parentToLocalMatrices[index] = AffineMathHelper::inverse(_localToParentMatrices[index]);
+		_flags[index] &= ~DIRTY_PARENT_TO_LOCAL;
+	}
+	return _parentToLocalMatrices[index];
+}
+
+glm::mat4 c3d::TransformStore::getLocalToWorldMatrix(uint32_t index)
+{
+	ensureWorldUpToDate(index);
+	return _localToWorldMatrices[index];
+}
+
+glm::mat4 c3d::TransformStore::getWorldToLocalMatrix(uint32_t index)
+{
+	ensureWorldUpToDate(index);
+	if (_flags[index] & DIRTY_WORLD_TO_LOCAL)
+	{
+		_worldToLocalMatrices[index] = AffineMathHelper::inverse(_localToWorldMatrices[index]);
+		_flags[index] &= ~DIRTY_WORLD_TO_LOCAL;
+	}
+	return _worldToLocalMatrices[index];
+}
+
+void c3d::TransformStore::update(BS::light_thread_pool& threadPool)
+{
+	// Compacting only once holes make up half of the store keeps its cost proportional to the number of structural changes
+	bool compactionNeeded = _holeCount > 0 && _holeCount * 2 >= _handles.size();
+
+	if (!compactionNeeded && _dirtyRanges.empty())
+	{
+		_lastUpdatedRanges.clear();
+		return;
+	}
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	if (compactionNeeded)
+	{
+		compact();
+	}
+
+	std::sort(
+		_dirtyRanges.begin(), _dirtyRanges.end(),
+		[](const Range& a, const Range& b)
+		{
+			return a.begin < b.begin;
+		}
+	);
+
+	size_t mergedCount = 0;
+	for (const Range& range : _dirtyRanges)
+	{
+		if (mergedCount > 0 && range.begin <= _dirtyRanges[mergedCount - 1].end)
+		{
+			_dirtyRanges[mergedCount - 1].end = std::max(_dirtyRanges[mergedCount - 1].end, range.end);
+		}
+		else
+		{
+			_dirtyRanges[mergedCount++] = range;
+		}
+	}
+	_dirtyRanges.resize(mergedCount);
+
+	uint32_t dirtyCount = 0;
+	for (const Range& range : _dirtyRanges)
+	{
+		dirtyCount += range.end - range.begin;
+	}
+
+	uint32_t updatedCount = 0;
+	if (dirtyCount >= PARALLEL_UPDATE_THRESHOLD && threadPool.get_thread_count() > 1)
+	{
+		updatedCount = updateParallel(threadPool);
+	}
+	else
+	{
+		// Parents always precede their children, so walking the sorted ranges front to back
+		// guarantees that a parent is up to date by the time its children read its world matrix
+		for (const Range& range : _dirtyRanges)
+		{
+			updatedCount += updateRange(range);
+		}
+	}
+
+	std::swap(_lastUpdatedRanges, _dirtyRanges);
+	_dirtyRanges.clear();
+
+	_lastUpdatedCount = updatedCount;
+	_lastUpdateDuration = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+const std::vector<c3d::TransformStore::Range>& c3d::TransformStore::getLastUpdatedRanges() const
+{
+	return _lastUpdatedRanges;
+}
+
+c3d::Transform* c3d::TransformStore::getHandle(uint32_t index) const
+{
+	return _handles[index];
+}
+
+void c3d::TransformStore::setNotificationsDeferred(bool deferred)
+{
+	if (deferred == _notificationsDeferred)
+		return;
+
+	_notificationsDeferred = deferred;
+
+	if (!deferred)
+	{
+		flushNotifications();
+	}
+}
+
+bool c3d::TransformStore::areNotificationsDeferred() const
+{
+	return _notificationsDeferred;
+}
+
+bool c3d::TransformStore::deferNotification(uint32_t index)
+{
+	_changeCount++;
+
+	if (!_notificationsDeferred)
+	{
+		_immediateNotificationCount++;
+		return false;
+	}
+
+	if (!(_flags[index] & NOTIFICATION_PENDING))
+	{
+		_flags[index] |= NOTIFICATION_PENDING;
+		_notificationSlots[index] = _pendingNotifications.size();
+		_pendingNotifications.push_back(_handles[index]);
+	}
+
+	return true;
+}
+
+void c3d::TransformStore::flushNotifications()
+{
+	if (_changeCount == 0 && _pendingNotifications.empty())
+		return;
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	_lastNotifiedChangeCount = _changeCount;
+	_changeCount = 0;
+
+	// Immediate notifications were delivered by the setters themselves
+	uint32_t deliveredCount = _immediateNotificationCount;
+	_immediateNotificationCount = 0;
+
+	// Slots may change transforms again (queuing them after the current ones, to be delivered by the next flush) or destroy pending ones,
+	// so the queue is walked by index and only the part that existed before the flush is removed
+	size_t pendingCount = _pendingNotifications.size();
+	for (size_t i = 0; i < pendingCount; i++)
+	{
+		Transform* handle = _pendingNotifications[i];
+		if (handle == nullptr)
+			continue;
+
+		_flags[handle->_index] &= ~NOTIFICATION_PENDING;
+		handle->_changed();
+		deliveredCount++;
+	}
+	_pendingNotifications.erase(_pendingNotifications.begin(), _pendingNotifications.begin() + pendingCount);
+
+	for (Transform* handle : _pendingNotifications)
+	{
+		if (handle != nullptr)
+		{
+			_notificationSlots[handle->_index] -= pendingCount;
+		}
+	}
+
+	_lastDeliveredNotificationCount = deliveredCount;
+	_lastNotificationDuration = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+uint32_t c3d::TransformStore::getSize() const
+{
+	return _handles.size();
+}
+
+uint32_t c3d::TransformStore::getLastUpdatedCount() const
+{
+	return _lastUpdatedCount;
+}
+
+double c3d::TransformStore::getLastUpdateDuration() const
+{
+	return _lastUpdateDuration;
+}
+
+uint32_t c3d::TransformStore::getLastNotifiedChangeCount() const
+{
+	return _lastNotifiedChangeCount;
+}
+
+uint32_t c3d::TransformStore::getLastDeliveredNotificationCount() const
+{
+	return _lastDeliveredNotificationCount;
+}
+
+double c3d::TransformStore::getLastNotificationDuration() const
+{
+	return _lastNotificationDuration;
+}
+
+void c3d::TransformStore::markLocalDirty(uint32_t index)
+{
+	_flags[index] |= DIRTY_LOCAL | DIRTY_PARENT_TO_LOCAL;
+	markWorldDirty(index);
+}
+
+void c3d::TransformStore::markWorldDirty(uint32_t index)
+{
+	// A node that is already dirty has all its descendants dirty as well
+	if (_flags[index] & DIRTY_WORLD)
+		return;
+
+	uint32_t end = index + _subtreeSizes[index];
+	for (uint32_t i = index; i < end; i++)
+	{
+		if (!(_flags[i] & DEAD))
+		{
+			_flags[i] |= DIRTY_WORLD | DIRTY_WORLD_TO_LOCAL;
+		}
+	}
+	_dirtyRanges.push_back({index, end});
+}
+
+void c3d::TransformStore::ensureWorldUpToDate(uint32_t index)
+{
+	if (!(_flags[index] & DIRTY_WORLD))
+		return;
+
+	if (_parents[index] != NO_PARENT)
+	{
+		ensureWorldUpToDate(_parents[index]);
+	}
+
+	recalculateWorld(index);
+}
+
+void c3d::TransformStore::ensureLocalUpToDate(uint32_t index)
+{
+	if (!(_flags[index] & DIRTY_LOCAL))
+		return;
+
+	_localToParentMatrices[index] = AffineMathHelper::compose(_localPositions[index], _localRotations[index], _localScales[index]);
+
+	_flags[index] &= ~DIRTY_LOCAL;
+}
+
+void c3d::TransformStore::updateLocalRange(Range range)
+{
+	uint32_t count = range.end - range.begin;
+	AffineMathHelper::compose(
+		std::span(_localPositions).subspan(range.begin, count),
+		std::span(_localRotations).subspan(range.begin, count),
+		std::span(_localScales).subspan(range.begin, count),
+		std::span(_localToParentMatrices).subspan(range.begin, count)
+	);
+
+	for (uint32_t i = range.begin; i < range.end; i++)
+	{
+		_flags[i] &= ~DIRTY_LOCAL;
+	}
+}
+
+void c3d::TransformStore::recalculateWorld(uint32_t index)
+{
+	ensureLocalUpToDate(index);
+
+	glm::vec3 localPos = _localPositions[index];
+	glm::quat localRot = _localRotations[index];
+	glm::vec3 localScale = _localScales[index];
+
+	uint32_t parent = _parents[index];
+	if (parent != NO_PARENT)
+	{
+		glm::vec3 parentPos = _worldPositions[parent];
+		glm::quat parentRot = _worldRotations[parent];
+		glm::vec3 parentScale = _worldScales[parent];
+
+		_localToWorldMatrices[index] = AffineMathHelper::multiply(_localToWorldMatrices[parent], _localToParentMatrices[index]);
+
+		_worldPositions[index] = parentPos + parentRot * (localPos * parentScale);
+		_worldRotations[index] = parentRot * localRot;
+		_worldScales[index] = glm::conjugate(localRot) * (parentScale * (localRot * localScale));
+	}
+	else
+	{
+		_localToWorldMatrices[index] = _localToParentMatrices[index];
+
+		_worldPositions[index] = localPos;
+		_worldRotations[index] = localRot;
+		_worldScales[index] = localScale;
+	}
+
+	_flags[index] = (_flags[index] & ~DIRTY_WORLD) | DIRTY_WORLD_TO_LOCAL;
+}
+
+uint32_t c3d::TransformStore::updateRange(Range range)
+{
+	// Local matrices of consecutive nodes are composed in a single batch before world data is propagated
+	uint32_t localBegin = range.begin;
+	for (uint32_t i = range.begin; i <= range.end; i++)
+	{
+		if (i < range.end && (_flags[i] & DIRTY_LOCAL))
+			continue;
+
+		if (i > localBegin)
+		{
+			updateLocalRange({localBegin, i});
+		}
+		localBegin = i + 1;
+	}
+
+	uint32_t updatedCount = 0;
+	for (uint32_t i = range.begin; i < range.end; i++)
+	{
+		if (_flags[i] & DIRTY_WORLD)
+		{
+			recalculateWorld(i);
+			updatedCount++;
+		}
+	}
+	return updatedCount;
+}
+
+uint32_t c3d::TransformStore::updateParallel(BS::light_thread_pool& threadPool)
+{
+	if (!_chunksValid)
+	{
+		uint32_t chunkCount = threadPool.get_thread_count() * CHUNKS_PER_THREAD;
+		buildChunks(std::max<uint32_t>(_handles.size() / chunkCount, MIN_CHUNK_SIZE));
+	}
+
+	uint32_t updatedCount = 0;
+	for (uint32_t index : _sequentialNodes)
+	{
+		if (_flags[index] & DIRTY_WORLD)
+		{
+			recalculateWorld(index);
+			updatedCount++;
+		}
+	}
+
+	// Only the dirty parts of each chunk are visited, both lists are sorted by position
+	std::vector<Range> dirtyParts;
+	std::vector<Range> chunkDirtyParts;
+	auto dirtyRange = _dirtyRanges.begin();
+	for (const Range& chunk : _chunks)
+	{
+		while (dirtyRange != _dirtyRanges.end() && dirtyRange->end <= chunk.begin)
+		{
+			dirtyRange++;
+		}
+
+		uint32_t firstPart = static_cast<uint32_t>(dirtyParts.size());
+		for (auto it = dirtyRange; it != _dirtyRanges.end() && it->begin < chunk.end; it++)
+		{
+			dirtyParts.push_back({std::max(it->begin, chunk.begin), std::min(it->end, chunk.end)});
+		}
+
+		if (dirtyParts.size() > firstPart)
+		{
+			chunkDirtyParts.push_back({firstPart, static_cast<uint32_t>(dirtyParts.size())});
+		}
+	}
+
+	// Chunks are made of whole subtrees whose ancestors are all sequential nodes, so they never read each other's data.
+	// The pool is shared with unrelated tasks, only the tasks submitted here are waited for.
+	std::atomic_uint32_t chunkUpdatedCount = 0;
+	threadPool.submit_sequence(
+		0, chunkDirtyParts.size(),
+		[&](size_t chunkIndex)
+		{
+			for (uint32_t part = chunkDirtyParts[chunkIndex].begin; part < chunkDirtyParts[chunkIndex].end; part++)
+			{
+				chunkUpdatedCount += updateRange(dirtyParts[part]);
+			}
+		}
+	).wait();
+
+	return updatedCount + chunkUpdatedCount;
+}
+
+void c3d::TransformStore::buildChunks(uint32_t chunkSize)
+{
+	_sequentialNodes.clear();
+	_chunks.clear();
+
+	// Walk the hierarchy in depth-first order, taking small subtrees as a whole and descending into large ones
+	uint32_t i = 0;
+	while (i < _handles.size())
+	{
+		uint32_t subtreeSize = _subtreeSizes[i];
+		if (subtreeSize > chunkSize)
+		{
+			_sequentialNodes.push_back(i);
+			i++;
+			continue;
+		}
+
+		// Adjacent subtrees are merged into a single chunk as long as it stays under the target size
+		if (!_chunks.empty() && _chunks.back().end == i && i + subtreeSize - _chunks.back().begin <= chunkSize)
+		{
+			_chunks.back().end = i + subtreeSize;
+		}
+		else
+		{
+			_chunks.push_back({i, i + subtreeSize});
+		}
+
+		i += subtreeSize;
+	}
+
+	_chunksValid = true;
+}
+
+uint32_t c3d::TransformStore::moveSubtreeEndToBack(uint32_t index)
+{
+	Transform* handle = _handles[index];
+
+	// The closest ancestor whose subtree already ends at the back of the array can grow in place, so the subtree of its child
+	// on the path to the node is moved after it. This repeats one level deeper until the node's own subtree is the last one.
+	while (true)
+	{
+		uint32_t size = _handles.size();
+
+		uint32_t child = NO_PARENT;
+		uint32_t ancestor = index;
+		while (ancestor != NO_PARENT && ancestor + _subtreeSizes[ancestor] != size)
+		{
+			child = ancestor;
+			ancestor = _parents[ancestor];
+		}
+
+		if (child == NO_PARENT)
+			return index;
+
+		uint32_t subtreeSize = _subtreeSizes[moveSubtreeToBack(child)];
+		for (; ancestor != NO_PARENT; ancestor = _parents[ancestor])
+		{
+			_subtreeSizes[ancestor] += subtreeSize;
+		}
+
+		index = handle->_index;
+	}
+}
+
+uint32_t c3d::TransformStore::moveSubtreeToBack(uint32_t index)
+{
+	uint32_t subtreeSize = _subtreeSizes[index];
+
+	// Holes are not copied, positions inside the subtree shift back by the number of holes before them
+	std::vector<uint32_t> newOffsets(subtreeSize + 1);
+	uint32_t liveCount = 0;
+	for (uint32_t i = 0; i < subtreeSize; i++)
+	{
+		newOffsets[i] = liveCount;
+		if (!(_flags[index + i] & DEAD))
+		{
+			liveCount++;
+		}
+	}
+	newOffsets[subtreeSize] = liveCount;
+
+	uint32_t newIndex = _handles.size();
+	resize(newIndex + liveCount);
+
+	// Pending updates are tracked by position, the dirty parts of the subtree are registered again at their new place
+	uint32_t dirtyBegin = NO_PARENT;
+	for (uint32_t i = 0; i < subtreeSize; i++)
+	{
+		uint32_t from = index + i;
+		if (_flags[from] & DEAD)
+			continue;
+
+		uint32_t to = newIndex + newOffsets[i];
+
+		_handles[to] = _handles[from];
+		// Parents inside the subtree move along with it, the parent of its root is left for the caller to set
+		_parents[to] = i > 0 ? newIndex + newOffsets[_parents[from] - index] : _parents[from];
+		_subtreeSizes[to] = newOffsets[i + _subtreeSizes[from]] - newOffsets[i];
+		_flags[to] = _flags[from];
+		_notificationSlots[to] = _notificationSlots[from];
+
+		_localPositions[to] = _localPositions[from];
+		_localRotations[to] = _localRotations[from];
+		_localScales[to] = _localScales[from];
+
+		_worldPositions[to] = _worldPositions[from];
+		_worldRotations[to] = _worldRotations[from];
+		_worldScales[to] = _worldScales[from];
+
+		_localToParentMatrices[to] = _localToParentMatrices[from];
+		_parentToLocalMatrices[to] = _parentToLocalMatrices[from];
+		_localToWorldMatrices[to] = _localToWorldMatrices[from];
+		_worldToLocalMatrices[to] = _worldToLocalMatrices[from];
+
+		_handles[to]->_index = to;
+
+		// Left behind slots stay in the ranges of the old ancestors as holes
+		_handles[from] = nullptr;
+		_subtreeSizes[from] = 1;
+		_flags[from] = DEAD;
+
+		bool dirty = _flags[to] & DIRTY_WORLD;
+		if (dirty && dirtyBegin == NO_PARENT)
+		{
+			dirtyBegin = to;
+		}
+		else if (!dirty && dirtyBegin != NO_PARENT)
+		{
+			_dirtyRanges.push_back({dirtyBegin, to});
+			dirtyBegin = NO_PARENT;
+		}
+	}
+
+	if (dirtyBegin != NO_PARENT)
+	{
+		_dirtyRanges.push_back({dirtyBegin, newIndex + liveCount});
+	}
+
+	_holeCount += liveCount;
+	_chunksValid = false;
+
+	return newIndex;
+}
+
+void c3d::TransformStore::compact()
+{
+	std::vector<uint32_t> order;
+	order.reserve(_handles.size());
+
+	std::vector<const Transform*> stack;
+	for (uint32_t i = 0; i < _handles.size(); i++)
+	{
+		if (!(_flags[i] & DEAD) && _parents[i] == NO_PARENT)
+		{
+			stack.push_back(_handles[i]);
+		}
+	}
+
+	while (!stack.empty())
+	{
+		const Transform* handle = stack.back();
+		stack.pop_back();
+
+		order.push_back(handle->_index);
+
+		// Push in reverse so that children keep their order once popped
+		for (auto it = handle->_children.rbegin(); it != handle->_children.rend(); it++)
+		{
+			stack.push_back(*it);
+		}
+	}
+
+	std::vector<uint32_t> newIndices(_handles.size(), NO_PARENT);
+	for (uint32_t i = 0; i < order.size(); i++)
+	{
+		newIndices[order[i]] = i;
+	}
+
+	auto permute = [&order]<typename T>(std::vector<T>& vector)
+	{
+		std::vector<T> result;
+		result.reserve(order.size());
+		for (uint32_t oldIndex : order)
+		{
+			result.push_back(vector[oldIndex]);
+		}
+		vector = std::move(result);
+	};
+
+	permute(_handles);
+	permute(_parents);
+	permute(_flags);
+	permute(_notificationSlots);
+	permute(_localPositions);
+	permute(_localRotations);
+	permute(_localScales);
+	permute(_worldPositions);
+	permute(_worldRotations);
+	permute(_worldScales);
+	permute(_localToParentMatrices);
+	permute(_parentToLocalMatrices);
+	permute(_localToWorldMatrices);
+	permute(_worldToLocalMatrices);
+
+	_subtreeSizes.assign(order.size(), 1);
+
+	for (uint32_t i = 0; i < order.size(); i++)
+	{
+		_handles[i]->_index = i;
+
+		if (_parents[i] != NO_PARENT)
+		{
+			_parents[i] = newIndices[_parents[i]];
+		}
+	}
+
+	// Children come after their parent, so accumulating backwards gives complete subtree sizes
+	for (uint32_t i = order.size(); i-- > 0;)
+	{
+		if (_parents[i] != NO_PARENT)
+		{
+			_subtreeSizes[_parents[i]] += _subtreeSizes[i];
+		}
+	}
+
+	// Positions changed, pending updates are registered again as runs of dirty nodes
+	_dirtyRanges.clear();
+	uint32_t dirtyBegin = NO_PARENT;
+	for (uint32_t i = 0; i <= order.size(); i++)
+	{
+		bool dirty = i < order.size() && (_flags[i] & DIRTY_WORLD);
+		if (dirty && dirtyBegin == NO_PARENT)
+		{
+			dirtyBegin = i;
+		}
+		else if (!dirty && dirtyBegin != NO_PARENT)
+		{
+			_dirtyRanges.push_back({dirtyBegin, i});
+			dirtyBegin = NO_PARENT;
+		}
+	}
+
+	_holeCount = 0;
+	_chunksValid = false;
+}
+
+void c3d::TransformStore::resize(size_t size)
+{
+	_handles.resize(size);
+	_parents.resize(size);
+	_subtreeSizes.resize(size);
+	_flags.resize(size);
+	_notificationSlots.resize(size);
+
+	_localPositions.resize(size);
+	_localRotations.resize(size);
+	_localScales.resize(size);
+
+	_worldPositions.resize(size);
+	_worldRotations.resize(size);
+	_worldScales.resize(size);
+
+	_localToParentMatrices.resize(size);
+	_parentToLocalMatrices.resize(size);
+	_localToWorldMatrices.resize(size);
+	_worldToLocalMatrices.resize(size);
+}
\ No newline at end of file
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <BS_thread_pool.hpp>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <vector>
+
+namespace c3d
+{
+class Transform;
+
+// Structure-of-arrays storage for all transforms of a scene.
+// Nodes are kept in depth-first order so that every parent precedes its children and every subtree is a contiguous range.
+// Structural changes move the affected subtree to the back of the arrays, the slots left behind are holes reclaimed by a later compaction.
+// Setters only flag nodes as dirty, world data is then recomputed in a single linear pass over the dirty ranges by update().
+class TransformStore
+{
+public:
+	static constexpr uint32_t NO_PARENT = UINT32_MAX;
+
+	struct Range
+	{
+		uint32_t begin;
+		uint32_t end;
+	};
+
+	TransformStore() = default;
+	TransformStore(const TransformStore& other) = delete;
+	TransformStore& operator=(const TransformStore& other) = delete;
+
+	uint32_t create(Transform* handle, uint32_t parent);
+	void destroy(uint32_t index);
+	void reserve(size_t count);
+
+	void setParent(uint32_t index, uint32_t parent);
+
+	void setLocalPosition(uint32_t index, glm::vec3 position);
+	void setLocalRotation(uint32_t index, glm::quat rotation);
+	void setLocalScale(uint32_t index, glm::vec3 scale);
+
+	glm::vec3 getLocalPosition(uint32_t index) const;
+	glm::quat getLocalRotation(uint32_t index) const;
+	glm::vec3 getLocalScale(uint32_t index) const;
+
+	glm::vec3 getWorldPosition(uint32_t index);
+	glm::quat getWorldRotation(uint32_t index);
+	glm::vec3 getWorldScale(uint32_t index);
+
+	glm::mat4 getLocalToParentMatrix(uint32_t index);
+	glm::mat4 getParentToLocalMatrix(uint32_t index);
+	glm::mat4 getLocalToWorldMatrix(uint32_t index);
+	glm::mat4 getWorldToLocalMatrix(uint32_t index);
+
+	// Compacts the store once holes make up half of it and recomputes the world data of every dirty node.
+	// Large updates are split into independent subtree chunks processed on the thread pool.
+	void update(BS::light_thread_pool& threadPool);
+
+	// Nodes whose world data changed since the previous update, either recomputed by the last update or on demand before it
+	const std::vector<Range>& getLastUpdatedRanges() const;
+	// Returns nullptr for destroyed nodes
+	Transform* getHandle(uint32_t index) const;
+
+	// While notifications are deferred, a transform that changes is queued once and its changed signal is emitted by flushNotifications()
+	// instead of on every setter call. Turning deferral off delivers the pending notifications.
+	void setNotificationsDeferred(bool deferred);
+	bool areNotificationsDeferred() const;
+	// Counts a change of the node and queues its notification if they are deferred, returns false if it must be delivered immediately
+	bool deferNotification(uint32_t index);
+	void flushNotifications();
+
+	uint32_t getSize() const;
+	uint32_t getLastUpdatedCount() const;
+	double getLastUpdateDuration() const;
+
+	// Changes made before the last flush that delivered anything, and how many notifications they were coalesced into
+	uint32_t getLastNotifiedChangeCount() const;
+	uint32_t getLastDeliveredNotificationCount() const;
+	double getLastNotificationDuration() const;
+
+private:
+	// Below this many dirty nodes, dispatching to the thread pool costs more than it saves
+	static constexpr uint32_t PARALLEL_UPDATE_THRESHOLD = 4096;
+	// More chunks than threads lets idle threads pick up work left by slower ones
+	static constexpr uint32_t CHUNKS_PER_THREAD = 4;
+	static constexpr uint32_t MIN_CHUNK_SIZE = 512;
+
+	enum Flags : uint8_t
+	{
+		DIRTY_LOCAL = 1 << 0,
+		DIRTY_WORLD = 1 << 1,
+		DIRTY_PARENT_TO_LOCAL = 1 << 2,
+		DIRTY_WORLD_TO_LOCAL = 1 << 3,
+		DEAD = 1 << 4,
+		NOTIFICATION_PENDING = 1 << 5
+	};
+
+	std::vector<Transform*> _handles;
+	std::vector<uint32_t> _parents;
+	std::vector<uint32_t> _subtreeSizes;
+	std::vector<uint8_t> _flags;
+	// Position in _pendingNotifications of nodes flagged NOTIFICATION_PENDING
+	std::vector<uint32_t> _notificationSlots;
+
+	std::vector<glm::vec3> _localPositions;
+	std::vector<glm::quat> _localRotations;
+	std::vector<glm::vec3> _localScales;
+
+	std::vector<glm::vec3> _worldPositions;
+	std::vector<glm::quat> _worldRotations;
+	std::vector<glm::vec3> _worldScales;
+
+	std::vector<glm::mat4> _localToParentMatrices;
+	std::vector<glm::mat4> _parentToLocalMatrices;
+	std::vector<glm::mat4> _localToWorldMatrices;
+	std::vector<glm::mat4> _worldToLocalMatrices;
+
+	// Slots flagged DEAD, either destroyed nodes or left behind by a moved subtree
+	uint32_t _holeCount = 0;
+	std::vector<Range> _dirtyRanges;
+	std::vector<Range> _lastUpdatedRanges;
+
+	// Partition of the hierarchy used by parallel updates, rebuilt after any structural change.
+	// Sequential nodes are the roots of subtrees too large for a single chunk, they are updated before the chunks.
+	bool _chunksValid = false;
+	std::vector<uint32_t> _sequentialNodes;
+	std::vector<Range> _chunks;
+
+	uint32_t _lastUpdatedCount = 0;
+	double _lastUpdateDuration = 0;
+
+	bool _notificationsDeferred = true;
+	// Transforms flagged NOTIFICATION_PENDING in queue order, destroyed ones are replaced by nullptr
+	std::vector<Transform*> _pendingNotifications;
+	uint32_t _changeCount = 0;
+	uint32_t _immediateNotificationCount = 0;
+
+	uint32_t _lastNotifiedChangeCount = 0;
+	uint32_t _lastDeliveredNotificationCount = 0;
+	double _lastNotificationDuration = 0;
+
+	void markLocalDirty(uint32_t index);
+	void markWorldDirty(uint32_t index);
+
+	void ensureWorldUpToDate(uint32_t index);
+	void ensureLocalUpToDate(uint32_t index);
+	// Range must only contain nodes flagged DIRTY_LOCAL
+	void updateLocalRange(Range range);
+	void recalculateWorld(uint32_t index);
+
+	uint32_t updateRange(Range range);
+	uint32_t updateParallel(BS::light_thread_pool& threadPool);
+	void buildChunks(uint32_t chunkSize);
+
+	// Moves nodes so that the subtree of the node ends at the back of the arrays and can be appended to, returns the node's new index
+	uint32_t moveSubtreeEndToBack(uint32_t index);
+	// Copies the live nodes of the subtree to the back of the arrays and leaves holes in its place, returns the new index of its root
+	uint32_t moveSubtreeToBack(uint32_t index);
+	void compact();
+	void resize(size_t size);
+};
+}
\ No newline at end of file
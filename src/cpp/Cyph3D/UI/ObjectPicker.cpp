@@ -1,14 +1,17 @@
 #include "ObjectPicker.h"
 
+#include <Cyph3D/Asset/AssetManager.h>
 #include <Cyph3D/Asset/RuntimeAsset/MeshAsset.h>
 #include <Cyph3D/Engine.h>
 #include <Cyph3D/Entity/Component/ModelRenderer.h>
+#include <Cyph3D/Helper/AffineMathHelper.h>
 #include <Cyph3D/Helper/FileHelper.h>
 #include <Cyph3D/Rendering/RenderRegistry.h>
 #include <Cyph3D/Rendering/VertexData.h>
 #include <Cyph3D/Scene/Camera.h>
-#include <Cyph3D/Scene/Transform.h>
+#include <Cyph3D/UI/Window/UIMisc.h>
 #include <Cyph3D/VKObject/Buffer/VKBuffer.h>
+#include <Cyph3D/VKObject/Buffer/VKResizableBuffer.h>
 #include <Cyph3D/VKObject/CommandBuffer/VKCommandBuffer.h>
 #include <Cyph3D/VKObject/DescriptorSet/VKDescriptorSetLayout.h>
 #include <Cyph3D/VKObject/DescriptorSet/VKDescriptorSetLayoutInfo.h>
@@ -18,12 +21,15 @@
 #include <Cyph3D/VKObject/Pipeline/VKPipelineLayout.h>
 #include <Cyph3D/VKObject/Pipeline/VKPipelineLayoutInfo.h>
 
+#include <limits>
+#include <numeric>
+
 c3d::ObjectPicker::ObjectPicker()
 {
 	createDescriptorSetLayout();
 	createPipelineLayout();
 	createPipeline();
-	createBuffer();
+	createBuffers();
 }
 
 c3d::ObjectPicker::~ObjectPicker() = default;
@@ -33,12 +39,99 @@ c3d::Entity* c3d::ObjectPicker::getPickedEntity(const Camera& camera, const Rend
 	if (viewportSize.x * viewportSize.y == 0)
 		return nullptr;
 
+	if (UIMisc::isCPUObjectPickingEnabled())
+	{
+		if (std::optional<Entity*> entity = raycastPickedEntity(camera, renderRegistry, viewportSize, clickPos))
+		{
+			return *entity;
+		}
+	}
+
+	return renderPickedEntity(camera, renderRegistry, viewportSize, clickPos);
+}
+
+std::optional<c3d::Entity*> c3d::ObjectPicker::raycastPickedEntity(const Camera& camera, const RenderRegistry& renderRegistry, const glm::uvec2& viewportSize, const glm::uvec2& clickPos)
+{
+	// Ray through the center of the clicked pixel, reaching the far plane at distance 1
+	glm::vec2 clickPosNdc = (glm::vec2(clickPos) + 0.5f) / glm::vec2(viewportSize) * 2.0f - 1.0f;
+	glm::vec4 farPoint = glm::inverse(camera.getProjection() * camera.getView()) * glm::vec4(clickPosNdc, 1.0f, 1.0f);
+	glm::vec3 origin = camera.getPosition();
+	glm::vec3 direction = glm::vec3(farPoint) / farPoint.w - origin;
+
+	const RenderProxyList<ModelRenderer::RenderData>& models = renderRegistry.getModels();
+
+	Entity* closestEntity = nullptr;
+	float closestDistance = 1.0f;
+	bool raycastDataMissing = false;
+
+	models.getBVH().queryRay(
+		origin,
+		direction,
+		closestDistance,
+		[&](uint32_t id)
+		{
+			uint32_t index = models.getIndex(id);
+			const MeshAsset* mesh = models.getData()[index].mesh;
+
+			if (!mesh->hasRaycastData())
+			{
+				raycastDataMissing = true;
+				return std::numeric_limits<float>::infinity();
+			}
+
+			const glm::mat4& localToWorld = models.getLocalToWorldMatrices()[index];
+			glm::mat4 worldToLocal = AffineMathHelper::inverse(localToWorld);
+
+			// The direction is not normalized so that distances in local space match the ones in world space
+			glm::vec3 localOrigin = glm::vec3(worldToLocal * glm::vec4(origin, 1.0f));
+			glm::vec3 localDirection = glm::vec3(worldToLocal * glm::vec4(direction, 0.0f));
+
+			// Mirroring transforms flip the winding of the triangles on screen, and therefore which faces the rasterizer culls
+			bool clockwiseFrontFaces = glm::determinant(glm::mat3(localToWorld)) < 0.0f;
+
+			float distance = mesh->raycast(localOrigin, localDirection, closestDistance, clockwiseFrontFaces);
+			if (distance < closestDistance)
+			{
+				closestDistance = distance;
+				closestEntity = models.getOwners()[index];
+			}
+
+			return distance;
+		}
+	);
+
+	if (raycastDataMissing)
+	{
+		return std::nullopt;
+	}
+
+	return closestEntity;
+}
+
+c3d::Entity* c3d::ObjectPicker::renderPickedEntity(const Camera& camera, const RenderRegistry& renderRegistry, const glm::uvec2& viewportSize, const glm::uvec2& clickPos)
+{
 	if (viewportSize != _currentSize)
 	{
 		_currentSize = viewportSize;
 		createImage();
 	}
 
+	glm::mat4 vp = camera.getProjection() * camera.getView();
+
+	const RenderProxyList<ModelRenderer::RenderData>& models = renderRegistry.getModels();
+
+	_models.resize(models.getSize());
+	std::iota(_models.begin(), _models.end(), 0);
+	renderRegistry.sortModelsForInstancing(_models);
+
+	_instanceBuffer->resizeSmart(_models.size());
+	for (int i = 0; i < _models.size(); i++)
+	{
+		InstanceData* instanceDataPtr = _instanceBuffer->getHostPointer() + i;
+		instanceDataPtr->mvp = vp * models.getLocalToWorldMatrices()[_models[i]];
+		instanceDataPtr->objectIndex = _models[i] + 1;
+	}
+
 	Engine::getVKContext().executeImmediate(
 		[&](const std::shared_ptr<VKCommandBuffer>& commandBuffer)
 		{
@@ -81,25 +174,26 @@ c3d::Entity* c3d::ObjectPicker::getPickedEntity(const Camera& camera, const Rend
 			scissor.size = _currentSize;
 			commandBuffer->setScissor(scissor);
 
-			glm::mat4 vp = camera.getProjection() * camera.getView();
-
-			for (int i = 0; i < renderRegistry.getModelRenderRequests().size(); i++)
+			if (!_models.empty())
 			{
-				const ModelRenderer::RenderData& model = renderRegistry.getModelRenderRequests()[i];
+				commandBuffer->pushDescriptor(0, 0, _instanceBuffer->getBuffer(), 0, _models.size());
+			}
 
-				const std::shared_ptr<VKBuffer<PositionVertexData>>& vertexBuffer = model.mesh.getPositionVertexBuffer();
-				const std::shared_ptr<VKBuffer<uint32_t>>& indexBuffer = model.mesh.getIndexBuffer();
+			MeshPool& meshPool = Engine::getAssetManager().getMeshPool();
 
-				commandBuffer->bindVertexBuffer(0, vertexBuffer);
-				commandBuffer->bindIndexBuffer(indexBuffer);
+			renderRegistry.forEachModelInstanceGroup(
+				_models,
+				false,
+				[&](uint32_t first, uint32_t count)
+				{
+					const MeshPool::Allocation& allocation = models.getData()[_models[first]].mesh->getMeshPoolAllocation();
 
-				PushConstantData pushConstantData{};
-				pushConstantData.mvp = vp * model.transform.getLocalToWorldMatrix();
-				pushConstantData.objectIndex = i + 1;
-				commandBuffer->pushConstants(pushConstantData);
+					commandBuffer->bindVertexBuffer(0, meshPool.getPositionVertexBuffer(allocation.block));
+					commandBuffer->bindIndexBuffer(meshPool.getIndexBuffer(allocation.block));
 
-				commandBuffer->drawIndexed(indexBuffer->getInfo().getSize(), 0, 0);
-			}
+					commandBuffer->drawIndexedInstanced(allocation.indexCount, count, allocation.indexOffset, allocation.vertexOffset, first);
+				}
+			);
 
 			commandBuffer->unbindPipeline();
 
@@ -124,7 +218,7 @@ c3d::Entity* c3d::ObjectPicker::getPickedEntity(const Camera& camera, const Rend
 
 	int objectIndex = *_readbackBuffer->getHostPointer();
 
-	return objectIndex > 0 ? &renderRegistry.getModelRenderRequests()[objectIndex - 1].owner : nullptr;
+	return objectIndex > 0 ? renderRegistry.getModels().getOwners()[objectIndex - 1] : nullptr;
 }
 
 void c3d::ObjectPicker::createDescriptorSetLayout()
@@ -139,7 +233,6 @@ void c3d::ObjectPicker::createPipelineLayout()
 {
 	VKPipelineLayoutInfo info;
 	info.addDescriptorSetLayout(_descriptorSetLayout);
-	info.setPushConstantLayout<PushConstantData>();
 
 	_pipelineLayout = VKPipelineLayout::create(Engine::getVKContext(), info);
 }
@@ -165,15 +258,27 @@ void c3d::ObjectPicker::createPipeline()
 	_pipeline = VKGraphicsPipeline::create(Engine::getVKContext(), info);
 }
 
-void c3d::ObjectPicker::createBuffer()
+void c3d::ObjectPicker::createBuffers()
 {
-	VKBufferInfo bufferInfo(1, vk::BufferUsageFlagBits::eTransferDst);
-	bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostVisible);
-	bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostCoherent);
-	bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostCached);
-	bufferInfo.setName("Object picker readback buffer");
+	{
+		VKResizableBufferInfo bufferInfo(vk::BufferUsageFlagBits::eStorageBuffer);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eDeviceLocal);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostVisible);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostCoherent);
+		bufferInfo.setName("Object picker instance buffer");
 
-	_readbackBuffer = VKBuffer<int32_t>::create(Engine::getVKContext(), bufferInfo);
+		_instanceBuffer = VKResizableBuffer<InstanceData>::create(Engine::getVKContext(), bufferInfo);
+	}
+
+	{
+		VKBufferInfo bufferInfo(1, vk::BufferUsageFlagBits::eTransferDst);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostVisible);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostCoherent);
+		bufferInfo.addRequiredMemoryProperty(vk::MemoryPropertyFlagBits::eHostCached);
+		bufferInfo.setName("Object picker readback buffer");
+
+		_readbackBuffer = VKBuffer<int32_t>::create(Engine::getVKContext(), bufferInfo);
+	}
 }
 
 void c3d::ObjectPicker::createImage()
@@ -3,6 +3,8 @@
 #include <glm/glm.hpp>
 #include <imgui.h>
 #include <memory>
+#include <optional>
+#include <vector>
 
 namespace c3d
 {
@@ -16,6 +18,8 @@ class VKGraphicsPipeline;
 class VKImage;
 template<typename T>
 class VKBuffer;
+template<typename T>
+class VKResizableBuffer;
 
 class ObjectPicker
 {
@@ -23,10 +27,11 @@ public:
 	ObjectPicker();
 	~ObjectPicker();
 
+	// Casts a ray against the meshes on the CPU, or renders the scene to an index image when some mesh has no ray cast data
 	Entity* getPickedEntity(const Camera& camera, const RenderRegistry& renderRegistry, const glm::uvec2& viewportSize, const glm::uvec2& clickPos);
 
 private:
-	struct PushConstantData
+	struct InstanceData
 	{
 		glm::mat4 mvp;
 		int32_t objectIndex;
@@ -40,15 +45,23 @@ private:
 
 	std::shared_ptr<VKGraphicsPipeline> _pipeline;
 
+	std::shared_ptr<VKResizableBuffer<InstanceData>> _instanceBuffer;
+
 	std::shared_ptr<VKBuffer<int32_t>> _readbackBuffer;
 
 	std::shared_ptr<VKImage> _objectIndexImage;
 	std::shared_ptr<VKImage> _depthImage;
 
+	std::vector<uint32_t> _models;
+
+	// Returns std::nullopt if the ray reached a mesh without ray cast data
+	static std::optional<Entity*> raycastPickedEntity(const Camera& camera, const RenderRegistry& renderRegistry, const glm::uvec2& viewportSize, const glm::uvec2& clickPos);
+	Entity* renderPickedEntity(const Camera& camera, const RenderRegistry& renderRegistry, const glm::uvec2& viewportSize, const glm::uvec2& clickPos);
+
 	void createDescriptorSetLayout();
 	void createPipelineLayout();
 	void createPipeline();
-	void createBuffer();
+	void createBuffers();
 	void createImage();
 };
 }
\ No newline at end of file
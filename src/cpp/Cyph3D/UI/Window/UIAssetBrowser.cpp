@@ -104,7 +104,7 @@ public:
 					{
 						entryType = EntryType::Skybox;
 					}
-					else if (extension == ".c3dscene")
+					else if (extension == ".c3dscene" || extension == ".c3dscenebin")
 					{
 						entryType = EntryType::Scene;
 					}
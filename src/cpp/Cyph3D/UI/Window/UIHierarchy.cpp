@@ -58,7 +58,10 @@ void c3d::UIHierarchy::show()
 			IInspectable* selectedObject = UIInspector::getSelected();
 			Entity* selectedEntity = dynamic_cast<Entity*>(selectedObject);
 
-			if (ImGui::MenuItem("Delete Entity", nullptr, false, selectedEntity != nullptr))
+			// the scene loader keeps pointers to the entities it created until it is done
+			bool sceneLoading = Engine::getSceneLoader() != nullptr;
+
+			if (ImGui::MenuItem("Delete Entity", nullptr, false, selectedEntity != nullptr && !sceneLoading))
 			{
 				_task = [selectedEntity]()
 				{
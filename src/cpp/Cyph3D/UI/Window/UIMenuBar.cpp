@@ -28,7 +28,7 @@ void c3d::UIMenuBar::show()
 			{
 				std::optional<std::filesystem::path> filePath = FileHelper::fileDialogOpen(
 					{{
-						{"Cyph3D Scene", "c3dscene"},
+						{"Cyph3D Scene", "c3dscene,c3dscenebin"},
 					}},
 					"assets/scenes"
 				);
@@ -51,6 +51,7 @@ void c3d::UIMenuBar::show()
 				std::optional<std::filesystem::path> filePath = FileHelper::fileDialogSave(
 					{{
 						{"Cyph3D Scene", "c3dscene"},
+						{"Cyph3D Binary Scene", "c3dscenebin"},
 					}},
 					"assets/scenes",
 					Engine::getScene().getName()
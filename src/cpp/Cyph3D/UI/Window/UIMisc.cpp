@@ -3,22 +3,34 @@
 #include <Cyph3D/Asset/RuntimeAsset/SkyboxAsset.h>
 #include <Cyph3D/Engine.h>
 #include <Cyph3D/Helper/ImGuiHelper.h>
+#include <Cyph3D/Helper/MathHelper.h>
+#include <Cyph3D/Rendering/RenderRegistry.h>
+#include <Cyph3D/Rendering/SceneRenderer/RasterizationSceneRenderer.h>
 #include <Cyph3D/Scene/Scene.h>
+#include <Cyph3D/Scene/SceneLoader.h>
 #include <Cyph3D/UI/Window/UIViewport.h>
 #include <Cyph3D/VKObject/VKContext.h>
 #include <Cyph3D/Window.h>
 
+#include <chrono>
 #include <glm/gtc/type_ptr.hpp>
 #include <imgui.h>
 
 glm::ivec2 c3d::UIMisc::_resolution = {1920, 1080};
 uint32_t c3d::UIMisc::_renderSampleCount = 1024;
 bool c3d::UIMisc::_simulationEnabled = true;
+bool c3d::UIMisc::_progressiveSceneLoadingEnabled = false;
+bool c3d::UIMisc::_deferredNotificationsEnabled = true;
+bool c3d::UIMisc::_cpuObjectPickingEnabled = true;
 int c3d::UIMisc::_viewportSampleCount = 8;
 std::array<float, 512> c3d::UIMisc::_frametimes{};
 uint32_t c3d::UIMisc::_lastFrametimeIndex = 0;
 float c3d::UIMisc::_overlayFrametime = 0.0f;
 float c3d::UIMisc::_timeUntilOverlayUpdate = 0.0f;
+bool c3d::UIMisc::_bvhQueryMeasured = false;
+uint32_t c3d::UIMisc::_bvhQueryVisibleCount = 0;
+uint32_t c3d::UIMisc::_bvhQueryLeafCount = 0;
+double c3d::UIMisc::_bvhQueryDuration = 0;
 
 void c3d::UIMisc::show()
 {
@@ -26,6 +38,14 @@ void c3d::UIMisc::show()
 	{
 		displayFrametime();
 
+		const TransformStore& transformStore = Engine::getScene().getTransformStore();
+		ImGui::Text("Transform update: %u/%u in %.3f ms", transformStore.getLastUpdatedCount(), transformStore.getSize(), transformStore.getLastUpdateDuration());
+		ImGui::Text("Scene update: %.3f ms", Engine::getScene().getLastUpdateDuration());
+		ImGui::Text("Change notifications: %u for %u changes, %.3f ms deferred", transformStore.getLastDeliveredNotificationCount(), transformStore.getLastNotifiedChangeCount(), transformStore.getLastNotificationDuration());
+
+		displayBVHStatistics();
+		displayCullingStatistics();
+
 		ImGui::Separator();
 
 		float cameraSpeed = UIViewport::getCamera().getSpeed();
@@ -61,6 +81,17 @@ void c3d::UIMisc::show()
 		ImGui::Separator();
 
 		ImGui::Checkbox("Simulate", &_simulationEnabled);
+		ImGui::Checkbox("Deferred change notifications", &_deferredNotificationsEnabled);
+		ImGui::Checkbox("CPU object picking", &_cpuObjectPickingEnabled);
+
+		ImGui::Separator();
+
+		ImGui::Checkbox("Progressive scene loading", &_progressiveSceneLoadingEnabled);
+
+		if (SceneLoader* sceneLoader = Engine::getSceneLoader())
+		{
+			ImGui::Text("Loading %s: %zu entities", sceneLoader->getPath().filename().generic_string().c_str(), sceneLoader->getLoadedEntityCount());
+		}
 
 		if (Engine::getVKContext().isRayTracingSupported())
 		{
@@ -94,11 +125,77 @@ bool c3d::UIMisc::isSimulationEnabled()
 	return _simulationEnabled;
 }
 
+bool c3d::UIMisc::isProgressiveSceneLoadingEnabled()
+{
+	return _progressiveSceneLoadingEnabled;
+}
+
+bool c3d::UIMisc::isDeferredNotificationsEnabled()
+{
+	return _deferredNotificationsEnabled;
+}
+
+bool c3d::UIMisc::isCPUObjectPickingEnabled()
+{
+	return _cpuObjectPickingEnabled;
+}
+
 int c3d::UIMisc::viewportSampleCount()
 {
 	return _viewportSampleCount;
 }
 
+void c3d::UIMisc::displayBVHStatistics()
+{
+	const RenderRegistry& renderRegistry = Engine::getScene().getRenderRegistry();
+	const DynamicBVH& bvh = renderRegistry.getModels().getBVH();
+
+	ImGui::Text("Model BVH: %u leaves, height %u, area ratio %.1f", bvh.getLeafCount(), bvh.getHeight(), bvh.getAreaRatio());
+	ImGui::Text("BVH sync: %u reinserted in %.3f ms", renderRegistry.getLastBVHReinsertionCount(), renderRegistry.getLastTransformSyncDuration());
+
+	// Measures the cost of a typical culling query against the viewport camera, only when asked as it is not free
+	if (ImGui::Button("Measure BVH frustum query"))
+	{
+		const Camera& camera = UIViewport::getCamera();
+		std::array<glm::vec4, 6> frustumPlanes = MathHelper::extractFrustumPlanes(camera.getProjection() * camera.getView());
+
+		auto start = std::chrono::high_resolution_clock::now();
+		uint32_t visibleCount = 0;
+		bvh.queryFrustum(
+			frustumPlanes,
+			[&](uint32_t)
+			{
+				visibleCount++;
+				return true;
+			}
+		);
+		_bvhQueryDuration = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		_bvhQueryVisibleCount = visibleCount;
+		_bvhQueryLeafCount = bvh.getLeafCount();
+		_bvhQueryMeasured = true;
+	}
+
+	if (_bvhQueryMeasured)
+	{
+		ImGui::SameLine();
+		ImGui::Text("%u/%u in %.3f ms", _bvhQueryVisibleCount, _bvhQueryLeafCount, _bvhQueryDuration);
+	}
+}
+
+void c3d::UIMisc::displayCullingStatistics()
+{
+	const RasterizationSceneRenderer* renderer = dynamic_cast<const RasterizationSceneRenderer*>(UIViewport::getSceneRenderer());
+	if (!renderer)
+	{
+		return;
+	}
+
+	const RasterizationSceneRenderer::CullingStatistics& statistics = renderer->getCullingStatistics();
+	ImGui::Text("Camera culling: %u drawn, %u culled", statistics.drawnModelCount, statistics.culledModelCount);
+	ImGui::Text("Shadow culling: %u drawn, %u culled", statistics.shadowDrawnModelCount, statistics.shadowCulledModelCount);
+	ImGui::Text("Shadow maps: %u rendered this frame", statistics.renderedShadowMapCount);
+}
+
 void c3d::UIMisc::displayFrametime()
 {
 	double deltaTime = Engine::getTimer().deltaTime();
@@ -10,12 +10,18 @@ public:
 	static void show();
 
 	static bool isSimulationEnabled();
+	static bool isProgressiveSceneLoadingEnabled();
+	static bool isDeferredNotificationsEnabled();
+	static bool isCPUObjectPickingEnabled();
 	static int viewportSampleCount();
 
 private:
 	static glm::ivec2 _resolution;
 	static uint32_t _renderSampleCount;
 	static bool _simulationEnabled;
+	static bool _progressiveSceneLoadingEnabled;
+	static bool _deferredNotificationsEnabled;
+	static bool _cpuObjectPickingEnabled;
 	static int _viewportSampleCount;
 
 	static std::array<float, 512> _frametimes;
@@ -23,6 +29,14 @@ private:
 	static float _overlayFrametime;
 	static float _timeUntilOverlayUpdate;
 
+	// Result of the last BVH frustum query measured on request
+	static bool _bvhQueryMeasured;
+	static uint32_t _bvhQueryVisibleCount;
+	static uint32_t _bvhQueryLeafCount;
+	static double _bvhQueryDuration;
+
+	static void displayBVHStatistics();
+	static void displayCullingStatistics();
 	static void displayFrametime();
 };
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <Cyph3D/Engine.h>
 #include <Cyph3D/Entity/Entity.h>
 #include <Cyph3D/Helper/FileHelper.h>
+#include <Cyph3D/Rendering/RenderRegistry.h>
 #include <Cyph3D/Rendering/SceneRenderer/PathTracingSceneRenderer.h>
 #include <Cyph3D/Rendering/SceneRenderer/RasterizationSceneRenderer.h>
 #include <Cyph3D/Scene/Scene.h>
@@ -34,7 +35,8 @@ struct c3d::UIViewport::RenderToFileData
 	uint32_t totalSamples = 0;
 	std::unique_ptr<PathTracingSceneRenderer> renderer;
 	Camera camera;
-	RenderRegistry registry;
+	// The scene is captured when the render starts, later edits would desync it from the acceleration structures built on the first batch
+	std::unique_ptr<RenderRegistry> registry;
 	std::filesystem::path outputFile;
 	std::chrono::time_point<std::chrono::high_resolution_clock> startTime;
 	std::chrono::time_point<std::chrono::high_resolution_clock> lastBatchTime;
@@ -44,7 +46,7 @@ struct c3d::UIViewport::RenderToFileData
 
 std::unique_ptr<c3d::SceneRenderer> c3d::UIViewport::_sceneRenderer;
 c3d::UIViewport::RendererType c3d::UIViewport::_sceneRendererType = UIViewport::RendererType::Rasterization;
-uint64_t c3d::UIViewport::_sceneChangeVersion = -1;
+c3d::SceneChangeCursor c3d::UIViewport::_sceneChangeCursor;
 
 glm::uvec2 c3d::UIViewport::_previousViewportSize = {0, 0};
 
@@ -61,8 +63,6 @@ glm::vec2 c3d::UIViewport::_leftClickPressPos;
 ImGuizmo::OPERATION c3d::UIViewport::_gizmoMode = ImGuizmo::TRANSLATE;
 ImGuizmo::MODE c3d::UIViewport::_gizmoSpace = ImGuizmo::LOCAL;
 
-c3d::RenderRegistry c3d::UIViewport::_renderRegistry;
-
 std::unique_ptr<c3d::ObjectPicker> c3d::UIViewport::_objectPicker;
 
 std::unique_ptr<c3d::UIViewport::RenderToFileData> c3d::UIViewport::_renderToFileData;
@@ -163,7 +163,7 @@ void c3d::UIViewport::show()
 				Engine::getVKContext().executeImmediate(
 					[&](const std::shared_ptr<VKCommandBuffer>& commandBuffer)
 					{
-						_renderToFileData->lastRenderedTexture = _renderToFileData->renderer->render(commandBuffer, _renderToFileData->camera, _renderToFileData->registry, false, false);
+						_renderToFileData->lastRenderedTexture = _renderToFileData->renderer->render(commandBuffer, _renderToFileData->camera, *_renderToFileData->registry, SceneChanges(), false);
 					}
 				);
 
@@ -256,16 +256,12 @@ void c3d::UIViewport::show()
 
 			if (!_renderToFileData)
 			{
-				uint64_t currentSceneChangeVersion = Scene::getChangeVersion();
-				bool sceneChanged = currentSceneChangeVersion != _sceneChangeVersion;
+				// Catches transforms edited from the UI after the update phase
+				Engine::getScene().updateTransforms();
 
-				if (sceneChanged)
-				{
-					_renderRegistry.clear();
-					Engine::getScene().onPreRender(_renderRegistry, _camera);
-				}
+				SceneChanges sceneChanges = Engine::getScene().getChangeTracker().collectChanges(_sceneChangeCursor);
 
-				_lastViewportImage = _sceneRenderer->render(Engine::getVKContext().getDefaultCommandBuffer(), _camera, _renderRegistry, sceneChanged, cameraChanged);
+				_lastViewportImage = _sceneRenderer->render(Engine::getVKContext().getDefaultCommandBuffer(), _camera, Engine::getScene().getRenderRegistry(), sceneChanges, cameraChanged);
 
 				Engine::getVKContext().getDefaultCommandBuffer()->imageMemoryBarrier(
 					_lastViewportImage,
@@ -273,8 +269,6 @@ void c3d::UIViewport::show()
 					vk::AccessFlagBits2::eShaderSampledRead,
 					vk::ImageLayout::eReadOnlyOptimal
 				);
-
-				_sceneChangeVersion = currentSceneChangeVersion;
 			}
 
 			ImGui::Image(
@@ -311,10 +305,9 @@ void c3d::UIViewport::show()
 				_leftClickPressedOnViewport = false;
 				if (ImGui::IsItemHovered() && glm::distance(_leftClickPressPos, viewportCursorPos) < 5.0f)
 				{
-					RenderRegistry renderRegistry;
-					Engine::getScene().onPreRender(renderRegistry, _camera);
+					Engine::getScene().updateTransforms();
 
-					Entity* clickedEntity = _objectPicker->getPickedEntity(_camera, renderRegistry, viewportSize, glm::uvec2(viewportCursorPos));
+					Entity* clickedEntity = _objectPicker->getPickedEntity(_camera, Engine::getScene().getRenderRegistry(), viewportSize, glm::uvec2(viewportCursorPos));
 					UIInspector::setSelected(clickedEntity);
 				}
 			}
@@ -496,6 +489,11 @@ bool c3d::UIViewport::isFullscreen()
 	return _fullscreen;
 }
 
+const c3d::SceneRenderer* c3d::UIViewport::getSceneRenderer()
+{
+	return _sceneRenderer.get();
+}
+
 void c3d::UIViewport::renderToFile(glm::uvec2 resolution, uint32_t sampleCount)
 {
 	std::optional<std::filesystem::path> filePath = FileHelper::fileDialogSave(
@@ -520,10 +518,10 @@ void c3d::UIViewport::renderToFile(glm::uvec2 resolution, uint32_t sampleCount)
 	_renderToFileData->renderer = std::make_unique<PathTracingSceneRenderer>(resolution);
 	_renderToFileData->camera = _camera;
 	_renderToFileData->camera.setAspectRatio(static_cast<float>(resolution.x) / static_cast<float>(resolution.y));
+	Engine::getScene().updateTransforms();
+	_renderToFileData->registry = Engine::getScene().getRenderRegistry().createSnapshot();
 	_renderToFileData->outputFile = filePath.value();
 	_renderToFileData->startTime = std::chrono::high_resolution_clock::now();
-
-	Engine::getScene().onPreRender(_renderToFileData->registry, _renderToFileData->camera);
 }
 
 void c3d::UIViewport::init()
@@ -1,7 +1,7 @@
 #pragma once
 
-#include <Cyph3D/Rendering/RenderRegistry.h>
 #include <Cyph3D/Scene/Camera.h>
+#include <Cyph3D/Scene/SceneChangeTracker.h>
 #include <Cyph3D/UI/ObjectPicker.h>
 
 #include <ImGuizmo.h>
@@ -21,6 +21,9 @@ public:
 
 	static bool isFullscreen();
 
+	// nullptr until the viewport has been shown once
+	static const SceneRenderer* getSceneRenderer();
+
 	static void renderToFile(glm::uvec2 resolution, uint32_t sampleCount);
 
 	static void init();
@@ -37,7 +40,7 @@ private:
 
 	static std::unique_ptr<SceneRenderer> _sceneRenderer;
 	static RendererType _sceneRendererType;
-	static uint64_t _sceneChangeVersion;
+	static SceneChangeCursor _sceneChangeCursor;
 
 	static glm::uvec2 _previousViewportSize;
 
@@ -54,8 +57,6 @@ private:
 	static ImGuizmo::OPERATION _gizmoMode;
 	static ImGuizmo::MODE _gizmoSpace;
 
-	static RenderRegistry _renderRegistry;
-
 	static std::unique_ptr<ObjectPicker> _objectPicker;
 
 	static std::unique_ptr<RenderToFileData> _renderToFileData;
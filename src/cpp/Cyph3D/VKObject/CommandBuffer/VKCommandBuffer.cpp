@@ -723,6 +723,11 @@ void c3d::VKCommandBuffer::drawIndexed(uint32_t indexCount, uint32_t indexOffset
 	_commandBuffer.drawIndexed(indexCount, 1, indexOffset, vertexOffset, 0);
 }
 
+void c3d::VKCommandBuffer::drawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t indexOffset, uint32_t vertexOffset, uint32_t instanceOffset)
+{
+	_commandBuffer.drawIndexed(indexCount, instanceCount, indexOffset, vertexOffset, instanceOffset);
+}
+
 void c3d::VKCommandBuffer::drawIndirect(const std::shared_ptr<VKBuffer<vk::DrawIndirectCommand>>& drawCommandsBuffer)
 {
 	if (drawCommandsBuffer)
@@ -743,6 +748,21 @@ void c3d::VKCommandBuffer::drawIndexedIndirect(const std::shared_ptr<VKBuffer<vk
 	}
 }
 
+void c3d::VKCommandBuffer::drawIndexedIndirectCount(const std::shared_ptr<VKBuffer<vk::DrawIndexedIndirectCommand>>& drawCommandsBuffer, size_t drawCommandsOffset, const std::shared_ptr<VKBuffer<uint32_t>>& drawCountBuffer, size_t drawCountOffset, uint32_t maxDrawCount)
+{
+	_commandBuffer.drawIndexedIndirectCount(
+		drawCommandsBuffer->getHandle(),
+		drawCommandsOffset * sizeof(vk::DrawIndexedIndirectCommand),
+		drawCountBuffer->getHandle(),
+		drawCountOffset * sizeof(uint32_t),
+		maxDrawCount,
+		sizeof(vk::DrawIndexedIndirectCommand)
+	);
+
+	_usedObjects.emplace_back(drawCommandsBuffer);
+	_usedObjects.emplace_back(drawCountBuffer);
+}
+
 void c3d::VKCommandBuffer::copyBufferToImage(const std::shared_ptr<VKBufferBase>& srcBuffer, vk::DeviceSize srcByteOffset, const std::shared_ptr<VKImage>& dstImage, uint32_t dstLayer, uint32_t dstLevel)
 {
 	if (srcBuffer->getByteSize() - srcByteOffset < dstImage->getLevelByteSize(dstLevel))
@@ -1024,6 +1044,23 @@ void c3d::VKCommandBuffer::clearColorImage(const std::shared_ptr<VKImage>& image
 	_usedObjects.emplace_back(image);
 }
 
+void c3d::VKCommandBuffer::clearDepthAttachment(glm::uvec2 offset, glm::uvec2 size, float depth)
+{
+	vk::ClearAttachment clearAttachment;
+	clearAttachment.aspectMask = vk::ImageAspectFlagBits::eDepth;
+	clearAttachment.clearValue.depthStencil = vk::ClearDepthStencilValue(depth, 0);
+
+	vk::ClearRect clearRect;
+	clearRect.rect.offset.x = offset.x;
+	clearRect.rect.offset.y = offset.y;
+	clearRect.rect.extent.width = size.x;
+	clearRect.rect.extent.height = size.y;
+	clearRect.baseArrayLayer = 0;
+	clearRect.layerCount = 1;
+
+	_commandBuffer.clearAttachments(clearAttachment, clearRect);
+}
+
 void c3d::VKCommandBuffer::buildBottomLevelAccelerationStructure(const std::shared_ptr<VKAccelerationStructure>& accelerationStructure, const std::shared_ptr<VKBufferBase>& scratchBuffer, const VKBottomLevelAccelerationStructureBuildInfo& buildInfo)
 {
 	if (accelerationStructure->getType() != vk::AccelerationStructureTypeKHR::eBottomLevel)
@@ -83,8 +83,10 @@ public:
 
 	void draw(uint32_t vertexCount, uint32_t vertexOffset);
 	void drawIndexed(uint32_t indexCount, uint32_t indexOffset, uint32_t vertexOffset);
+	void drawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t indexOffset, uint32_t vertexOffset, uint32_t instanceOffset);
 	void drawIndirect(const std::shared_ptr<VKBuffer<vk::DrawIndirectCommand>>& drawCommandsBuffer);
 	void drawIndexedIndirect(const std::shared_ptr<VKBuffer<vk::DrawIndexedIndirectCommand>>& drawCommandsBuffer);
+	void drawIndexedIndirectCount(const std::shared_ptr<VKBuffer<vk::DrawIndexedIndirectCommand>>& drawCommandsBuffer, size_t drawCommandsOffset, const std::shared_ptr<VKBuffer<uint32_t>>& drawCountBuffer, size_t drawCountOffset, uint32_t maxDrawCount);
 
 	void copyBufferToImage(const std::shared_ptr<VKBufferBase>& srcBuffer, vk::DeviceSize srcByteOffset, const std::shared_ptr<VKImage>& dstImage, uint32_t dstLayer, uint32_t dstLevel);
 
@@ -111,6 +113,9 @@ public:
 
 	void clearColorImage(const std::shared_ptr<VKImage>& image, uint32_t layer, uint32_t level, const vk::ClearColorValue& clearColor);
 
+	// Must be recorded in rendering, clears a region of the first layer of the depth attachment
+	void clearDepthAttachment(glm::uvec2 offset, glm::uvec2 size, float depth);
+
 	void buildBottomLevelAccelerationStructure(const std::shared_ptr<VKAccelerationStructure>& accelerationStructure, const std::shared_ptr<VKBufferBase>& scratchBuffer, const VKBottomLevelAccelerationStructureBuildInfo& buildInfo);
 	void buildTopLevelAccelerationStructure(const std::shared_ptr<VKAccelerationStructure>& accelerationStructure, const std::shared_ptr<VKBufferBase>& scratchBuffer, const VKTopLevelAccelerationStructureBuildInfo& buildInfo, const std::shared_ptr<VKResizableBuffer<vk::AccelerationStructureInstanceKHR>>& instancesBuffer);
 
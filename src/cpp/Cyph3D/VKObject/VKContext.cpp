@@ -666,6 +666,9 @@ void c3d::VKContext::createLogicalDevice(const std::vector<const char*>& extensi
 	features.get<vk::PhysicalDeviceFeatures2>().features.geometryShader = true;
 	features.get<vk::PhysicalDeviceFeatures2>().features.shaderStorageImageReadWithoutFormat = true;
 	features.get<vk::PhysicalDeviceFeatures2>().features.shaderStorageImageWriteWithoutFormat = true;
+	features.get<vk::PhysicalDeviceFeatures2>().features.multiDrawIndirect = true;
+	features.get<vk::PhysicalDeviceFeatures2>().features.drawIndirectFirstInstance = true;
+	features.get<vk::PhysicalDeviceFeatures2>().features.shaderClipDistance = true;
 	features.get<vk::PhysicalDeviceVulkan12Features>().shaderUniformBufferArrayNonUniformIndexing = true;
 	features.get<vk::PhysicalDeviceVulkan12Features>().shaderSampledImageArrayNonUniformIndexing = true;
 	features.get<vk::PhysicalDeviceVulkan12Features>().shaderStorageBufferArrayNonUniformIndexing = true;
@@ -677,6 +680,7 @@ void c3d::VKContext::createLogicalDevice(const std::vector<const char*>& extensi
 	features.get<vk::PhysicalDeviceVulkan12Features>().scalarBlockLayout = true;
 	features.get<vk::PhysicalDeviceVulkan12Features>().hostQueryReset = true;
 	features.get<vk::PhysicalDeviceVulkan12Features>().bufferDeviceAddress = true;
+	features.get<vk::PhysicalDeviceVulkan12Features>().drawIndirectCount = true;
 	features.get<vk::PhysicalDeviceVulkan13Features>().dynamicRendering = true;
 	features.get<vk::PhysicalDeviceVulkan13Features>().synchronization2 = true;
 	features.get<vk::PhysicalDeviceVulkan13Features>().maintenance4 = true;
@@ -0,0 +1,446 @@
+#include <Cyph3D/Helper/AffineMathHelper.h>
+#include <Cyph3D/Helper/MathHelper.h>
+#include <Cyph3D/Rendering/DynamicBVH.h>
+#include <Cyph3D/Scene/Transform.h>
+#include <Cyph3D/Scene/TransformStore.h>
+
+#include <BS_thread_pool.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <glm/gtc/matrix_inverse.hpp>
+#include <glm/gtx/component_wise.hpp>
+#include <glm/gtx/quaternion.hpp>
+#include <glm/gtx/transform.hpp>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+// CPU benchmark of the scene data structures, built when CYPH3D_BUILD_BENCHMARK is ON.
+// Each case prints the best time out of RUN_COUNT runs.
+
+namespace
+{
+constexpr int RUN_COUNT = 10;
+
+template<typename F>
+double measure(F&& function)
+{
+	double best = std::numeric_limits<double>::infinity();
+	for (int i = 0; i < RUN_COUNT; i++)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+		function();
+		best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count());
+	}
+	return best;
+}
+
+void report(const char* name, double duration)
+{
+	std::printf("%-56s %10.3f ms\n", name, duration);
+}
+
+// Also prints the largest difference between both results, which doubles as a correctness check and keeps them from being optimized out
+void reportComparison(const char* name, double referenceDuration, double duration, float maxDifference)
+{
+	std::printf("%-56s %10.3f ms -> %10.3f ms (x%.2f), max difference %g\n", name, referenceDuration, duration, referenceDuration / duration, maxDifference);
+}
+
+float maxDifference(const std::vector<glm::mat4>& a, const std::vector<glm::mat4>& b)
+{
+	float difference = 0;
+	for (size_t i = 0; i < a.size(); i++)
+	{
+		for (int column = 0; column < 4; column++)
+		{
+			difference = std::max(difference, glm::compMax(glm::abs(a[i][column] - b[i][column])));
+		}
+	}
+	return difference;
+}
+
+float maxDifference(const std::vector<glm::mat3>& a, const std::vector<glm::mat3>& b)
+{
+	float difference = 0;
+	for (size_t i = 0; i < a.size(); i++)
+	{
+		for (int column = 0; column < 3; column++)
+		{
+			difference = std::max(difference, glm::compMax(glm::abs(a[i][column] - b[i][column])));
+		}
+	}
+	return difference;
+}
+
+float maxDifference(const std::vector<glm::vec3>& a, const std::vector<glm::vec3>& b)
+{
+	float difference = 0;
+	for (size_t i = 0; i < a.size(); i++)
+	{
+		difference = std::max(difference, glm::compMax(glm::abs(a[i] - b[i])));
+	}
+	return difference;
+}
+
+void benchmarkAffineKernels(std::mt19937& random)
+{
+	constexpr size_t COUNT = 1 << 16;
+
+	std::uniform_real_distribution<float> positionDistribution(-100.0f, 100.0f);
+	std::uniform_real_distribution<float> rotationDistribution(-1.0f, 1.0f);
+	std::uniform_real_distribution<float> scaleDistribution(0.1f, 10.0f);
+
+	std::vector<glm::vec3> positions(COUNT);
+	std::vector<glm::quat> rotations(COUNT);
+	std::vector<glm::vec3> scales(COUNT);
+	for (size_t i = 0; i < COUNT; i++)
+	{
+		positions[i] = glm::vec3(positionDistribution(random), positionDistribution(random), positionDistribution(random));
+		rotations[i] = glm::normalize(glm::quat(rotationDistribution(random), rotationDistribution(random), rotationDistribution(random), rotationDistribution(random)));
+		scales[i] = glm::vec3(scaleDistribution(random), scaleDistribution(random), scaleDistribution(random));
+	}
+
+	std::vector<glm::mat4> referenceMatrices(COUNT);
+	std::vector<glm::mat4> matrices(COUNT);
+
+	double referenceDuration = measure(
+		[&]()
+		{
+			for (size_t i = 0; i < COUNT; i++)
+			{
+				referenceMatrices[i] = glm::translate(positions[i]) * glm::toMat4(rotations[i]) * glm::scale(scales[i]);
+			}
+		}
+	);
+	double duration = measure(
+		[&]()
+		{
+			c3d::AffineMathHelper::compose(positions, rotations, scales, matrices);
+		}
+	);
+	reportComparison("Affine: compose", referenceDuration, duration, maxDifference(referenceMatrices, matrices));
+
+	std::vector<glm::mat4> referenceProducts(COUNT);
+	std::vector<glm::mat4> products(COUNT);
+
+	referenceDuration = measure(
+		[&]()
+		{
+			for (size_t i = 0; i < COUNT; i++)
+			{
+				referenceProducts[i] = matrices[i] * matrices[COUNT - 1 - i];
+			}
+		}
+	);
+	duration = measure(
+		[&]()
+		{
+			for (size_t i = 0; i < COUNT; i++)
+			{
+				products[i] = c3d::AffineMathHelper::multiply(matrices[i], matrices[COUNT - 1 - i]);
+			}
+		}
+	);
+	reportComparison("Affine: multiply", referenceDuration, duration, maxDifference(referenceProducts, products));
+
+	std::vector<glm::mat4> referenceInverses(COUNT);
+	std::vector<glm::mat4> inverses(COUNT);
+
+	referenceDuration = measure(
+		[&]()
+		{
+			for (size_t i = 0; i < COUNT; i++)
+			{
+				referenceInverses[i] = glm::affineInverse(matrices[i]);
+			}
+		}
+	);
+	duration = measure(
+		[&]()
+		{
+			for (size_t i = 0; i < COUNT; i++)
+			{
+				inverses[i] = c3d::AffineMathHelper::inverse(matrices[i]);
+			}
+		}
+	);
+	reportComparison("Affine: inverse", referenceDuration, duration, maxDifference(referenceInverses, inverses));
+
+	std::vector<glm::mat3> referenceNormalMatrices(COUNT);
+	std::vector<glm::mat3> normalMatrices(COUNT);
+
+	referenceDuration = measure(
+		[&]()
+		{
+			for (size_t i = 0; i < COUNT; i++)
+			{
+				referenceNormalMatrices[i] = glm::inverseTranspose(glm::mat3(matrices[i]));
+			}
+		}
+	);
+	duration = measure(
+		[&]()
+		{
+			c3d::AffineMathHelper::normalMatrix(matrices, normalMatrices);
+		}
+	);
+	reportComparison("Affine: normal matrix", referenceDuration, duration, maxDifference(referenceNormalMatrices, normalMatrices));
+
+	std::vector<glm::vec3> boundingBoxMins(COUNT, glm::vec3(-1.0f, -2.0f, -0.5f));
+	std::vector<glm::vec3> boundingBoxMaxs(COUNT, glm::vec3(1.0f, 0.5f, 3.0f));
+	std::vector<glm::vec3> referenceMins(COUNT);
+	std::vector<glm::vec3> referenceMaxs(COUNT);
+	std::vector<glm::vec3> resultMins(COUNT);
+	std::vector<glm::vec3> resultMaxs(COUNT);
+
+	// Transforms the 8 corners, which is what the kernel replaces
+	referenceDuration = measure(
+		[&]()
+		{
+			for (size_t i = 0; i < COUNT; i++)
+			{
+				glm::vec3 resultMin(std::numeric_limits<float>::infinity());
+				glm::vec3 resultMax(-std::numeric_limits<float>::infinity());
+				for (int corner = 0; corner < 8; corner++)
+				{
+					glm::vec3 localCorner(
+						corner & 1 ? boundingBoxMaxs[i].x : boundingBoxMins[i].x,
+						corner & 2 ? boundingBoxMaxs[i].y : boundingBoxMins[i].y,
+						corner & 4 ? boundingBoxMaxs[i].z : boundingBoxMins[i].z
+					);
+					glm::vec3 worldCorner = glm::vec3(matrices[i] * glm::vec4(localCorner, 1.0f));
+					resultMin = glm::min(resultMin, worldCorner);
+					resultMax = glm::max(resultMax, worldCorner);
+				}
+				referenceMins[i] = resultMin;
+				referenceMaxs[i] = resultMax;
+			}
+		}
+	);
+	duration = measure(
+		[&]()
+		{
+			c3d::AffineMathHelper::transformBoundingBox(matrices, boundingBoxMins, boundingBoxMaxs, resultMins, resultMaxs);
+		}
+	);
+	reportComparison("Affine: transform bounding box", referenceDuration, duration, std::max(maxDifference(referenceMins, resultMins), maxDifference(referenceMaxs, resultMaxs)));
+}
+
+void benchmarkTransformStore(std::mt19937& random)
+{
+	constexpr int BRANCH_COUNT = 64;
+	constexpr int GROUP_COUNT = 64;
+	constexpr int LEAF_COUNT = 16;
+
+	c3d::TransformStore store;
+	store.setNotificationsDeferred(false);
+
+	std::unique_ptr<c3d::Transform> root = c3d::Transform::createSceneRoot(store);
+	std::vector<std::unique_ptr<c3d::Transform>> transforms;
+	std::vector<c3d::Transform*> branches;
+	std::vector<c3d::Transform*> groups;
+	std::vector<c3d::Transform*> leaves;
+
+	// Built in depth-first order, like the scene loaders do
+	for (int branch = 0; branch < BRANCH_COUNT; branch++)
+	{
+		branches.push_back(transforms.emplace_back(std::make_unique<c3d::Transform>(nullptr, root.get())).get());
+		for (int group = 0; group < GROUP_COUNT; group++)
+		{
+			groups.push_back(transforms.emplace_back(std::make_unique<c3d::Transform>(nullptr, branches.back())).get());
+			for (int leaf = 0; leaf < LEAF_COUNT; leaf++)
+			{
+				leaves.push_back(transforms.emplace_back(std::make_unique<c3d::Transform>(nullptr, groups.back())).get());
+				leaves.back()->setLocalPosition(glm::vec3(leaf, group, branch));
+			}
+		}
+	}
+
+	BS::light_thread_pool singleThreadPool(1);
+	BS::light_thread_pool threadPool;
+	store.update(threadPool);
+
+	std::printf("Transform store: %u transforms, %zu threads\n", store.getSize(), threadPool.get_thread_count());
+
+	float offset = 1;
+	report(
+		"Transform store: update all, 1 thread",
+		measure(
+			[&]()
+			{
+				root->setLocalPosition(glm::vec3(offset++, 0, 0));
+				store.update(singleThreadPool);
+			}
+		)
+	);
+
+	report(
+		"Transform store: update all, thread pool",
+		measure(
+			[&]()
+			{
+				root->setLocalPosition(glm::vec3(offset++, 0, 0));
+				store.update(threadPool);
+			}
+		)
+	);
+
+	std::uniform_int_distribution<size_t> leafDistribution(0, leaves.size() - 1);
+	report(
+		"Transform store: update 1% of leaves",
+		measure(
+			[&]()
+			{
+				for (size_t i = 0; i < leaves.size() / 100; i++)
+				{
+					leaves[leafDistribution(random)]->setLocalPosition(glm::vec3(offset++, 0, 0));
+				}
+				store.update(threadPool);
+			}
+		)
+	);
+
+	std::uniform_int_distribution<size_t> groupDistribution(0, groups.size() - 1);
+	std::uniform_int_distribution<size_t> branchDistribution(0, branches.size() - 1);
+	report(
+		"Transform store: reparent 256 groups and update",
+		measure(
+			[&]()
+			{
+				for (int i = 0; i < 256; i++)
+				{
+					groups[groupDistribution(random)]->setParent(branches[branchDistribution(random)]);
+				}
+				store.update(threadPool);
+			}
+		)
+	);
+
+	std::printf("Transform store: %u slots after reparenting\n", store.getSize());
+
+	// Children must go before their parents
+	while (!transforms.empty())
+	{
+		transforms.pop_back();
+	}
+}
+
+void benchmarkNotifications()
+{
+	constexpr int TRANSFORM_COUNT = 1 << 14;
+
+	c3d::TransformStore store;
+	std::unique_ptr<c3d::Transform> root = c3d::Transform::createSceneRoot(store);
+
+	uint32_t deliveredCount = 0;
+	std::vector<std::unique_ptr<c3d::Transform>> transforms;
+	for (int i = 0; i < TRANSFORM_COUNT; i++)
+	{
+		transforms.emplace_back(std::make_unique<c3d::Transform>(nullptr, root.get()))->getChangedSignal().connect(
+			[&]()
+			{
+				deliveredCount++;
+			}
+		);
+	}
+
+	// Every transform is changed the way an editor gizmo or an animator would, position, rotation and scale one after the other
+	for (bool deferred : {false, true})
+	{
+		store.setNotificationsDeferred(deferred);
+		store.flushNotifications();
+		deliveredCount = 0;
+
+		double duration = measure(
+			[&]()
+			{
+				for (std::unique_ptr<c3d::Transform>& transform : transforms)
+				{
+					transform->setLocalPosition(glm::vec3(1, 2, 3));
+					transform->setLocalRotation(glm::quat(glm::vec3(0.1f, 0.2f, 0.3f)));
+					transform->setLocalScale(glm::vec3(2));
+				}
+				store.flushNotifications();
+			}
+		);
+
+		std::printf("%-56s %10.3f ms, %u notifications per run\n", deferred ? "Notifications: deferred" : "Notifications: immediate", duration, deliveredCount / RUN_COUNT);
+	}
+
+	while (!transforms.empty())
+	{
+		transforms.pop_back();
+	}
+}
+
+void benchmarkBVHQuery(std::mt19937& random)
+{
+	constexpr uint32_t BOX_COUNT = 1 << 16;
+
+	std::uniform_real_distribution<float> positionDistribution(-500.0f, 500.0f);
+	std::uniform_real_distribution<float> sizeDistribution(0.5f, 5.0f);
+
+	std::vector<glm::vec3> boundingBoxMins(BOX_COUNT);
+	std::vector<glm::vec3> boundingBoxMaxs(BOX_COUNT);
+	c3d::DynamicBVH bvh;
+	for (uint32_t i = 0; i < BOX_COUNT; i++)
+	{
+		boundingBoxMins[i] = glm::vec3(positionDistribution(random), positionDistribution(random), positionDistribution(random));
+		boundingBoxMaxs[i] = boundingBoxMins[i] + glm::vec3(sizeDistribution(random), sizeDistribution(random), sizeDistribution(random));
+		bvh.insert(boundingBoxMins[i], boundingBoxMaxs[i], i);
+	}
+
+	glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+	glm::mat4 view = glm::lookAt(glm::vec3(0), glm::vec3(1, 0, 0), glm::vec3(0, 1, 0));
+	std::array<glm::vec4, 6> frustumPlanes = c3d::MathHelper::extractFrustumPlanes(projection * view);
+
+	uint32_t linearVisibleCount = 0;
+	double linearDuration = measure(
+		[&]()
+		{
+			linearVisibleCount = 0;
+			for (uint32_t i = 0; i < BOX_COUNT; i++)
+			{
+				if (c3d::MathHelper::isBoundingBoxInFrustum(frustumPlanes, boundingBoxMins[i], boundingBoxMaxs[i]))
+				{
+					linearVisibleCount++;
+				}
+			}
+		}
+	);
+
+	// Leaves are enlarged, the BVH may return a few more boxes than the linear test
+	uint32_t bvhVisibleCount = 0;
+	double bvhDuration = measure(
+		[&]()
+		{
+			bvhVisibleCount = 0;
+			bvh.queryFrustum(
+				frustumPlanes,
+				[&](uint32_t)
+				{
+					bvhVisibleCount++;
+					return true;
+				}
+			);
+		}
+	);
+
+	std::printf("%-56s %10.3f ms -> %10.3f ms (x%.2f), %u/%u visible, %u returned by the BVH\n", "BVH: frustum query", linearDuration, bvhDuration, linearDuration / bvhDuration, linearVisibleCount, BOX_COUNT, bvhVisibleCount);
+}
+}
+
+int main()
+{
+	std::mt19937 random(42);
+
+	benchmarkAffineKernels(random);
+	benchmarkTransformStore(random);
+	benchmarkNotifications();
+	benchmarkBVHQuery(random);
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+// Layered draws find their object and layer, the view within the group, through gl_InstanceIndex in an array of packed entries, the layer being in the low bits
+const uint LAYER_INSTANCE_LAYER_BITS = 3;
+const uint LAYER_INSTANCE_LAYER_MASK = (1u << LAYER_INSTANCE_LAYER_BITS) - 1;
+
+struct View
+{
+	vec4 frustumPlanes[6];
+	uint requiredFlags;
+};
+
+struct DrawIndexedIndirectCommand
+{
+	uint indexCount;
+	uint instanceCount;
+	uint firstIndex;
+	int vertexOffset;
+	uint firstInstance;
+};
+
+bool isBoundingBoxInFrustum(vec4 frustumPlanes[6], vec3 boundingBoxMin, vec3 boundingBoxMax)
+{
+	for (int i = 0; i < 6; i++)
+	{
+		// Corner of the box the furthest along the plane normal
+		vec3 corner = mix(boundingBoxMin, boundingBoxMax, greaterThanEqual(frustumPlanes[i].xyz, vec3(0)));
+		if (dot(frustumPlanes[i].xyz, corner) + frustumPlanes[i].w < 0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,14 @@
+struct MaterialData
+{
+	int albedoIndex;
+	int normalIndex;
+	int roughnessIndex;
+	int metalnessIndex;
+	int displacementIndex;
+	int emissiveIndex;
+	vec3 albedoValue;
+	float roughnessValue;
+	float metalnessValue;
+	float displacementScale;
+	float emissiveScale;
+};
\ No newline at end of file
@@ -0,0 +1,28 @@
+struct ObjectData
+{
+	mat4x3 localToWorld;
+	vec3 worldBoundingBoxMin;
+	uint indexCount;
+	vec3 worldBoundingBoxMax;
+	uint firstIndex;
+	int vertexOffset;
+	uint meshPoolBlock;
+	uint blockDrawOffset;
+	uint flags;
+	uint materialIndex;
+};
+
+const uint OBJECT_FLAG_CONTRIBUTE_SHADOWS = 1u << 0;
+
+// Cofactor matrix of the linear part, equal to its inverse transpose up to a positive scale that normalization removes
+mat3 getNormalMatrix(mat4x3 localToWorld)
+{
+	mat3 linear = mat3(localToWorld);
+	mat3 cofactor = mat3(
+		cross(linear[1], linear[2]),
+		cross(linear[2], linear[0]),
+		cross(linear[0], linear[1])
+	);
+
+	return dot(linear[0], cofactor[0]) < 0 ? -cofactor : cofactor;
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+// Must match LightingPass
+const uint CLUSTER_TILE_SIZE = 64;
+const uint CLUSTER_DEPTH_SLICES = 24;
+const uint MAX_LIGHTS_PER_CLUSTER = 256;
+
+struct PointLightUniforms
+{
+	vec3  pos;
+	float intensity;
+	vec3  color;
+	bool  castShadows;
+	// Tiles of the point shadow atlas holding the faces of the light's shadow map, in texels
+	uvec2 shadowMapFaceOffsets[6];
+	uint  shadowMapFaceSize;
+	float maxTexelSizeAtUnitDistance;
+	float range;
+};
+
+// Must match ShadowMapPass, each face is rendered with a 90 degree perspective projection looking along its forward direction
+const vec3 POINT_SHADOW_MAP_FACE_FORWARDS[6] = vec3[](
+	vec3(1, 0, 0),
+	vec3(-1, 0, 0),
+	vec3(0, 1, 0),
+	vec3(0, -1, 0),
+	vec3(0, 0, -1),
+	vec3(0, 0, 1)
+);
+const vec3 POINT_SHADOW_MAP_FACE_UPS[6] = vec3[](
+	vec3(0, 1, 0),
+	vec3(0, 1, 0),
+	vec3(0, 0, 1),
+	vec3(0, 0, -1),
+	vec3(0, 1, 0),
+	vec3(0, 1, 0)
+);
+
+// Face of a point light shadow map seeing a direction from the light
+uint getPointShadowMapFace(vec3 direction)
+{
+	vec3 absDirection = abs(direction);
+
+	if (absDirection.x >= absDirection.y && absDirection.x >= absDirection.z)
+		return direction.x > 0 ? 0 : 1;
+
+	if (absDirection.y >= absDirection.z)
+		return direction.y > 0 ? 2 : 3;
+
+	return direction.z < 0 ? 4 : 5;
+}
+
+// Position of a direction from the light in a face of its shadow map, from 0 to 1
+vec2 getPointShadowMapFaceUv(uint face, vec3 direction)
+{
+	vec3 forward = POINT_SHADOW_MAP_FACE_FORWARDS[face];
+	vec3 right = normalize(cross(forward, POINT_SHADOW_MAP_FACE_UPS[face]));
+	vec3 up = cross(right, forward);
+
+	// The y axis is flipped as in the face's projection
+	vec2 ndc = vec2(dot(right, direction), -dot(up, direction)) / dot(forward, direction);
+
+	return ndc * 0.5 + 0.5;
+}
+
+// Brings the light's attenuation smoothly down to 0 at its range, so that it can be left out of the clusters beyond
+float getPointLightRangeFalloff(float distance, float range)
+{
+	if (distance >= range)
+		return 0;
+
+	float ratio = distance / range;
+	float falloff = 1 - ratio * ratio * ratio * ratio;
+	return falloff * falloff;
+}
\ No newline at end of file
@@ -2,50 +2,29 @@
 
 #extension GL_EXT_scalar_block_layout : require
 #extension GL_EXT_nonuniform_qualifier : require
+#extension GL_GOOGLE_include_directive : require
+
+#include "../common/material.glsl"
+#include "../common/point lights.glsl"
 
 /* ------ consts ------ */
 const float PI = 3.14159265359;
 const float TWO_PI = PI*2;
 const float SQRT_2 = 1.41421356237;
+// Must match SceneRenderer
+const int DIRECTIONAL_SHADOW_MAP_CASCADE_COUNT = 4;
 
 /* ------ data structures ------ */
-struct PointLightUniforms
-{
-	vec3  pos;
-	float intensity;
-	vec3  color;
-	bool  castShadows;
-	uint  textureIndex;
-	float maxTexelSizeAtUnitDistance;
-};
-
 struct DirectionalLightUniforms
 {
 	vec3  fragToLightDirection;
 	float intensity;
 	vec3  color;
 	bool  castShadows;
-	mat4  lightViewProjection;
+	mat4  lightViewProjections[DIRECTIONAL_SHADOW_MAP_CASCADE_COUNT];
+	float shadowMapTexelWorldSizes[DIRECTIONAL_SHADOW_MAP_CASCADE_COUNT];
+	float cascadeFarDepths[DIRECTIONAL_SHADOW_MAP_CASCADE_COUNT];
 	uint  textureIndex;
-	float shadowMapTexelWorldSize;
-};
-
-struct ObjectUniforms
-{
-	mat4 normalMatrix;
-	mat4 model;
-	mat4 mvp;
-	int albedoIndex;
-	int normalIndex;
-	int roughnessIndex;
-	int metalnessIndex;
-	int displacementIndex;
-	int emissiveIndex;
-	vec3 albedoValue;
-	float roughnessValue;
-	float metalnessValue;
-	float displacementScale;
-	float emissiveScale;
 };
 
 /* ------ inputs ------ */
@@ -56,6 +35,7 @@ layout(location = 0) in V2F
 	vec3 i_N;
 	vec3 i_T;
 	vec3 i_B;
+	flat uint i_materialIndex;
 };
 
 /* ------ uniforms ------ */
@@ -65,26 +45,43 @@ layout(set = 1, binding = 0, scalar) readonly buffer UselessNameBecauseItIsNever
 {
 	DirectionalLightUniforms u_directionalLightUniforms[];
 };
-layout(set = 1, binding = 1) uniform sampler2DShadow u_directionalLightTextures[];
+layout(set = 1, binding = 1) uniform sampler2DArrayShadow u_directionalLightTextures[];
 
 layout(set = 2, binding = 0, scalar) readonly buffer UselessNameBecauseItIsNeverUsedAnywhere2
 {
 	PointLightUniforms u_pointLightUniforms[];
 };
-layout(set = 2, binding = 1) uniform samplerCubeShadow u_pointLightTextures[];
+layout(set = 2, binding = 1) uniform sampler2DShadow u_pointShadowAtlas;
+
+layout(set = 3, binding = 1, scalar) readonly buffer UselessNameBecauseItIsNeverUsedAnywhere3
+{
+	// Each draw renders a single object, texture indices are therefore uniform within a draw
+	MaterialData u_materials[];
+};
+
+layout(set = 3, binding = 2, scalar) readonly buffer UselessNameBecauseItIsNeverUsedAnywhere4
+{
+	uint u_clusterLightCounts[];
+};
 
-layout(set = 3, binding = 0, scalar) readonly buffer UselessNameBecauseItIsNeverUsedAnywhere3
+layout(set = 3, binding = 3, scalar) readonly buffer UselessNameBecauseItIsNeverUsedAnywhere5
 {
-	ObjectUniforms u_objectUniforms;
+	uint u_clusterLightIndices[];
 };
 
 layout(push_constant, scalar) uniform constants
 {
+	mat4 u_viewProjection;
 	vec3 u_viewPos;
 	uint u_frameIndex;
 	int u_directionalLightCount;
 	int u_pointLightCount;
 	float u_pointLightMaxDistance;
+	uvec2 u_clusterCount;
+	float u_clusterDepthScale;
+	float u_clusterDepthBias;
+	float u_cameraNear;
+	float u_cameraFar;
 };
 
 /* ------ outputs ------ */
@@ -92,9 +89,23 @@ layout(location = 0) out vec4 o_color;
 
 /* ------ code ------ */
 
+float getViewDepth()
+{
+	return u_cameraNear * u_cameraFar / (u_cameraFar - gl_FragCoord.z * (u_cameraFar - u_cameraNear));
+}
+
+uint getClusterIndex()
+{
+	float viewDepth = getViewDepth();
+	uint slice = uint(clamp(log(viewDepth) * u_clusterDepthScale + u_clusterDepthBias, 0, CLUSTER_DEPTH_SLICES - 1));
+	uvec2 tile = min(uvec2(gl_FragCoord.xy) / CLUSTER_TILE_SIZE, u_clusterCount - 1);
+
+	return (slice * u_clusterCount.y + tile.y) * u_clusterCount.x + tile.x;
+}
+
 float getDepth(vec2 texCoords)
 {
-	return u_objectUniforms.displacementIndex >= 0 ? 1.0 - texture(u_textures[u_objectUniforms.displacementIndex], texCoords).r : 0.0;
+	return u_materials[i_materialIndex].displacementIndex >= 0 ? 1.0 - texture(u_textures[u_materials[i_materialIndex].displacementIndex], texCoords).r : 0.0;
 }
 
 vec2 POM(vec2 texCoords, vec3 viewDir)
@@ -113,7 +124,7 @@ vec2 POM(vec2 texCoords, vec3 viewDir)
 	if (viewDir.z <= 0) return texCoords;
 
 	// Offsets applied at each steps
-	vec2  texCoordsStepOffset = -(viewDir.xy / viewDir.z) / linearSamples * u_objectUniforms.displacementScale;
+	vec2  texCoordsStepOffset = -(viewDir.xy / viewDir.z) / linearSamples * u_materials[i_materialIndex].displacementScale;
 	float depthStepOffset     = 1.0 / linearSamples;
 
 	float currentDepth = 0;
@@ -203,16 +214,26 @@ vec3 calculateNormalBias(vec3 fragNormal, vec3 lightDir, float texelSize_WS, flo
 	return fragNormal * worstCastFilterRadius_WS * biasScale;
 }
 
-float isInDirectionalShadow(int lightIndex, vec3 fragPos, vec3 geometryNormal)
+float isInDirectionalShadow(int lightIndex, vec3 fragPos, vec3 fragPosDDX, vec3 fragPosDDY, vec3 geometryNormal)
 {
+	// First cascade reaching the fragment, those beyond the last one are not shadowed
+	float viewDepth = getViewDepth();
+	int cascade = 0;
+	while (cascade < DIRECTIONAL_SHADOW_MAP_CASCADE_COUNT && viewDepth > u_directionalLightUniforms[lightIndex].cascadeFarDepths[cascade])
+	{
+		cascade++;
+	}
+
+	if (cascade == DIRECTIONAL_SHADOW_MAP_CASCADE_COUNT) return 0.0;
+
 	float texelSize = 1.0 / textureSize(u_directionalLightTextures[u_directionalLightUniforms[lightIndex].textureIndex], 0).x;
-	float texelSize_WS = u_directionalLightUniforms[lightIndex].shadowMapTexelWorldSize;
+	float texelSize_WS = u_directionalLightUniforms[lightIndex].shadowMapTexelWorldSizes[cascade];
 
 	float samplingRadius = 3;
 
 	fragPos += calculateNormalBias(geometryNormal, u_directionalLightUniforms[lightIndex].fragToLightDirection, texelSize_WS, 0);
 
-	vec4 shadowMapSpacePos = u_directionalLightUniforms[lightIndex].lightViewProjection * vec4(fragPos, 1);
+	vec4 shadowMapSpacePos = u_directionalLightUniforms[lightIndex].lightViewProjections[cascade] * vec4(fragPos, 1);
 	vec3 projCoords = shadowMapSpacePos.xyz / shadowMapSpacePos.w;
 	projCoords.xy = projCoords.xy * 0.5 + 0.5;
 
@@ -224,8 +245,13 @@ float isInDirectionalShadow(int lightIndex, vec3 fragPos, vec3 geometryNormal)
 	// black magic trickery for per-texel depth bias from https://learn.microsoft.com/en-us/windows/win32/dxtecharts/cascaded-shadow-maps#filtering-shadow-maps
 	// this allows to have a mush smaller normal bias which is no longer dependant on the sampling radius
 
-	vec3 vShadowTexDDX = dFdx(projCoords);
-	vec3 vShadowTexDDY = dFdy(projCoords);
+	// derivatives are taken by the caller in uniform control flow, neighbouring fragments may have picked another cascade or returned early
+	// the cascades are orthographic, the world space derivatives are thus transformed as directions
+	mat4 lightViewProjection = u_directionalLightUniforms[lightIndex].lightViewProjections[cascade];
+	vec3 vShadowTexDDX = (lightViewProjection * vec4(fragPosDDX, 0)).xyz;
+	vec3 vShadowTexDDY = (lightViewProjection * vec4(fragPosDDY, 0)).xyz;
+	vShadowTexDDX.xy *= 0.5;
+	vShadowTexDDY.xy *= 0.5;
 
 	mat2 matScreentoShadow = mat2(vShadowTexDDX.xy, vShadowTexDDY.xy);
 	mat2 matShadowToScreen = inverse(matScreentoShadow);
@@ -248,7 +274,7 @@ float isInDirectionalShadow(int lightIndex, vec3 fragPos, vec3 geometryNormal)
 		vec2 sampleOffset = VogelDiskSample(i, sampleCount, phi) * samplingRadius;
 		vec2 uvOffset = sampleOffset * texelSize;
 		float expectedDepth = fragDepth_SMV + fRightTexelDepthDelta * sampleOffset.x + fUpTexelDepthDelta * sampleOffset.y;
-		shadow += texture(u_directionalLightTextures[u_directionalLightUniforms[lightIndex].textureIndex], vec3(fragUV_SMV + uvOffset, expectedDepth - bias)).r;
+		shadow += texture(u_directionalLightTextures[u_directionalLightUniforms[lightIndex].textureIndex], vec4(fragUV_SMV + uvOffset, cascade, expectedDepth - bias)).r;
 	}
 	shadow /= sampleCount;
 
@@ -274,7 +300,6 @@ float isInPointShadow(int lightIndex, vec3 fragPos, vec3 geometryNormal)
 	float fragDepth_SMV = fragDist;
 
 	vec3 forward = lightToFrag / fragDist;
-	forward.z = -forward.z;
 	vec3 up = abs(dot(forward, vec3(0, 1, 0))) > 0.9 ? vec3(1, 0, 0) : vec3(0, 1, 0);
 	vec3 left = normalize(cross(forward, up));
 	up = cross(left, forward);
@@ -283,6 +308,9 @@ float isInPointShadow(int lightIndex, vec3 fragPos, vec3 geometryNormal)
 	float samplingRadiusNormalized = samplingRadius * u_pointLightUniforms[lightIndex].maxTexelSizeAtUnitDistance;
 	float phi = getRandom().x * TWO_PI;
 
+	float faceSize = u_pointLightUniforms[lightIndex].shadowMapFaceSize;
+	vec2 atlasTexelSize = 1.0 / textureSize(u_pointShadowAtlas, 0);
+
 	float shadow = 0.0;
 
 	const int sampleCount = 8;
@@ -291,7 +319,15 @@ float isInPointShadow(int lightIndex, vec3 fragPos, vec3 geometryNormal)
 		vec2 uvOffset = VogelDiskSample(i, sampleCount, phi) * samplingRadiusNormalized;
 		vec3 posOffset = (left * uvOffset.x) + (up * uvOffset.y);
 		float expectedDepth = fragDepth_SMV;
-		shadow += texture(u_pointLightTextures[u_pointLightUniforms[lightIndex].textureIndex], vec4(forward + posOffset, (expectedDepth - bias) / u_pointLightMaxDistance)).r;
+
+		// Each sample picks its own face, so that the filtering spans face edges
+		vec3 direction = forward + posOffset;
+		uint face = getPointShadowMapFace(direction);
+		// Kept half a texel inside the face for bilinear filtering not to read the neighbouring tiles
+		vec2 faceTexel = clamp(getPointShadowMapFaceUv(face, direction) * faceSize, vec2(0.5), vec2(faceSize - 0.5));
+		vec2 atlasUv = (u_pointLightUniforms[lightIndex].shadowMapFaceOffsets[face] + faceTexel) * atlasTexelSize;
+
+		shadow += texture(u_pointShadowAtlas, vec3(atlasUv, (expectedDepth - bias) / u_pointLightMaxDistance)).r;
 	}
 	shadow /= sampleCount;
 
@@ -389,30 +425,32 @@ void main()
 
 	// ----------------- albedo -----------------
 
-	vec3 albedo = u_objectUniforms.albedoIndex >= 0 ? texture(u_textures[u_objectUniforms.albedoIndex], texCoords).rgb : u_objectUniforms.albedoValue;
+	vec3 albedo = u_materials[i_materialIndex].albedoIndex >= 0 ? texture(u_textures[u_materials[i_materialIndex].albedoIndex], texCoords).rgb : u_materials[i_materialIndex].albedoValue;
 
 	// ----------------- normal -----------------
 
 	vec3 normal = vec3(0);
-	normal.xy = u_objectUniforms.normalIndex >= 0 ? texture(u_textures[u_objectUniforms.normalIndex], texCoords).rg * 2.0 - 1.0 : vec2(0.0, 0.0);
+	normal.xy = u_materials[i_materialIndex].normalIndex >= 0 ? texture(u_textures[u_materials[i_materialIndex].normalIndex], texCoords).rg * 2.0 - 1.0 : vec2(0.0, 0.0);
 	normal.z = sqrt(1 - min(dot(normal.xy, normal.xy), 1));
 	normal = tangentToWorld * normal;
 
 	// ----------------- roughness -----------------
 
-	float roughness = u_objectUniforms.roughnessIndex >= 0 ? texture(u_textures[u_objectUniforms.roughnessIndex], texCoords).r : u_objectUniforms.roughnessValue;
+	float roughness = u_materials[i_materialIndex].roughnessIndex >= 0 ? texture(u_textures[u_materials[i_materialIndex].roughnessIndex], texCoords).r : u_materials[i_materialIndex].roughnessValue;
 
 	// ----------------- metalness -----------------
 
-	float metalness = u_objectUniforms.metalnessIndex >= 0 ? texture(u_textures[u_objectUniforms.metalnessIndex], texCoords).r : u_objectUniforms.metalnessValue;
+	float metalness = u_materials[i_materialIndex].metalnessIndex >= 0 ? texture(u_textures[u_materials[i_materialIndex].metalnessIndex], texCoords).r : u_materials[i_materialIndex].metalnessValue;
 
 	// ----------------- emissive -----------------
 
-	float emissive = (u_objectUniforms.emissiveIndex >= 0 ? texture(u_textures[u_objectUniforms.emissiveIndex], texCoords).r : 1.0) * u_objectUniforms.emissiveScale;
+	float emissive = (u_materials[i_materialIndex].emissiveIndex >= 0 ? texture(u_textures[u_materials[i_materialIndex].emissiveIndex], texCoords).r : 1.0) * u_materials[i_materialIndex].emissiveScale;
 
 	// ----------------- geometry normal -----------------
 
-	vec3 geometryNormal = normalize(cross(dFdy(i_fragPos), dFdx(i_fragPos)));
+	vec3 fragPosDDX = dFdx(i_fragPos);
+	vec3 fragPosDDY = dFdy(i_fragPos);
+	vec3 geometryNormal = normalize(cross(fragPosDDY, fragPosDDX));
 
 	// ----------------- position -----------------
 
@@ -424,7 +462,7 @@ void main()
 	// Directional Light calculation
 	for (int i = 0; i < u_directionalLightCount; ++i)
 	{
-		float shadow = u_directionalLightUniforms[i].castShadows ? isInDirectionalShadow(i, fragPos, geometryNormal) : 0;
+		float shadow = u_directionalLightUniforms[i].castShadows ? isInDirectionalShadow(i, fragPos, fragPosDDX, fragPosDDY, geometryNormal) : 0;
 
 		// calculate light parameters
 		vec3 lightDir    = u_directionalLightUniforms[i].fragToLightDirection;
@@ -433,15 +471,19 @@ void main()
 		finalColor += calculateLighting(radiance, lightDir, viewDir, albedo, normal, roughness, metalness) * (1 - shadow);
 	}
 
-	// Point Light calculation
-	for (int i = 0; i < u_pointLightCount; ++i)
+	// Point Light calculation, only for the lights reaching the fragment's cluster
+	uint clusterIndex = getClusterIndex();
+	uint clusterLightCount = u_pointLightCount > 0 ? u_clusterLightCounts[clusterIndex] : 0;
+	for (uint j = 0; j < clusterLightCount; ++j)
 	{
+		int i = int(u_clusterLightIndices[clusterIndex * MAX_LIGHTS_PER_CLUSTER + j]);
+
 		float shadow = u_pointLightUniforms[i].castShadows ? isInPointShadow(i, fragPos, geometryNormal) : 0;
 
 		// calculate light parameters
 		vec3  lightDir    = normalize(u_pointLightUniforms[i].pos - fragPos);
 		float distance    = length(u_pointLightUniforms[i].pos - fragPos);
-		float attenuation = 1.0 / (1 + distance * distance);
+		float attenuation = 1.0 / (1 + distance * distance) * getPointLightRangeFalloff(distance, u_pointLightUniforms[i].range);
 		vec3  radiance    = u_pointLightUniforms[i].color * u_pointLightUniforms[i].intensity * attenuation;
 
 		finalColor += calculateLighting(radiance, lightDir, viewDir, albedo, normal, roughness, metalness) * (1 - shadow);
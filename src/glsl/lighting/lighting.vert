@@ -1,24 +1,9 @@
 #version 460 core
 
 #extension GL_EXT_scalar_block_layout : require
+#extension GL_GOOGLE_include_directive : require
 
-struct ObjectUniforms
-{
-	mat4 normalMatrix;
-	mat4 model;
-	mat4 mvp;
-	int albedoIndex;
-	int normalIndex;
-	int roughnessIndex;
-	int metalnessIndex;
-	int displacementIndex;
-	int emissiveIndex;
-	vec3 albedoValue;
-	float roughnessValue;
-	float metalnessValue;
-	float displacementScale;
-	float emissiveScale;
-};
+#include "../common/object table.glsl"
 
 layout(location = 0) in vec3 a_position;
 layout(location = 1) in vec2 a_uv;
@@ -27,7 +12,17 @@ layout(location = 3) in vec4 a_tangent;
 
 layout(set = 3, binding = 0, scalar) readonly buffer UselessNameBecauseItIsNeverUsedAnywhere4
 {
-	ObjectUniforms u_objectUniforms;
+	ObjectData u_objects[];
+};
+
+layout(push_constant, scalar) uniform constants
+{
+	mat4 u_viewProjection;
+	vec3 u_viewPos;
+	uint u_frameIndex;
+	int u_directionalLightCount;
+	int u_pointLightCount;
+	float u_pointLightMaxDistance;
 };
 
 layout(location = 0) out V2F
@@ -37,20 +32,26 @@ layout(location = 0) out V2F
 	vec3 o_N;
 	vec3 o_T;
 	vec3 o_B;
+	flat uint o_materialIndex;
 };
 
 void main()
 {
+	mat4x3 localToWorld = u_objects[gl_InstanceIndex].localToWorld;
+	mat3 normalMatrix = getNormalMatrix(localToWorld);
+
 	o_texCoords = a_uv;
-	o_fragPos = (u_objectUniforms.model * vec4(a_position, 1.0)).xyz;
+	o_fragPos = localToWorld * vec4(a_position, 1.0);
 
-	vec3 normal = normalize(mat3(u_objectUniforms.normalMatrix) * a_normal);
-	vec3 tangent = normalize(mat3(u_objectUniforms.normalMatrix) * a_tangent.xyz);
+	vec3 normal = normalize(normalMatrix * a_normal);
+	vec3 tangent = normalize(normalMatrix * a_tangent.xyz);
 	vec3 bitangent = cross(normal, tangent) * a_tangent.w;
 
 	o_N = normal;
 	o_T = tangent;
 	o_B = bitangent;
 
-	gl_Position = u_objectUniforms.mvp * vec4(a_position, 1.0);
+	o_materialIndex = u_objects[gl_InstanceIndex].materialIndex;
+
+	gl_Position = u_viewProjection * vec4(o_fragPos, 1.0);
 }
\ No newline at end of file
@@ -2,15 +2,14 @@
 
 #extension GL_EXT_scalar_block_layout : require
 
-layout(location = 0) out int o_color;
-
-layout(push_constant, scalar) uniform constants
+layout(location = 0) in V2F
 {
-	mat4 u_mvp;
-	int u_objectIndex;
+	flat int i_objectIndex;
 };
 
+layout(location = 0) out int o_color;
+
 void main()
 {
-	o_color = u_objectIndex;
+	o_color = i_objectIndex;
 }
\ No newline at end of file
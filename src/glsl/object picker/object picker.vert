@@ -4,13 +4,24 @@
 
 layout(location = 0) in vec3 a_position;
 
-layout(push_constant, scalar) uniform constants
+struct InstanceData
 {
-	mat4 u_mvp;
-	uint u_objectIndex;
+	mat4 mvp;
+	int objectIndex;
+};
+
+layout(set = 0, binding = 0, scalar) readonly buffer instances
+{
+	InstanceData u_instances[];
+};
+
+layout(location = 0) out V2F
+{
+	flat int o_objectIndex;
 };
 
 void main()
 {
-	gl_Position = u_mvp * vec4(a_position, 1.0);
+	gl_Position = u_instances[gl_InstanceIndex].mvp * vec4(a_position, 1.0);
+	o_objectIndex = u_instances[gl_InstanceIndex].objectIndex;
 }
\ No newline at end of file
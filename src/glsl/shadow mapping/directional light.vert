@@ -1,15 +1,23 @@
 #version 460 core
 
 #extension GL_EXT_scalar_block_layout : require
+#extension GL_GOOGLE_include_directive : require
+
+#include "../common/object table.glsl"
 
 layout(location = 0) in vec3 a_position;
 
+layout(set = 0, binding = 0, scalar) readonly buffer objects
+{
+	ObjectData u_objects[];
+};
+
 layout(push_constant, scalar) uniform constants
 {
-	mat4 u_mvp;
+	mat4 u_viewProjection;
 };
 
 void main()
 {
-	gl_Position = u_mvp * vec4(a_position, 1.0);
+	gl_Position = u_viewProjection * vec4(u_objects[gl_InstanceIndex].localToWorld * vec4(a_position, 1.0), 1.0);
 }
\ No newline at end of file
@@ -9,7 +9,9 @@ layout(location = 0) in V2F
 
 layout(set = 0, binding = 0, scalar) readonly buffer uniforms
 {
-	mat4 u_viewProjection;
+	mat4 u_viewProjections[6];
+	// Scale in xy and offset in zw from the normalized device coordinates of a face to those of its tile in the atlas
+	vec4 u_faceAtlasTransforms[6];
 	vec3 u_lightPos;
 	float u_maxDistance;
 };
@@ -1,29 +1,55 @@
 #version 460 core
 
 #extension GL_EXT_scalar_block_layout : require
+#extension GL_GOOGLE_include_directive : require
 
-layout(location = 0) in vec3 a_position;
+#include "../common/culling.glsl"
+#include "../common/object table.glsl"
 
-layout(push_constant, scalar) uniform constants
-{
-	mat4 u_model;
-};
+layout(location = 0) in vec3 a_position;
 
 layout(set = 0, binding = 0, scalar) readonly buffer uniforms
 {
-	mat4 u_viewProjection;
+	mat4 u_viewProjections[6];
+	// Scale in xy and offset in zw from the normalized device coordinates of a face to those of its tile in the atlas
+	vec4 u_faceAtlasTransforms[6];
 	vec3 u_lightPos;
 	float u_maxDistance;
 };
 
+layout(set = 0, binding = 1, scalar) readonly buffer objects
+{
+	ObjectData u_objects[];
+};
+
+layout(set = 0, binding = 2, scalar) readonly buffer layerInstances
+{
+	uint u_layerInstances[];
+};
+
 layout(location = 0) out V2F
 {
 	vec3 o_fragPos;
 };
 
+out float gl_ClipDistance[4];
+
 void main()
 {
-	vec4 fragPos = u_model * vec4(a_position, 1.0);
-	gl_Position = u_viewProjection * fragPos;
-	o_fragPos = fragPos.xyz;
+	uint layerInstance = u_layerInstances[gl_InstanceIndex];
+	uint objectIndex = layerInstance >> LAYER_INSTANCE_LAYER_BITS;
+	uint face = layerInstance & LAYER_INSTANCE_LAYER_MASK;
+
+	vec3 fragPos = u_objects[objectIndex].localToWorld * vec4(a_position, 1.0);
+	vec4 facePosition = u_viewProjections[face] * vec4(fragPos, 1.0);
+
+	// Clipped to the face's frustum, the atlas being larger than the face
+	gl_ClipDistance[0] = facePosition.w + facePosition.x;
+	gl_ClipDistance[1] = facePosition.w - facePosition.x;
+	gl_ClipDistance[2] = facePosition.w + facePosition.y;
+	gl_ClipDistance[3] = facePosition.w - facePosition.y;
+
+	vec4 faceAtlasTransform = u_faceAtlasTransforms[face];
+	gl_Position = vec4(facePosition.xy * faceAtlasTransform.xy + faceAtlasTransform.zw * facePosition.w, facePosition.zw);
+	o_fragPos = fragPos;
 }
\ No newline at end of file